@@ -0,0 +1,112 @@
+// Bootloader Protocol
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// UART0 at 115200 baud, 8N1 (virtual COM port)
+
+// Flash map:
+//   0x00000-0x03BFF  bootloader
+//   0x03C00-0x03FFF  image descriptor, written after the image verifies
+//   0x04000-0x37FFF  application, linked with its vector table at 0x04000
+//   0x38000-0x3FFFF  history store (Project/history.c), never touched
+//
+// Frame, little endian:
+//   0  sync        0xB007 (bytes 07 B0)
+//   2  type        BOOT_x
+//   3  sequence    host frames count up from the HELLO, replies carry the
+//                  sequence of the frame they answer
+//   4  length      payload bytes, at most BOOT_MAX_PAYLOAD
+//   6  payload
+//   6+length crc   CRC-16/CCITT-FALSE of the bytes before it
+//
+// Host frames and their payloads:
+//   HELLO          none, restarts the sequence, answered with INFO
+//   ERASE          address, length: erases the pages, stop and wait
+//   DATA           address, then up to BOOT_MAX_DATA bytes (whole words) to
+//                  program, pipelined: up to window frames are sent before
+//                  the first is acknowledged
+//   VERIFY         length, crc: CRC-32 of the image from BOOT_APP_BASE,
+//                  the descriptor is written when it matches
+//   RUN            starts the verified image once the ACK is sent
+// Target frames:
+//   INFO           BOOT_INFO
+//   ACK            frames up to sequence are done, status BOOT_OK
+//   NAK            status; a frame was lost or damaged and frames from
+//                  sequence on are discarded until it arrives again, or the
+//                  frame at sequence failed with status
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include <stdint.h>
+
+#define BOOT_VERSION            1
+
+#define BOOT_FLASH_SIZE         0x40000
+#define BOOT_PAGE_SIZE          1024
+#define BOOT_DESCRIPTOR         0x03C00
+#define BOOT_APP_BASE           0x04000
+#define BOOT_APP_SIZE           (0x38000 - BOOT_APP_BASE)
+
+#define BOOT_SYNC               0xB007
+#define BOOT_HEADER_SIZE        6
+#define BOOT_FRAME_OVERHEAD     (BOOT_HEADER_SIZE + 2)
+#define BOOT_MAX_DATA           256
+#define BOOT_MAX_PAYLOAD        (4 + BOOT_MAX_DATA)
+#define BOOT_WINDOW             8                       // DATA frames in flight
+
+#define BOOT_DESCRIPTOR_MAGIC   0x31474D49              // bytes "IMG1"
+
+// Frame types
+#define BOOT_HELLO              0x01
+#define BOOT_ERASE              0x02
+#define BOOT_DATA               0x03
+#define BOOT_VERIFY             0x04
+#define BOOT_RUN                0x05
+#define BOOT_INFO               0x81
+#define BOOT_ACK                0x82
+#define BOOT_NAK                0x83
+
+// Status of an ACK or NAK
+#define BOOT_OK                 0
+#define BOOT_BAD_FRAME          1                       // lost or damaged, resend from sequence
+#define BOOT_BAD_TYPE           2
+#define BOOT_BAD_ADDRESS        3                       // outside the application, or not word aligned
+#define BOOT_FLASH_ERROR        4                       // erase or program failed to verify
+#define BOOT_BAD_IMAGE          5                       // CRC mismatch, or RUN without a verified image
+
+// INFO payload
+typedef struct _BOOT_INFO_PAYLOAD
+{
+    uint16_t version;
+    uint8_t window;
+    uint8_t reserved;
+    uint16_t pageSize;
+    uint16_t maxData;
+    uint32_t appBase;
+    uint32_t appSize;
+    uint32_t imageLength;                               // of the verified image, 0 if none
+    uint32_t imageCrc;
+} BOOT_INFO_PAYLOAD;
+
+// Image descriptor at BOOT_DESCRIPTOR
+typedef struct _BOOT_DESCRIPTOR_RECORD
+{
+    uint32_t magic;
+    uint32_t length;
+    uint32_t crc;                                       // CRC-32 of length bytes from BOOT_APP_BASE
+    uint32_t check;                                     // ~crc
+} BOOT_DESCRIPTOR_RECORD;
+
+#endif
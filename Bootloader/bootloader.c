@@ -0,0 +1,262 @@
+// Serial Bootloader
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// UART0 (see link.c), 16 MHz external crystal oscillator
+
+// Runs from reset. A HELLO frame within BOOT_WAIT_MS keeps it in the
+// bootloader for an update (Host/boot/bootload), otherwise the application
+// is started if its descriptor and CRC-32 check. Without a valid image it
+// waits for an update. The protocol and flash map are in boot.h.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "clock.h"
+#include "tm4c123gh6pm.h"
+#include "wait.h"
+#include "flash.h"
+#include "crc.h"
+#include "link.h"
+#include "run.h"
+
+#define BOOT_WAIT_MS 250
+
+// Flash as data, the host build maps it at FLASH_MEMORY (Host/boot)
+#ifndef FLASH_MEMORY
+#define FLASH_MEMORY 0
+#endif
+#define FLASH_BYTES(address) ((const uint8_t *)(FLASH_MEMORY + (address)))
+#define FLASH_WORD(address)  (*(const volatile uint32_t *)(FLASH_MEMORY + (address)))
+
+#define SRAM_BASE 0x20000000
+#define SRAM_END  0x20008000
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static FRAME frame;
+static uint8_t expected = 0;                    // sequence of the next host frame
+static bool nakSent = false;                    // a NAK for expected is out, frames ahead are ignored
+static bool session = false;                    // a HELLO was received
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool isApplication(uint32_t address, uint32_t length)
+{
+    return address >= BOOT_APP_BASE && length <= BOOT_APP_SIZE
+        && address - BOOT_APP_BASE <= BOOT_APP_SIZE - length;
+}
+
+// Length of the verified image, 0 if there is none
+// The descriptor, CRC-32 and the first two vectors must all check
+static uint32_t getImageLength(void)
+{
+    BOOT_DESCRIPTOR_RECORD d;
+    uint32_t sp, reset;
+
+    memcpy(&d, FLASH_BYTES(BOOT_DESCRIPTOR), sizeof(d));
+    if (d.magic != BOOT_DESCRIPTOR_MAGIC || d.check != ~d.crc || d.length < 8
+        || !isApplication(BOOT_APP_BASE, d.length))
+        return 0;
+    sp = FLASH_WORD(BOOT_APP_BASE);
+    reset = FLASH_WORD(BOOT_APP_BASE + 4);
+    if (sp <= SRAM_BASE || sp > SRAM_END || !(reset & 1) || !isApplication(reset & ~1, 2)
+        || crc32(0, FLASH_BYTES(BOOT_APP_BASE), d.length) != d.crc)
+        return 0;
+    return d.length;
+}
+
+static void sendStatus(uint8_t type, uint8_t sequence, uint8_t status)
+{
+    sendFrame(type, sequence, &status, 1);
+}
+
+static void sendInfo(uint8_t sequence)
+{
+    BOOT_INFO_PAYLOAD info;
+    info.version = BOOT_VERSION;
+    info.window = BOOT_WINDOW;
+    info.reserved = 0;
+    info.pageSize = BOOT_PAGE_SIZE;
+    info.maxData = BOOT_MAX_DATA;
+    info.appBase = BOOT_APP_BASE;
+    info.appSize = BOOT_APP_SIZE;
+    info.imageLength = getImageLength();
+    info.imageCrc = info.imageLength ? FLASH_WORD(BOOT_DESCRIPTOR + 8) : 0;
+    sendFrame(BOOT_INFO, sequence, &info, sizeof(info));
+}
+
+// Erases the pages, the descriptor first so an interrupted update never starts
+static uint8_t erase(uint32_t address, uint32_t length)
+{
+    uint32_t page;
+    if ((address & (BOOT_PAGE_SIZE - 1)) || !isApplication(address, length))
+        return BOOT_BAD_ADDRESS;
+    if (!eraseFlashPage(BOOT_DESCRIPTOR))
+        return BOOT_FLASH_ERROR;
+    for (page = address; page < address + length; page += BOOT_PAGE_SIZE)
+        if (!eraseFlashPage(page))
+            return BOOT_FLASH_ERROR;
+    return BOOT_OK;
+}
+
+// Programs and reads back each word
+static uint8_t program(uint32_t address, const uint8_t data[], uint16_t length)
+{
+    uint32_t word;
+    uint16_t i;
+    if ((address & 3) || (length & 3) || !isApplication(address, length))
+        return BOOT_BAD_ADDRESS;
+    for (i = 0; i < length; i += 4)
+    {
+        word = get32(&data[i]);
+        if (!writeFlashWord(address + i, word) || FLASH_WORD(address + i) != word)
+            return BOOT_FLASH_ERROR;
+    }
+    return BOOT_OK;
+}
+
+// Writes the descriptor when the image matches the host's CRC-32
+static uint8_t verify(uint32_t length, uint32_t crc)
+{
+    uint32_t d[4];
+    uint8_t i;
+    if (length < 8 || !isApplication(BOOT_APP_BASE, length)
+        || crc32(0, FLASH_BYTES(BOOT_APP_BASE), length) != crc)
+        return BOOT_BAD_IMAGE;
+    d[0] = BOOT_DESCRIPTOR_MAGIC;
+    d[1] = length;
+    d[2] = crc;
+    d[3] = ~crc;
+    if (!eraseFlashPage(BOOT_DESCRIPTOR))
+        return BOOT_FLASH_ERROR;
+    for (i = 0; i < 4; i++)
+        if (!writeFlashWord(BOOT_DESCRIPTOR + i * 4, d[i]))
+            return BOOT_FLASH_ERROR;
+    return getImageLength() == length ? BOOT_OK : BOOT_BAD_IMAGE;
+}
+
+// Starts the application with the peripherals the bootloader used back in
+// their reset state
+static void startApplication(void)
+{
+    flushLink();
+    closeLink();
+    SYSCTL_RCGCUART_R &= ~SYSCTL_RCGCUART_R0;
+    NVIC_VTABLE_R = BOOT_APP_BASE;
+    runApplication(FLASH_MEMORY + BOOT_APP_BASE);
+}
+
+// Carries out the frame with sequence expected
+static uint8_t processFrame(void)
+{
+    const uint8_t *p = frame.payload;
+    switch (frame.type)
+    {
+        case BOOT_ERASE:
+            return frame.length == 8 ? erase(get32(p), get32(p + 4)) : BOOT_BAD_ADDRESS;
+        case BOOT_DATA:
+            return frame.length >= 4 ? program(get32(p), p + 4, frame.length - 4) : BOOT_BAD_ADDRESS;
+        case BOOT_VERIFY:
+            return frame.length == 8 ? verify(get32(p), get32(p + 4)) : BOOT_BAD_IMAGE;
+        case BOOT_RUN:
+            return getImageLength() ? BOOT_OK : BOOT_BAD_IMAGE;
+    }
+    return BOOT_BAD_TYPE;
+}
+
+// Acknowledges in order frames, resends the last ACK for a repeated frame,
+// and asks once for a resend from expected when frames ahead of it arrive
+static void handleFrame(void)
+{
+    uint8_t status;
+
+    if (frame.type == BOOT_HELLO)
+    {
+        session = true;
+        expected = frame.sequence + 1;
+        nakSent = false;
+        sendInfo(frame.sequence);
+        return;
+    }
+    if (!session)
+        return;
+    if (frame.sequence != expected)
+    {
+        if ((uint8_t)(expected - frame.sequence) <= BOOT_WINDOW * 2)
+            sendStatus(BOOT_ACK, expected - 1, BOOT_OK);
+        else if (!nakSent)
+        {
+            sendStatus(BOOT_NAK, expected, BOOT_BAD_FRAME);
+            nakSent = true;
+        }
+        return;
+    }
+
+    nakSent = false;
+    expected++;
+    status = processFrame();
+    if (status != BOOT_OK)
+    {
+        sendStatus(BOOT_NAK, frame.sequence, status);
+        return;
+    }
+    sendStatus(BOOT_ACK, frame.sequence, BOOT_OK);
+    if (frame.type == BOOT_RUN)
+        startApplication();
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+    uint16_t waited = 0;
+    bool valid;
+    LINK_STATUS status;
+
+    initSystemClockTo40Mhz();
+    initLink();
+    valid = getImageLength() != 0;
+
+    while (true)
+    {
+        status = receiveFrame(&frame);
+        if (status == LINK_FRAME)
+            handleFrame();
+        else if (status == LINK_DAMAGED && session)
+        {
+            // Also when a NAK is out, the damaged frame may be its resend
+            sendStatus(BOOT_NAK, expected, BOOT_BAD_FRAME);
+            nakSent = true;
+        }
+        else if (status == LINK_NONE && !session)
+        {
+            if (valid && waited == BOOT_WAIT_MS)
+                startApplication();
+            waitMicrosecond(1000);
+            waited += waited < BOOT_WAIT_MS;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+// CRC Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+// Nibble tables, 128 bytes of flash for both instead of 1.5 KiB
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "crc.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// CRC-16/CCITT-FALSE (poly 0x1021) of a nibble
+static const uint16_t crc16Table[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+// CRC-32 (reflected poly 0xEDB88320) of a nibble
+static const uint32_t crc32Table[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint16_t crc16(const uint8_t data[], uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    for (i = 0; i < length; i++)
+    {
+        crc = (crc << 4) ^ crc16Table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ crc16Table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+// Continues crc (0 to start) over data, the same as zlib's crc32()
+uint32_t crc32(uint32_t crc, const uint8_t data[], uint32_t length)
+{
+    uint32_t i;
+    crc = ~crc;
+    for (i = 0; i < length; i++)
+    {
+        crc = (crc >> 4) ^ crc32Table[(crc ^ data[i]) & 0x0F];
+        crc = (crc >> 4) ^ crc32Table[(crc ^ (data[i] >> 4)) & 0x0F];
+    }
+    return ~crc;
+}
@@ -0,0 +1,48 @@
+// Flash Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// 256 KiB internal flash, 1 KiB erase pages
+
+// Instruction fetches from flash stall while a write or erase is in progress
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "flash.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Erases the page containing address, false if the erase failed to verify
+bool eraseFlashPage(uint32_t address)
+{
+    FLASH_FCMISC_R = FLASH_FCMISC_ERMISC | FLASH_FCMISC_AMISC;  // clear stale error flags
+    FLASH_FMA_R = address & ~(FLASH_PAGE_SIZE - 1);
+    FLASH_FMC_R = FLASH_FMC_WRKEY | FLASH_FMC_ERASE;
+    while (FLASH_FMC_R & FLASH_FMC_ERASE);
+    return !(FLASH_FCRIS_R & (FLASH_FCRIS_ERRIS | FLASH_FCRIS_ARIS));
+}
+
+// Programs a word of an erased area, false if the write failed to verify
+bool writeFlashWord(uint32_t address, uint32_t data)
+{
+    FLASH_FCMISC_R = FLASH_FCMISC_PROGMISC | FLASH_FCMISC_AMISC;
+    FLASH_FMA_R = address;
+    FLASH_FMD_R = data;
+    FLASH_FMC_R = FLASH_FMC_WRKEY | FLASH_FMC_WRITE;
+    while (FLASH_FMC_R & FLASH_FMC_WRITE);
+    return !(FLASH_FCRIS_R & (FLASH_FCRIS_PROGRIS | FLASH_FCRIS_ARIS));
+}
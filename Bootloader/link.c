@@ -0,0 +1,207 @@
+// Bootloader Link Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// UART Interface:
+//   U0TX (PA1) and U0RX (PA0) are connected to the 2nd controller
+//   The USB on the 2nd controller enumerates to an ICDI interface and a virtual COM port
+
+// A flash write stalls the CPU for up to 50 us and an erase for up to 15 ms.
+// The 16 byte fifo covers a write at 115200 baud, so DATA frames stream while
+// they are programmed, but the host waits for the ACK of an ERASE.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "crc.h"
+#include "link.h"
+
+// PortA masks
+#define UART_TX_MASK 2
+#define UART_RX_MASK 1
+
+#define RX_BUFFER_SIZE 4096                             // power of 2, holds a window of DATA frames
+#define FRAME_SIZE (BOOT_FRAME_OVERHEAD + BOOT_MAX_PAYLOAD)
+
+#define SYNC_LOW  (BOOT_SYNC & 0xFF)
+#define SYNC_HIGH (BOOT_SYNC >> 8)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Filled by uart0Isr, emptied by receiveFrame()
+static uint8_t rxBuffer[RX_BUFFER_SIZE];
+static volatile uint16_t rxWrite = 0;
+static volatile uint16_t rxRead = 0;
+static volatile bool rxLost = false;                    // overrun, framing or parity error
+
+// Frame being received, and the frame being sent
+static uint8_t rxFrame[FRAME_SIZE];
+static uint16_t rxCount = 0;
+static uint8_t txFrame[FRAME_SIZE];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize UART0, 115200 baud 8N1, with the receive interrupt
+void initLink(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R0;
+    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
+    _delay_cycles(3);
+
+    // Configure UART0 pins
+    GPIO_PORTA_DEN_R |= UART_TX_MASK | UART_RX_MASK;    // enable digital on UART0 pins
+    GPIO_PORTA_AFSEL_R |= UART_TX_MASK | UART_RX_MASK;  // use peripheral to drive PA0, PA1
+    GPIO_PORTA_PCTL_R &= ~(GPIO_PCTL_PA1_M | GPIO_PCTL_PA0_M);
+    GPIO_PORTA_PCTL_R |= GPIO_PCTL_PA1_U0TX | GPIO_PCTL_PA0_U0RX;
+
+    UART0_CTL_R = 0;                                    // turn-off UART0 to allow safe programming
+    UART0_CC_R = UART_CC_CS_SYSCLK;                     // use system clock (40 MHz)
+    UART0_IBRD_R = 21;                                  // r = 40 MHz / (16 x 115.2 kHz) = 21.70
+    UART0_FBRD_R = 45;                                  // round(0.70 x 64)
+    UART0_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;    // 8N1 w/ 16-level FIFO
+    UART0_IFLS_R = UART_IFLS_RX4_8;                     // interrupt at 8 bytes, or after a pause
+    UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC | UART_ICR_OEIC | UART_ICR_FEIC | UART_ICR_PEIC;
+    UART0_IM_R = UART_IM_RXIM | UART_IM_RTIM;
+    UART0_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
+    NVIC_EN0_R = 1 << (INT_UART0 - 16);
+}
+
+// Returns UART0 to its reset state before the application starts
+void closeLink(void)
+{
+    NVIC_DIS0_R = 1 << (INT_UART0 - 16);
+    UART0_IM_R = 0;
+    UART0_CTL_R = 0;
+    UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC | UART_ICR_OEIC | UART_ICR_FEIC | UART_ICR_PEIC;
+}
+
+// Moves the rx fifo into the ring, called with interrupts disabled or from uart0Isr
+static void drainUart0Fifo(void)
+{
+    uint32_t data;
+    uint16_t next;
+    while (!(UART0_FR_R & UART_FR_RXFE))
+    {
+        data = UART0_DR_R;
+        next = (rxWrite + 1) & (RX_BUFFER_SIZE - 1);
+        if ((data & (UART_DR_OE | UART_DR_FE | UART_DR_PE)) || next == rxRead)
+            rxLost = true;
+        else
+        {
+            rxBuffer[rxWrite] = data;
+            rxWrite = next;
+        }
+    }
+}
+
+// UART0 vector
+void uart0Isr(void)
+{
+    UART0_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC | UART_ICR_OEIC | UART_ICR_FEIC | UART_ICR_PEIC;
+    drainUart0Fifo();
+}
+
+// Returns LINK_FRAME with a frame that passed its CRC, LINK_DAMAGED when
+// bytes were lost or a frame failed its CRC, so the sender can be told at once
+LINK_STATUS receiveFrame(FRAME *frame)
+{
+    uint32_t primask;
+    uint16_t length;
+    uint8_t c;
+
+    // The receive timeout interrupt covers the tail of a frame, this covers
+    // the tail while interrupts were masked
+    primask = _disable_interrupts();
+    drainUart0Fifo();
+    _restore_interrupts(primask);
+
+    if (rxLost)
+    {
+        rxLost = false;
+        rxCount = 0;
+        return LINK_DAMAGED;
+    }
+
+    while (rxRead != rxWrite)
+    {
+        c = rxBuffer[rxRead];
+        rxRead = (rxRead + 1) & (RX_BUFFER_SIZE - 1);
+
+        // Hunt for the sync word
+        if (rxCount == 0 && c != SYNC_LOW)
+            continue;
+        if (rxCount == 1 && c != SYNC_HIGH)
+        {
+            rxCount = c == SYNC_LOW;
+            continue;
+        }
+        rxFrame[rxCount++] = c;
+        if (rxCount < BOOT_HEADER_SIZE)
+            continue;
+
+        length = rxFrame[4] | (rxFrame[5] << 8);
+        if (length > BOOT_MAX_PAYLOAD)
+        {
+            rxCount = 0;
+            return LINK_DAMAGED;
+        }
+        if (rxCount == BOOT_FRAME_OVERHEAD + length)
+        {
+            rxCount = 0;
+            if (crc16(rxFrame, BOOT_HEADER_SIZE + length) !=
+                (rxFrame[BOOT_HEADER_SIZE + length] | (rxFrame[BOOT_HEADER_SIZE + length + 1] << 8)))
+                return LINK_DAMAGED;
+            frame->type = rxFrame[2];
+            frame->sequence = rxFrame[3];
+            frame->length = length;
+            memcpy(frame->payload, &rxFrame[BOOT_HEADER_SIZE], length);
+            return LINK_FRAME;
+        }
+    }
+    return LINK_NONE;
+}
+
+// Blocking function that writes a frame once the UART fifo has room
+void sendFrame(uint8_t type, uint8_t sequence, const void *payload, uint16_t length)
+{
+    uint16_t crc, i;
+    txFrame[0] = SYNC_LOW;
+    txFrame[1] = SYNC_HIGH;
+    txFrame[2] = type;
+    txFrame[3] = sequence;
+    txFrame[4] = length;
+    txFrame[5] = length >> 8;
+    memcpy(&txFrame[BOOT_HEADER_SIZE], payload, length);
+    crc = crc16(txFrame, BOOT_HEADER_SIZE + length);
+    txFrame[BOOT_HEADER_SIZE + length] = crc;
+    txFrame[BOOT_HEADER_SIZE + length + 1] = crc >> 8;
+
+    for (i = 0; i < BOOT_FRAME_OVERHEAD + length; i++)
+    {
+        while (UART0_FR_R & UART_FR_TXFF);              // wait if uart0 tx fifo full
+        UART0_DR_R = txFrame[i];
+    }
+}
+
+// Waits until the last byte is on the line
+void flushLink(void)
+{
+    while (UART0_FR_R & UART_FR_BUSY);
+}
@@ -0,0 +1,55 @@
+// Bootloader Link Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// UART Interface:
+//   U0TX (PA1) and U0RX (PA0) are connected to the 2nd controller
+//   The USB on the 2nd controller enumerates to an ICDI interface and a virtual COM port
+
+// Frames of boot.h over UART0. Received bytes are moved into a ring by
+// uart0Isr, so reception continues while main programs the flash.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "boot.h"
+
+typedef struct _FRAME
+{
+    uint8_t type;
+    uint8_t sequence;
+    uint16_t length;
+    uint8_t payload[BOOT_MAX_PAYLOAD];
+} FRAME;
+
+typedef enum _LINK_STATUS
+{
+    LINK_NONE,                                      // no complete frame yet
+    LINK_FRAME,
+    LINK_DAMAGED                                    // bytes were dropped or a frame failed its CRC
+} LINK_STATUS;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initLink(void);
+LINK_STATUS receiveFrame(FRAME *frame);
+void sendFrame(uint8_t type, uint8_t sequence, const void *payload, uint16_t length);
+void flushLink(void);
+void closeLink(void);
+
+#endif
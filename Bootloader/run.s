@@ -0,0 +1,36 @@
+; Application Start
+
+;-----------------------------------------------------------------------------
+; Hardware Target
+;-----------------------------------------------------------------------------
+
+; Target Platform: EK-TM4C123GXL
+; Target uC:       TM4C123GH6PM
+; System Clock:    -
+
+; Hardware configuration: -
+
+; Starts an image the way a reset would: the stack pointer and the reset
+; handler are the first two words of its vector table. The caller has already
+; pointed NVIC_VTABLE_R at the table and disabled the interrupts it enabled.
+
+;-----------------------------------------------------------------------------
+; Device includes, defines, and assembler directives
+;-----------------------------------------------------------------------------
+
+   .def runApplication
+
+;-----------------------------------------------------------------------------
+; Subroutines
+;-----------------------------------------------------------------------------
+
+.thumb
+.text
+
+; void runApplication(uint32_t vectors)
+; Does not return
+runApplication:
+             LDR   R1, [R0]
+             MOV   SP, R1
+             LDR   R1, [R0, #4]
+             BX    R1
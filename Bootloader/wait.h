@@ -0,0 +1,20 @@
+// Wait functions
+// Jason Losh
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+#ifndef WAIT_H_
+#define WAIT_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+extern void waitMicrosecond(uint32_t us);
+
+#endif
@@ -0,0 +1,23 @@
+# CMake toolchain file for arm-none-eabi-gcc (GNU Arm Embedded Toolchain)
+# The toolchain bin directory must be on the path, or ARM_TOOLCHAIN_PATH set to it
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+if(ARM_TOOLCHAIN_PATH)
+    set(prefix ${ARM_TOOLCHAIN_PATH}/arm-none-eabi-)
+else()
+    set(prefix arm-none-eabi-)
+endif()
+
+set(CMAKE_C_COMPILER ${prefix}gcc)
+set(CMAKE_ASM_COMPILER ${prefix}gcc)
+set(CMAKE_AR ${prefix}gcc-ar)
+set(CMAKE_RANLIB ${prefix}gcc-ranlib)
+
+# There is no C runtime to link a test executable against before the linker script is known
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+# Flash, SRAM and Stack Budget Report
+#
+# Reports a linked TM4C123GH6PM image against its flash and SRAM budget:
+#   budget.py [--origin 0x4000] --flash 0x40000 --sram 0x8000 [--objdump TOOL] [--output FILE] LAB.elf
+# and prints one line per image from the saved reports:
+#   budget.py --summary A.budget B.budget ...
+#
+# Sizes come from the section and symbol tables. The stack use of each function
+# is read from its final code (push, vpush, sub sp), so the LTO variants are
+# measured the same way as the others. The worst case follows the direct calls
+# from the reset handler and from every handler in the vector table, and adds
+# an exception frame for each handler. Calls through a pointer cannot be
+# followed, the functions that make them are marked.
+
+import argparse
+import re
+import struct
+import subprocess
+import sys
+
+SRAM_BASE = 0x20000000
+# 26 words with the FPU context (lazy stacking reserves it), and 1 word of alignment
+EXCEPTION_FRAME = 108
+DEFAULT_HANDLERS = ('IntDefaultHandler', 'NmiSR', 'FaultISR')
+
+
+def run(objdump, *args):
+    return subprocess.run([objdump] + list(args), check=True, stdout=subprocess.PIPE,
+                          universal_newlines=True).stdout
+
+
+def baseName(name):
+    # GCC clones and LTO privatized statics, e.g. uart0Isr.lto_priv.0, putcUart0.part.0
+    return re.sub(r'\.(lto_priv|part|isra|constprop|cold)\.\d+.*$', '', name)
+
+
+def readSections(objdump, elf):
+    sections = []
+    for line in run(objdump, '-h', '-w', elf).splitlines():
+        m = re.match(r'\s*\d+\s+(\S+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s+([0-9a-f]+)\s+[0-9a-f]+\s+\S+\s*(.*)$', line)
+        if m and 'ALLOC' in m.group(5):
+            sections.append({'name': m.group(1), 'size': int(m.group(2), 16), 'vma': int(m.group(3), 16),
+                             'lma': int(m.group(4), 16), 'load': 'LOAD' in m.group(5)})
+    return sections
+
+
+def readSymbols(objdump, elf):
+    functions = {}
+    aliases = {}
+    objects = []
+    for line in run(objdump, '-t', '-w', elf).splitlines():
+        m = re.match(r'([0-9a-f]{8}) (.{7}) (\S+)\s+([0-9a-f]{8}) +(?:\.hidden )?(\S+)$', line)
+        if not m:
+            continue
+        address, size, name = int(m.group(1), 16), int(m.group(4), 16), m.group(5)
+        if 'F' in m.group(2):
+            # Identical functions folded together share an address
+            aliases[name] = address & ~1
+            functions.setdefault(address & ~1, {'name': name, 'size': size, 'frame': 0, 'calls': set(),
+                                                'dynamic': False, 'indirect': False})
+        elif 'O' in m.group(2) and address >= SRAM_BASE and size:
+            objects.append((size, name))
+    return functions, aliases, objects
+
+
+def registerCount(operands):
+    count = 0
+    m = re.search(r'\{([^}]*)\}', operands)
+    if not m:
+        return 0
+    for item in m.group(1).split(','):
+        item = item.strip()
+        r = re.match(r'([rsd])(\d+)\s*-\s*[rsd](\d+)$', item)
+        if r:
+            count += (int(r.group(3)) - int(r.group(2)) + 1) * (2 if r.group(1) == 'd' else 1)
+        elif item:
+            count += 2 if item.startswith('d') else 1
+    return count
+
+
+def readCode(objdump, elf, functions, aliases):
+    byName = {name: functions[address] for name, address in aliases.items()}
+    current = None
+    for line in run(objdump, '-d', '-w', '--no-show-raw-insn', elf).splitlines():
+        m = re.match(r'([0-9a-f]+) <(.+)>:$', line)
+        if m:
+            # Local labels in the assembly files also get a heading
+            current = functions.get(int(m.group(1), 16), current)
+            continue
+        fields = [f.strip() for f in line.split('\t')]
+        if current is None or len(fields) < 2 or not re.match(r'[0-9a-f]+:', fields[0]):
+            continue
+        mnemonic = fields[1].split(' ')[0].lower()
+        operands = ' '.join(fields[2:]).lower() if len(fields) > 2 else ' '.join(fields[1].split(' ')[1:])
+        operands = re.split(r'\s[@;]', operands)[0]
+        target = re.search(r'<([^>+]+)>', ' '.join(fields[2:]))
+
+        if mnemonic in ('push', 'push.w', 'vpush', 'vpush.64', 'vpush.32') or \
+           (re.match(r'(stmdb|stmfd|vstmdb)', mnemonic) and operands.startswith('sp!')):
+            current['frame'] += 4 * registerCount(operands)
+        elif re.match(r'(sub|subw|sub\.w)$', mnemonic) and re.match(r'sp,', operands):
+            imm = re.search(r'#(0x[0-9a-f]+|\d+)', operands)
+            if imm:
+                current['frame'] += int(imm.group(1), 0)
+            else:
+                current['dynamic'] = True
+        elif re.match(r'str', mnemonic) and re.search(r'\[sp, #-(\d+)\]!', operands):
+            current['frame'] += int(re.search(r'\[sp, #-(\d+)\]!', operands).group(1))
+        elif mnemonic in ('blx', 'bx') and re.match(r'(r\d+|ip|r12)$', operands.strip()):
+            current['indirect'] = True
+        elif (mnemonic.startswith('b') or mnemonic.startswith('cb')) and target:
+            callee = byName.get(target.group(1))
+            if callee is current:
+                # A branch back to the start is a loop, a call is recursion
+                current['recursive'] = current.get('recursive') or mnemonic.startswith('bl')
+            elif callee is not None:
+                current['calls'].add(callee['name'])
+    return byName
+
+
+def readVectors(objdump, elf, functions):
+    data = b''
+    for line in run(objdump, '-s', '-j', '.intvecs', elf).splitlines():
+        words = line[1:].split('  ')[0].split(' ')
+        if line.startswith(' ') and len(words) > 1 and all(re.match(r'[0-9a-f]+$', w) for w in words):
+            data += bytes.fromhex(''.join(words[1:]))
+    vectors = struct.unpack('<%dI' % (len(data) // 4), data[:len(data) // 4 * 4])
+    names = []
+    for vector in vectors[1:]:
+        function = functions.get(vector & ~1)
+        names.append(function['name'] if vector and function else None)
+    return names
+
+
+def worstCase(byName, name, memo, active):
+    name = byName[name]['name']
+    if name in memo:
+        return memo[name]
+    function = byName[name]
+    if name in active:
+        function['recursive'] = True
+        return (0, [])
+    active.add(name)
+    best = (0, [])
+    for callee in sorted(function['calls']):
+        depth = worstCase(byName, callee, memo, active)
+        if depth[0] > best[0]:
+            best = depth
+    active.discard(name)
+    memo[name] = (function['frame'] + best[0], [name] + best[1])
+    return memo[name]
+
+
+def flags(function):
+    return ' '.join(flag for flag in ('dynamic', 'indirect', 'recursive') if function.get(flag))
+
+
+def percent(used, budget):
+    return 100.0 * used / budget if budget else 0.0
+
+
+def report(args):
+    elf = args.elf
+    sections = readSections(args.objdump, elf)
+    functions, aliases, objects = readSymbols(args.objdump, elf)
+    byName = readCode(args.objdump, elf, functions, aliases)
+    vectors = readVectors(args.objdump, elf, functions)
+
+    flashEnd = max([s['lma'] + s['size'] for s in sections if s['load'] and s['lma'] < SRAM_BASE] + [args.origin])
+    sramEnd = max([s['vma'] + s['size'] for s in sections if s['vma'] >= SRAM_BASE] + [SRAM_BASE])
+    stackReserve = sum(s['size'] for s in sections if s['name'] == '.stack')
+
+    memo = {}
+    reset = vectors[0] if vectors else None
+    main = worstCase(byName, reset, memo, set()) if reset else (0, [])
+    handlers = []
+    for name in vectors[1:]:
+        if name and baseName(name) not in DEFAULT_HANDLERS and name not in [h[0] for h in handlers]:
+            handlers.append((name, worstCase(byName, name, memo, set())))
+    nested = main[0] + sum(EXCEPTION_FRAME + h[1][0] for h in handlers)
+    deepest = max([EXCEPTION_FRAME + h[1][0] for h in handlers] + [0])
+
+    out = []
+    name = re.sub(r'\.elf$', '', elf.split('/')[-1])
+    out.append(name)
+    flashUsed = flashEnd - args.origin
+    out.append('flash %7d / %6d bytes %5.1f%%' % (flashUsed, args.flash, percent(flashUsed, args.flash)))
+    out.append('sram  %7d / %6d bytes %5.1f%%  (stack reserve %d)' %
+               (sramEnd - SRAM_BASE, args.sram, percent(sramEnd - SRAM_BASE, args.sram), stackReserve))
+    out.append('stack %7d / %6d bytes %5.1f%%  (every handler nested, %d with one handler)' %
+               (nested, stackReserve, percent(nested, stackReserve), main[0] + deepest))
+    out.append('')
+
+    out.append('Sections               address      size')
+    for s in sorted(sections, key=lambda s: s['vma']):
+        out.append('  %-18s 0x%08x %8d' % (s['name'], s['vma'], s['size']))
+    out.append('')
+
+    out.append('Worst case stack (%d byte exception frame per handler)' % EXCEPTION_FRAME)
+    out.append('  %-24s %6d  %s' % ('reset', main[0], ' > '.join(main[1])))
+    for handler, depth in handlers:
+        out.append('  %-24s %6d  %s' % (handler, EXCEPTION_FRAME + depth[0], ' > '.join(depth[1])))
+    marked = sorted(f['name'] for f in functions.values() if flags(f))
+    if marked:
+        out.append('  not followed: ' + ', '.join('%s (%s)' % (n, flags(byName[n])) for n in marked))
+    out.append('')
+
+    out.append('Functions        size  frame  worst')
+    for f in sorted(functions.values(), key=lambda f: (-f['size'], f['name'])):
+        worst = worstCase(byName, f['name'], memo, set())[0]
+        out.append('  %-32s %6d %6d %6d  %s' % (f['name'], f['size'], f['frame'], worst, flags(f)))
+    out.append('')
+
+    out.append('SRAM objects     size')
+    for size, obj in sorted(objects, key=lambda o: (-o[0], o[1])):
+        out.append('  %-32s %6d' % (obj, size))
+
+    text = '\n'.join(out) + '\n'
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+def summary(files):
+    over = False
+    print('%-20s %-22s %-22s %-22s' % ('image', 'flash', 'sram', 'stack'))
+    for path in files:
+        with open(path) as f:
+            lines = f.read().splitlines()
+        row = [lines[0]]
+        for line in lines[1:4]:
+            m = re.match(r'\w+\s+(\d+) /\s+(\d+)', line)
+            used, budget = int(m.group(1)), int(m.group(2))
+            row.append('%6d / %-6d %5.1f%%' % (used, budget, percent(used, budget)))
+            if used > budget:
+                row[-1] += '!'
+                over = True
+        print('%-20s %s %s %s' % tuple(row))
+    if over:
+        print('! over budget')
+    return 1 if over else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='TM4C123GH6PM flash, SRAM and stack budget report')
+    parser.add_argument('--objdump', default='arm-none-eabi-objdump')
+    parser.add_argument('--origin', type=lambda x: int(x, 0), default=0, help='start of the flash region')
+    parser.add_argument('--flash', type=lambda x: int(x, 0), default=0x40000)
+    parser.add_argument('--sram', type=lambda x: int(x, 0), default=0x8000)
+    parser.add_argument('--output')
+    parser.add_argument('--summary', action='store_true', help='summarize saved reports')
+    parser.add_argument('elf', nargs='+')
+    args = parser.parse_args()
+    if args.summary:
+        return summary(args.elf)
+    args.elf = args.elf[0]
+    return report(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
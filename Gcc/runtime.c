@@ -0,0 +1,65 @@
+// C Runtime Startup for arm-none-eabi-gcc
+// Replaces the TI RTS _c_int00 that the CCS startup file's ResetISR branches to
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+// The reset vector already loaded the stack pointer with __STACK_TOP, so only
+// the FPU, .data and .bss are set up here before main() is called
+// There are no constructors (.init_array) in the labs, so none are run
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include "tm4c123gh6pm.h"
+
+// Linker script symbols (tm4c123gh6pm.ld.in)
+extern uint32_t __data_load__;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+extern uint32_t __bss_start__;
+extern uint32_t __bss_end__;
+
+extern int main(void);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Only reached from the ResetISR inline assembly, so it is kept explicitly
+__attribute__((used, noreturn)) void _c_int00(void)
+{
+    uint32_t *src = &__data_load__;
+    uint32_t *dst;
+
+    // Enable the FPU before any code that may use it
+    NVIC_CPAC_R |= NVIC_CPAC_CP10_FULL | NVIC_CPAC_CP11_FULL;
+    __asm__ volatile ("dsb\n"
+                      "isb" : : : "memory");
+
+    for (dst = &__data_start__; dst < &__data_end__; )
+        *dst++ = *src++;
+    for (dst = &__bss_start__; dst < &__bss_end__; )
+        *dst++ = 0;
+
+    main();
+    while (1);
+}
+
+// newlib allocation hook, the CCS projects build with --heap_size=0 so it always fails
+void *_sbrk(ptrdiff_t increment)
+{
+    errno = ENOMEM;
+    return (void *)-1;
+}
@@ -0,0 +1,58 @@
+// TI compiler intrinsics for arm-none-eabi-gcc
+// Force-included (-include) into the lab sources, so they compile unchanged
+
+// The TI #pragma DATA_SECTION and DATA_ALIGN placements are ignored by GCC,
+// tm4c123gh6pm.ld.in places those variables by their section names instead
+
+#ifndef TI_GCC_H_
+#define TI_GCC_H_
+
+#include <stdint.h>
+
+// Returns the old PRIMASK
+static inline __attribute__((always_inline)) uint32_t _disable_interrupts(void)
+{
+    uint32_t primask;
+    __asm__ volatile ("mrs %0, primask\n"
+                      "cpsid i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline __attribute__((always_inline)) uint32_t _enable_interrupts(void)
+{
+    uint32_t primask;
+    __asm__ volatile ("mrs %0, primask\n"
+                      "cpsie i" : "=r" (primask) : : "memory");
+    return primask;
+}
+
+static inline __attribute__((always_inline)) void _restore_interrupts(uint32_t primask)
+{
+    __asm__ volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+// Sets BASEPRI and returns the old value
+static inline __attribute__((always_inline)) uint32_t _set_interrupt_priority(uint32_t basepri)
+{
+    uint32_t old;
+    __asm__ volatile ("mrs %0, basepri\n"
+                      "msr basepri, %1" : "=&r" (old) : "r" (basepri) : "memory");
+    return old;
+}
+
+// Waits at least cycles clocks
+static inline __attribute__((always_inline)) void _delay_cycles(uint32_t cycles)
+{
+    while (cycles--)
+        __asm__ volatile ("nop");
+}
+
+// Leading zero count, 32 for 0
+static inline __attribute__((always_inline)) uint32_t _norm(uint32_t x)
+{
+    uint32_t zeros;
+    __asm__ ("clz %0, %1" : "=r" (zeros) : "r" (x));
+    return zeros;
+}
+
+#endif
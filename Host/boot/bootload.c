@@ -0,0 +1,480 @@
+// Bootloader uploader
+// Sends an application image to the bootloader (Bootloader/) over a serial port
+
+// Usage: bootload [options] IMAGE
+//   --port PATH        serial port, or the bootsim pty (/dev/ttyACM0)
+//   --baud N           115200
+//   --wait SECONDS     how long to look for the bootloader while the target is reset (10)
+//   --window N         DATA frames in flight, at most the bootloader's window
+//   --no-run           leave the verified image without starting it
+// IMAGE is the raw binary of the application linked at BOOT_APP_BASE
+// (Gcc/ Project-Os.bin, or tiobj2bin for the CCS build).
+
+// DATA frames are sent go-back-N: up to window frames are in flight, an ACK
+// releases every frame up to its sequence, and a NAK or a timeout resends
+// from the first frame not acknowledged. The other frames wait for their reply.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "boot.h"
+#include "crc.h"
+
+#define FRAME_SIZE          (BOOT_FRAME_OVERHEAD + BOOT_MAX_PAYLOAD)
+#define HELLO_INTERVAL_MS   100
+#define REPLY_TIMEOUT_MS    500
+#define LATENCY_MS          20                      // USB serial turnaround
+#define RETRIES             5
+#define ERASE_PAGE_MS       20                      // 15 ms page erase, with margin
+#define VERIFY_TIMEOUT_MS   2000                    // CRC-32 of the largest image, and the descriptor
+
+typedef struct _REPLY
+{
+    uint8_t type;
+    uint8_t sequence;
+    uint16_t length;
+    uint8_t payload[BOOT_MAX_PAYLOAD];
+} REPLY;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static int port = -1;
+static uint32_t baud = 115200;
+static uint8_t sequence = 0;                        // of the next frame sent
+
+static uint8_t rxData[2 * FRAME_SIZE];
+static uint16_t rxCount = 0;
+
+static uint32_t framesSent = 0;
+static uint32_t framesResent = 0;
+static uint32_t naks = 0;
+static uint32_t timeouts = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: bootload [--port PATH] [--baud N] [--wait SECONDS] [--window N] [--no-run] IMAGE\n");
+    exit(2);
+}
+
+static void fail(const char *format, ...) __attribute__((format(printf, 1, 2), noreturn));
+static void fail(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "bootload: ");
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    exit(1);
+}
+
+static double seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static const char *statusName(uint8_t status)
+{
+    static const char *names[] = {"ok", "bad frame", "bad type", "bad address", "flash error", "bad image"};
+    return status < sizeof(names) / sizeof(names[0]) ? names[status] : "unknown status";
+}
+
+static speed_t toSpeed(uint32_t rate)
+{
+    switch (rate)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+    }
+    fail("unsupported baud rate %u", rate);
+}
+
+static void openPort(const char *path)
+{
+    struct termios t;
+    port = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (port < 0)
+        fail("%s: %s", path, strerror(errno));
+    if (isatty(port))
+    {
+        if (tcgetattr(port, &t) < 0)
+            fail("%s: %s", path, strerror(errno));
+        cfmakeraw(&t);
+        cfsetispeed(&t, toSpeed(baud));
+        cfsetospeed(&t, toSpeed(baud));
+        if (tcsetattr(port, TCSANOW, &t) < 0)
+            fail("%s: %s", path, strerror(errno));
+        tcflush(port, TCIOFLUSH);
+    }
+}
+
+static void put32(uint8_t *p, uint32_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+static void writeAll(const uint8_t *data, size_t length)
+{
+    struct pollfd fd = {port, POLLOUT, 0};
+    ssize_t n;
+    while (length)
+    {
+        n = write(port, data, length);
+        if (n > 0)
+        {
+            data += n;
+            length -= n;
+        }
+        else if (n < 0 && errno != EAGAIN && errno != EINTR)
+            fail("write: %s", strerror(errno));
+        else
+            poll(&fd, 1, 100);
+    }
+}
+
+static void sendFrame(uint8_t type, uint8_t frameSequence, const uint8_t *payload, uint16_t length)
+{
+    uint8_t frame[FRAME_SIZE];
+    uint16_t crc;
+    frame[0] = BOOT_SYNC & 0xFF;
+    frame[1] = BOOT_SYNC >> 8;
+    frame[2] = type;
+    frame[3] = frameSequence;
+    frame[4] = length;
+    frame[5] = length >> 8;
+    if (length)
+        memcpy(&frame[BOOT_HEADER_SIZE], payload, length);
+    crc = crc16(frame, BOOT_HEADER_SIZE + length);
+    frame[BOOT_HEADER_SIZE + length] = crc;
+    frame[BOOT_HEADER_SIZE + length + 1] = crc >> 8;
+    writeAll(frame, BOOT_FRAME_OVERHEAD + length);
+    framesSent++;
+}
+
+// Takes a reply from the bytes received so far, skipping damaged ones
+static bool parseReply(REPLY *reply)
+{
+    uint16_t start = 0, length, crc;
+    bool found = false;
+
+    while (!found && rxCount - start >= BOOT_FRAME_OVERHEAD)
+    {
+        const uint8_t *p = &rxData[start];
+        if (p[0] != (BOOT_SYNC & 0xFF) || p[1] != (BOOT_SYNC >> 8))
+        {
+            start++;
+            continue;
+        }
+        length = p[4] | (p[5] << 8);
+        if (length > BOOT_MAX_PAYLOAD)
+        {
+            start++;
+            continue;
+        }
+        if (rxCount - start < BOOT_FRAME_OVERHEAD + length)
+            break;
+        crc = p[BOOT_HEADER_SIZE + length] | (p[BOOT_HEADER_SIZE + length + 1] << 8);
+        if (crc16(p, BOOT_HEADER_SIZE + length) != crc)
+        {
+            start++;
+            continue;
+        }
+        reply->type = p[2];
+        reply->sequence = p[3];
+        reply->length = length;
+        memcpy(reply->payload, &p[BOOT_HEADER_SIZE], length);
+        start += BOOT_FRAME_OVERHEAD + length;
+        found = true;
+    }
+    memmove(rxData, &rxData[start], rxCount - start);
+    rxCount -= start;
+    return found;
+}
+
+// Waits up to timeoutMs for a reply
+static bool receiveReply(REPLY *reply, int timeoutMs)
+{
+    struct pollfd fd = {port, POLLIN, 0};
+    double end = seconds() + timeoutMs / 1000.0;
+    ssize_t n;
+    int wait;
+
+    while (!parseReply(reply))
+    {
+        wait = (int)((end - seconds()) * 1000);
+        if (wait <= 0)
+            return false;
+        if (poll(&fd, 1, wait) < 0 && errno != EINTR)
+            fail("poll: %s", strerror(errno));
+        n = read(port, &rxData[rxCount], sizeof(rxData) - rxCount);
+        if (n > 0)
+            rxCount += n;
+        else if (n < 0 && errno != EAGAIN && errno != EINTR)
+            fail("read: %s", strerror(errno));
+    }
+    return true;
+}
+
+// Sends a frame and waits for its reply, resending after a timeout or a
+// damaged frame. Returns the status, or fails if there is no answer.
+static uint8_t transact(uint8_t type, const uint8_t *payload, uint16_t length, int timeoutMs, REPLY *reply)
+{
+    uint8_t frameSequence = sequence++;
+    uint8_t attempt;
+    bool damaged;
+    REPLY r;
+
+    reply = reply ? reply : &r;
+    for (attempt = 0; attempt < RETRIES; attempt++)
+    {
+        if (attempt)
+            framesResent++;
+        sendFrame(type, frameSequence, payload, length);
+        damaged = false;
+        while (!damaged && receiveReply(reply, timeoutMs))
+        {
+            if (reply->type == BOOT_NAK && reply->payload[0] == BOOT_BAD_FRAME)
+            {
+                naks++;
+                damaged = true;
+            }
+            else if (reply->sequence == frameSequence)
+                return reply->type == BOOT_NAK ? reply->payload[0] : BOOT_OK;
+        }
+        if (!damaged)
+            timeouts++;
+    }
+    fail("no reply from the bootloader");
+}
+
+// Sends HELLO until the bootloader answers, it only listens for BOOT_WAIT_MS after a reset
+static void connect(BOOT_INFO_PAYLOAD *info, double waitSeconds)
+{
+    double end = seconds() + waitSeconds;
+    REPLY reply;
+
+    fprintf(stderr, "bootload: waiting for the bootloader, reset the target\n");
+    while (seconds() < end)
+    {
+        sendFrame(BOOT_HELLO, sequence, 0, 0);
+        while (receiveReply(&reply, HELLO_INTERVAL_MS))
+        {
+            if (reply.type == BOOT_INFO && reply.sequence == sequence && reply.length >= sizeof(*info))
+            {
+                memcpy(info, reply.payload, sizeof(*info));
+                sequence++;
+                return;
+            }
+        }
+    }
+    fail("no bootloader found");
+}
+
+// Streams the image in DATA frames with up to window frames in flight
+static void program(const uint8_t *image, uint32_t length, uint32_t base, uint16_t maxData, uint8_t window)
+{
+    uint32_t count = (length + maxData - 1) / maxData;
+    uint32_t first = 0, next = 0, index, position;
+    uint8_t firstSequence = sequence;
+    uint8_t payload[BOOT_MAX_PAYLOAD];
+    uint16_t size;
+    double frameSeconds = (BOOT_FRAME_OVERHEAD + 4 + maxData) * 10.0 / baud;
+    double staleUntil = 0;
+    uint32_t resendFrom = 0;
+    int timeoutMs;
+    REPLY reply;
+
+    // Time to send a window and program it, the frames ahead of a lost one are still on the line
+    timeoutMs = REPLY_TIMEOUT_MS + (int)(2000.0 * window * frameSeconds);
+
+    while (first < count)
+    {
+        while (next < count && next < first + window)
+        {
+            position = next * maxData;
+            size = length - position < maxData ? length - position : maxData;
+            put32(payload, base + position);
+            memcpy(&payload[4], &image[position], size);
+            sendFrame(BOOT_DATA, firstSequence + next, payload, size + 4);
+            next++;
+        }
+
+        if (!receiveReply(&reply, timeoutMs))
+        {
+            timeouts++;
+            framesResent += next - first;
+            next = first;
+            resendFrom = first;
+            staleUntil = 0;
+            continue;
+        }
+        if (reply.type != BOOT_ACK && reply.type != BOOT_NAK)
+            continue;
+
+        // Frame number of the reply's sequence, relative to the first frame in flight
+        index = first + (uint8_t)(reply.sequence - (uint8_t)(firstSequence + first));
+        if (reply.type == BOOT_ACK && index < next)
+            first = index + 1;
+        else if (reply.type == BOOT_NAK && reply.payload[0] == BOOT_BAD_FRAME && index <= next)
+        {
+            // Until the frames that were in flight at the last resend have
+            // drained, a NAK for the same frame is about one of them
+            naks++;
+            if (index == resendFrom && seconds() < staleUntil)
+                continue;
+            staleUntil = seconds() + (next - first) * frameSeconds + LATENCY_MS / 1000.0;
+            first = index;
+            framesResent += next - first;
+            next = first;
+            resendFrom = first;
+        }
+        else if (reply.type == BOOT_NAK && index < next)
+            fail("DATA at 0x%08X: %s", base + index * maxData, statusName(reply.payload[0]));
+    }
+    sequence = firstSequence + count;
+}
+
+static uint8_t *readImage(const char *path, uint32_t *length)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *image;
+    long size;
+
+    if (!f || fseek(f, 0, SEEK_END) < 0 || (size = ftell(f)) < 0)
+        fail("%s: %s", path, strerror(errno));
+    if (size < 8 || size > BOOT_APP_SIZE)
+        fail("%s: %ld bytes, the image must be 8 to %u bytes", path, size, BOOT_APP_SIZE);
+    // Whole words, the padding is what erased flash reads
+    *length = (size + 3) & ~3;
+    image = malloc(*length);
+    if (!image)
+        fail("out of memory");
+    memset(image, 0xFF, *length);
+    rewind(f);
+    if (fread(image, 1, size, f) != (size_t)size)
+        fail("%s: read failed", path);
+    fclose(f);
+    return image;
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        {"port", required_argument, 0, 'p'},
+        {"baud", required_argument, 0, 'b'},
+        {"wait", required_argument, 0, 'w'},
+        {"window", required_argument, 0, 'n'},
+        {"no-run", no_argument, 0, 'r'},
+        {0, 0, 0, 0}
+    };
+    const char *path = "/dev/ttyACM0";
+    double waitSeconds = 10, start, elapsed, lineRate;
+    uint32_t length, crc, pages, window = 0;
+    bool run = true;
+    BOOT_INFO_PAYLOAD info;
+    uint8_t payload[8], status;
+    uint8_t *image;
+    int option;
+
+    while ((option = getopt_long(argc, argv, "", options, 0)) != -1)
+    {
+        switch (option)
+        {
+            case 'p': path = optarg; break;
+            case 'b': baud = atoi(optarg); break;
+            case 'w': waitSeconds = atof(optarg); break;
+            case 'n': window = atoi(optarg); break;
+            case 'r': run = false; break;
+            default: usage();
+        }
+    }
+    if (optind != argc - 1)
+        usage();
+
+    image = readImage(argv[optind], &length);
+    crc = crc32(0, image, length);
+    openPort(path);
+
+    connect(&info, waitSeconds);
+    fprintf(stderr, "bootload: bootloader %u, window %u, %u bytes at 0x%08X",
+            info.version, info.window, info.appSize, info.appBase);
+    if (info.imageLength)
+        fprintf(stderr, ", image %u bytes crc32 0x%08X\n", info.imageLength, info.imageCrc);
+    else
+        fprintf(stderr, ", no image\n");
+    if (length > info.appSize)
+        fail("the image is %u bytes, the application area %u", length, info.appSize);
+    if (info.maxData == 0 || info.maxData > BOOT_MAX_DATA || info.maxData % 4)
+        fail("the bootloader's frame size %u is not supported", info.maxData);
+    if (window == 0 || window > info.window)
+        window = info.window;
+
+    start = seconds();
+    pages = (length + info.pageSize - 1) / info.pageSize;
+    put32(payload, info.appBase);
+    put32(payload + 4, pages * info.pageSize);
+    status = transact(BOOT_ERASE, payload, 8, REPLY_TIMEOUT_MS + (pages + 1) * ERASE_PAGE_MS, 0);
+    if (status != BOOT_OK)
+        fail("erase: %s", statusName(status));
+    fprintf(stderr, "bootload: erased %u pages in %.2f s\n", pages, seconds() - start);
+
+    start = seconds();
+    program(image, length, info.appBase, info.maxData, window);
+    elapsed = seconds() - start;
+    lineRate = baud / 10.0;
+    fprintf(stderr, "bootload: wrote %u bytes in %.2f s, %.0f bytes/s (%.0f%% of the line), "
+                    "%u of %u frames resent, %u naks, %u timeouts\n", length, elapsed, length / elapsed,
+            100 * length / elapsed / lineRate, framesResent, framesSent, naks, timeouts);
+
+    put32(payload, length);
+    put32(payload + 4, crc);
+    status = transact(BOOT_VERIFY, payload, 8, VERIFY_TIMEOUT_MS, 0);
+    if (status != BOOT_OK)
+        fail("verify: %s", statusName(status));
+    fprintf(stderr, "bootload: verified, crc32 0x%08X\n", crc);
+
+    if (run)
+    {
+        status = transact(BOOT_RUN, 0, 0, REPLY_TIMEOUT_MS, 0);
+        if (status != BOOT_OK)
+            fail("run: %s", statusName(status));
+        fprintf(stderr, "bootload: started\n");
+    }
+    free(image);
+    close(port);
+    return 0;
+}
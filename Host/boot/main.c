@@ -0,0 +1,128 @@
+// Bootloader simulator
+// Runs the bootloader (Bootloader/) against the peripheral models of Host/sim
+
+// Usage: bootsim [options]
+//   --flash FILE       the whole flash, kept between runs (boot.flash)
+//   --link PATH        also makes PATH a symbolic link to the pty
+//   --noise N          damages every Nth byte the bootloader receives
+//   --trace FILE       event trace (see simtrace.h), - for stdout
+// UART0 is a new pseudo terminal, for bootload --port. The simulation ends,
+// with status 0, when the bootloader starts the application.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "sim.h"
+#include "simnvic.h"
+#include "simsysctl.h"
+#include "simflash.h"
+#include "simuart.h"
+#include "simtrace.h"
+#include "boot.h"
+
+int firmwareMain(void);
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static int slave = -1;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: bootsim [--flash FILE] [--link PATH] [--noise N] [--trace FILE]\n");
+    exit(2);
+}
+
+// Master side of a new pty, the slave stays open so the master never sees a hangup
+static int openPty(const char *link)
+{
+    struct termios t;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+        simFatal("pty: %s", strerror(errno));
+    slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0 || tcgetattr(slave, &t) < 0)
+        simFatal("pty: %s", strerror(errno));
+    cfmakeraw(&t);
+    tcsetattr(slave, TCSANOW, &t);
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    if (link)
+    {
+        unlink(link);
+        if (symlink(ptsname(master), link) < 0)
+            simFatal("%s: %s", link, strerror(errno));
+    }
+    fprintf(stderr, "sim: UART0 on %s\n", ptsname(master));
+    return master;
+}
+
+// The last reply, the ACK of RUN, is lost if the pty closes before the host
+// reads it, so the exit waits up to a second for that
+static void drainPty(void)
+{
+    int pending, i;
+    for (i = 0; i < 100 && ioctl(slave, FIONREAD, &pending) == 0 && pending > 0; i++)
+        usleep(10000);
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        {"flash", required_argument, 0, 'f'},
+        {"link", required_argument, 0, 'l'},
+        {"noise", required_argument, 0, 'n'},
+        {"trace", required_argument, 0, 'r'},
+        {0, 0, 0, 0}
+    };
+    const char *flashPath = "boot.flash", *link = 0, *tracePath = 0;
+    uint32_t noise = 0;
+    int option, uart;
+
+    while ((option = getopt_long(argc, argv, "", options, 0)) != -1)
+    {
+        switch (option)
+        {
+            case 'f': flashPath = optarg; break;
+            case 'l': link = optarg; break;
+            case 'n': noise = atoi(optarg); break;
+            case 'r': tracePath = optarg; break;
+            default: usage();
+        }
+    }
+    if (optind != argc)
+        usage();
+    if (tracePath)
+        simOpenTrace(tracePath, 0);
+
+    simSetFlash(0, BOOT_FLASH_SIZE, FLASH_MEMORY);
+    simInit(flashPath);
+    simInitNvic();
+    simInitSysctl();
+    simInitFlash();
+
+    uart = openPty(link);
+    atexit(drainPty);
+    simInitUart(uart, uart, false);
+    simUartNoise(noise);
+
+    return firmwareMain();
+}
@@ -0,0 +1,27 @@
+// Application start for the host build
+
+// Replaces run.s. The application is ARM code, so the simulation ends where
+// the bootloader would start it.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "simtrace.h"
+#include "run.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void runApplication(uint32_t vectors)
+{
+    const uint32_t *vector = (const uint32_t *)(uintptr_t)vectors;
+    simTrace("start sp 0x%08X reset 0x%08X", vector[0], vector[1]);
+    fprintf(stderr, "sim: application started, sp 0x%08X reset 0x%08X\n", vector[0], vector[1]);
+    exit(0);
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Uploads an image through a noisy simulated link, then checks the bootloader
+# starts it on its own and refuses it once it is damaged
+# Usage: upload.sh BOOTSIM BOOTLOAD
+
+set -e
+bootsim=$1
+bootload=$2
+dir=$(mktemp -d)
+trap 'kill $sim 2>/dev/null || true; rm -rf "$dir"' EXIT
+
+# 40 KiB image, stack top 0x20008000 and reset handler 0x4101
+printf '\000\200\000\040\001\101\000\000' > "$dir/image"
+head -c 40952 /dev/urandom >> "$dir/image"
+
+"$bootsim" --flash "$dir/flash" --link "$dir/tty" --noise 2000 &
+sim=$!
+for i in 1 2 3 4 5 6 7 8 9 10; do
+    [ -e "$dir/tty" ] && break
+    sleep 0.1
+done
+"$bootload" --port "$dir/tty" "$dir/image"
+wait $sim
+
+# No host, the verified image starts after the wait
+"$bootsim" --flash "$dir/flash" 2>&1 | grep -q "application started"
+
+# A damaged image fails its CRC-32 and the bootloader keeps waiting
+printf '\125' | dd of="$dir/flash" bs=1 seek=$((0x5000)) conv=notrunc 2>/dev/null
+status=0
+timeout 3 "$bootsim" --flash "$dir/flash" > /dev/null 2>&1 || status=$?
+[ $status -eq 124 ]
@@ -0,0 +1,19 @@
+// Atomic functions for the host build
+
+// Replaces atomic.s, ISRs run on the firmware's thread so a host atomic is enough
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "atomic.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint32_t atomicFetchAdd(volatile uint32_t *p, uint32_t value)
+{
+    return __atomic_fetch_add(p, value, __ATOMIC_SEQ_CST);
+}
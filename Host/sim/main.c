@@ -0,0 +1,252 @@
+// Feeder simulator
+// Runs the Lab8 firmware against the peripheral models
+
+// Usage: feedersim [options]
+//   --uart pty|stdio   UART0 on a new pseudo terminal (default) or on stdin/stdout
+//   --eeprom FILE      EEPROM contents, kept between runs (feeder.eeprom)
+//   --flash FILE       history area of the flash (feeder.flash)
+//   --level ML         water in the bowl at power up (200)
+//   --time HH:MM[:SS]  RTC at power up (00:00)
+//   --fill ML/S        pump rate (20)
+//   --drink ML/S       drinking rate (0)
+//   --script FILE      runs FILE in virtual time, as fast as the host can (see simscript.h)
+//   --trace FILE       event trace (see simtrace.h), - for stdout, the default with --script
+// With a pty, stdin is the simulator console (see simscript.h)
+// A script starts from an erased EEPROM and flash unless --eeprom or --flash is given
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <termios.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "sim.h"
+#include "simnvic.h"
+#include "simsysctl.h"
+#include "simgpio.h"
+#include "simtimer.h"
+#include "simhib.h"
+#include "simeeprom.h"
+#include "simflash.h"
+#include "simpwm.h"
+#include "simcomp.h"
+#include "simplant.h"
+#include "simuart.h"
+#include "simtrace.h"
+#include "simscript.h"
+
+#define CONSOLE_SIZE    128
+
+int firmwareMain(void);
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static char console[CONSOLE_SIZE];
+static uint8_t consoleCount = 0;
+static struct termios savedTerminal;
+static bool terminalSaved = false;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: feedersim [--uart pty|stdio] [--eeprom FILE] [--flash FILE]\n"
+                    "                 [--level ML] [--time HH:MM[:SS]] [--fill ML/S] [--drink ML/S]\n"
+                    "                 [--script FILE] [--trace FILE]\n");
+    exit(2);
+}
+
+// Path of an anonymous file, so a scripted run does not depend on earlier runs
+static const char *createScratch(const char *name)
+{
+    static char paths[2][32];
+    static uint8_t count = 0;
+    int fd = memfd_create(name, 0);
+    if (fd < 0 || count == 2)
+        simFatal("memfd: %s", strerror(errno));
+    snprintf(paths[count], sizeof(paths[count]), "/proc/self/fd/%d", fd);
+    return paths[count++];
+}
+
+static void setNonBlocking(int fd)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void restoreTerminal(void)
+{
+    if (terminalSaved)
+        tcsetattr(0, TCSANOW, &savedTerminal);
+}
+
+// Characters reach the firmware as typed, it echoes and edits the line itself
+static void setCharacterInput(void)
+{
+    struct termios t;
+    if (!isatty(0) || tcgetattr(0, &savedTerminal) < 0)
+        return;
+    terminalSaved = true;
+    atexit(restoreTerminal);
+    t = savedTerminal;
+    t.c_lflag &= ~(ICANON | ECHO);
+    t.c_cc[VMIN] = 1;
+    t.c_cc[VTIME] = 0;
+    tcsetattr(0, TCSANOW, &t);
+}
+
+// Master side of a new pty, the slave stays open so the master never sees a hangup
+static int openPty(void)
+{
+    struct termios t;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    int slave;
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+        simFatal("pty: %s", strerror(errno));
+    slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0 || tcgetattr(slave, &t) < 0)
+        simFatal("pty: %s", strerror(errno));
+    cfmakeraw(&t);
+    tcsetattr(slave, TCSANOW, &t);
+    setNonBlocking(master);
+    fprintf(stderr, "sim: UART0 on %s\n", ptsname(master));
+    return master;
+}
+
+static void updateConsole(void *context, uint64_t now)
+{
+    char c;
+    ssize_t n;
+    (void)context;
+    (void)now;
+    while ((n = read(0, &c, 1)) == 1)
+    {
+        if (c == '\n')
+        {
+            console[consoleCount] = 0;
+            consoleCount = 0;
+            if (!simRunCommand(console))
+                fprintf(stderr, "sim: uart TEXT, level ML, fill ML/S, drink ML/S, motion 0|1, status or quit\n");
+        }
+        else if (consoleCount < CONSOLE_SIZE - 1)
+            console[consoleCount++] = c;
+    }
+    if (n == 0)
+        simRemoveInput(0);
+}
+
+// Not mapped at any address, only updated with the devices
+static const SIM_DEVICE consoleDevice =
+{
+    "CONSOLE", 0, 0, 0, 0, 0, updateConsole, 0
+};
+
+static uint32_t parseTime(const char *text)
+{
+    unsigned hours, minutes, seconds = 0;
+    if (sscanf(text, "%u:%u:%u", &hours, &minutes, &seconds) < 2 || hours > 23 || minutes > 59 || seconds > 59)
+        usage();
+    return hours * 3600 + minutes * 60 + seconds;
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        {"uart", required_argument, 0, 'u'},
+        {"eeprom", required_argument, 0, 'e'},
+        {"flash", required_argument, 0, 'f'},
+        {"level", required_argument, 0, 'l'},
+        {"time", required_argument, 0, 't'},
+        {"fill", required_argument, 0, 'p'},
+        {"drink", required_argument, 0, 'd'},
+        {"script", required_argument, 0, 's'},
+        {"trace", required_argument, 0, 'r'},
+        {0, 0, 0, 0}
+    };
+    const char *eepromPath = 0, *flashPath = 0, *scriptPath = 0, *tracePath = 0;
+    bool pty = true;
+    double level = 200, fill = 20, drink = 0;
+    uint32_t seconds = 0;
+    int option, uart;
+
+    while ((option = getopt_long(argc, argv, "", options, 0)) != -1)
+    {
+        switch (option)
+        {
+            case 'u':
+                if (strcmp(optarg, "pty") && strcmp(optarg, "stdio"))
+                    usage();
+                pty = !strcmp(optarg, "pty");
+                break;
+            case 'e': eepromPath = optarg; break;
+            case 'f': flashPath = optarg; break;
+            case 'l': level = atof(optarg); break;
+            case 't': seconds = parseTime(optarg); break;
+            case 'p': fill = atof(optarg); break;
+            case 'd': drink = atof(optarg); break;
+            case 's': scriptPath = optarg; break;
+            case 'r': tracePath = optarg; break;
+            default: usage();
+        }
+    }
+    if (optind != argc)
+        usage();
+    if (scriptPath)
+    {
+        eepromPath = eepromPath ? eepromPath : createScratch("eeprom");
+        flashPath = flashPath ? flashPath : createScratch("flash");
+        tracePath = tracePath ? tracePath : "-";
+        simSetRealTime(false);
+    }
+    if (tracePath)
+        simOpenTrace(tracePath, seconds);
+
+    simInit(flashPath ? flashPath : "feeder.flash");
+    simInitNvic();
+    simInitSysctl();
+    simInitGpio();
+    simInitTimers();
+    simInitHib(seconds);
+    simInitEeprom(eepromPath ? eepromPath : "feeder.eeprom");
+    simInitFlash();
+    simInitPwm();
+    simInitComp();
+    simInitPlant(level, fill, drink);
+
+    if (scriptPath)
+    {
+        simInitUart(-1, -1, true);
+        simLoadScript(scriptPath, seconds);
+        return firmwareMain();
+    }
+
+    setNonBlocking(0);
+    if (pty)
+    {
+        uart = openPty();
+        simInitUart(uart, uart, false);
+        simAddInput(0);
+        simAddDevice(&consoleDevice);
+    }
+    else
+    {
+        setCharacterInput();
+        simInitUart(0, 1, true);
+    }
+
+    return firmwareMain();
+}
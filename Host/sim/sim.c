@@ -0,0 +1,729 @@
+// TM4C123GH6PM peripheral simulator core
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include "sim.h"
+#include "simnvic.h"
+
+#define PAGE_SIZE       4096
+#define TRAP_FLAG       0x100               // EFLAGS.TF, single step
+#define SPIN_REPEATS    3                   // identical reads in a row that count as a polling loop
+#define PACE_SLACK      (SIM_CLOCK / 1000)  // simulated time may run 1 ms ahead of the wall clock
+#define IDLE_LIMIT      (SIM_CLOCK / 10)    // real time idle waits are re-evaluated every 100 ms
+
+#define MAX_DEVICES     64
+#define MAX_INPUTS      8
+#define MAX_SITES       4096
+#define STUB_SIZE       10
+#define STUB_BASE       0x30000000          // within a rel32 jump of the firmware
+#define NO_REGISTER     0xFF
+#define RIP_REGISTER    0xFE
+
+typedef enum _REGION_TYPE
+{
+    REGION_PERIPHERAL,
+    REGION_BITBAND,
+    REGION_PPB,
+    REGION_FLASH,
+    REGION_COUNT
+} REGION_TYPE;
+
+typedef struct _REGION
+{
+    uint32_t base;
+    uint32_t size;
+    uint32_t mapped;                        // where the firmware sees it, base except for the flash
+    uint8_t *view;                          // read/write mapping used by the models
+} REGION;
+
+// Register access being emulated or single stepped
+typedef struct _ACCESS
+{
+    bool pending;
+    bool write;
+    bool bitband;
+    uint32_t address;                       // faulting address
+    uint32_t word;                          // register address
+    uint8_t bit;                            // bit-band bit
+    uint32_t staged;                        // value the instruction found
+} ACCESS;
+
+// Decoded register move
+typedef struct _MOVE
+{
+    uint8_t length;
+    bool write;
+    bool immediate;
+    bool address32;                         // 0x67 prefix
+    uint8_t reg;                            // register operand, x86 numbering
+    uint8_t base;                           // memory operand registers
+    uint8_t index;
+    uint8_t scale;
+    int32_t displacement;
+    uint32_t value;                         // immediate operand
+} MOVE;
+
+typedef struct _SITE
+{
+    MOVE move;
+    uint64_t resume;
+} SITE;
+
+// CPU state saved by simAccessThunk, lowest address first
+enum
+{
+    FRAME_R15, FRAME_R14, FRAME_R13, FRAME_R12, FRAME_R11, FRAME_R10, FRAME_R9, FRAME_R8,
+    FRAME_RDI, FRAME_RSI, FRAME_RBP, FRAME_RBX, FRAME_RDX, FRAME_RCX, FRAME_RAX, FRAME_REGISTERS
+};
+
+typedef struct _SIM_FRAME
+{
+    uint64_t registers[FRAME_REGISTERS];
+    uint64_t flags;
+    uint64_t slot;                          // site number, return address on the way out
+} SIM_FRAME;
+
+void simAccessThunk(void);
+void simPatchedAccess(SIM_FRAME *frame);
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static REGION regions[REGION_COUNT] =
+{
+    {0x40000000, 0x00100000, 0x40000000, 0},    // APB and AHB peripherals, SYSCTL
+    {0x42000000, 0x02000000, 0x42000000, 0},    // bit-band alias of the peripherals
+    {0xE000E000, 0x00001000, 0xE000E000, 0},    // NVIC, SysTick, SCB
+    {0x00038000, 0x00008000, 0x00038000, 0}     // history area of the flash
+};
+
+static const SIM_DEVICE *devices[MAX_DEVICES];
+static uint8_t deviceCount = 0;
+static int inputs[MAX_INPUTS];
+static uint8_t inputCount = 0;
+
+static ACCESS pending;
+static uint32_t lastAddress = 0;
+static uint32_t lastValue = 0;
+static uint8_t repeats = 0;
+
+static SITE sites[MAX_SITES];
+static uint32_t siteCount = 0;
+static uint8_t *stubs;
+
+static uint64_t now = 0;
+static bool realTime = true;
+static struct timespec wallStart;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simFatal(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "sim: ");
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    exit(1);
+}
+
+// Region at a firmware address
+static REGION *findRegion(uint32_t address)
+{
+    uint8_t i;
+    for (i = 0; i < REGION_COUNT; i++)
+        if (address - regions[i].mapped < regions[i].size)
+            return &regions[i];
+    return 0;
+}
+
+static const SIM_DEVICE *findDevice(uint32_t address)
+{
+    static const SIM_DEVICE *last = 0;
+    uint8_t i;
+    if (last && address - last->base < last->size)
+        return last;
+    for (i = 0; i < deviceCount; i++)
+        if (address - devices[i]->base < devices[i]->size)
+            return last = devices[i];
+    return 0;
+}
+
+volatile uint32_t *simRegister(uint32_t address)
+{
+    REGION *r = findRegion(address);
+    if (!r || r == &regions[REGION_FLASH])
+        simFatal("no register at 0x%08X", address);
+    return (volatile uint32_t *)(r->view + (address - r->base));
+}
+
+uint8_t *simFlash(uint32_t address)
+{
+    return regions[REGION_FLASH].view + (address - regions[REGION_FLASH].base);
+}
+
+bool simIsFlash(uint32_t address)
+{
+    return address - regions[REGION_FLASH].base < regions[REGION_FLASH].size;
+}
+
+static uint32_t readRegister(uint32_t address, bool sideEffects)
+{
+    const SIM_DEVICE *d = findDevice(address);
+    if (d && d->read)
+        return d->read(d->context, address - d->base, sideEffects);
+    return *simRegister(address);
+}
+
+static void writeRegister(uint32_t address, uint32_t value)
+{
+    const SIM_DEVICE *d = findDevice(address);
+    if (d && d->write)
+        d->write(d->context, address - d->base, value);
+    else
+        *simRegister(address) = value;
+}
+
+void simAddDevice(const SIM_DEVICE *device)
+{
+    if (deviceCount == MAX_DEVICES)
+        simFatal("too many devices");
+    devices[deviceCount++] = device;
+}
+
+void simAddInput(int fd)
+{
+    if (inputCount == MAX_INPUTS)
+        simFatal("too many inputs");
+    inputs[inputCount++] = fd;
+}
+
+// Stops polling an input that reached end of file
+void simRemoveInput(int fd)
+{
+    uint8_t i;
+    for (i = 0; i < inputCount; i++)
+        if (inputs[i] == fd)
+            inputs[i] = -1;
+}
+
+//-----------------------------------------------------------------------------
+// Time
+//-----------------------------------------------------------------------------
+
+static uint64_t wallCycles(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)(t.tv_sec - wallStart.tv_sec) * SIM_CLOCK
+         + ((int64_t)t.tv_nsec - wallStart.tv_nsec) / (1000000000 / SIM_CLOCK);
+}
+
+static struct timespec toTimespec(uint64_t cycles)
+{
+    struct timespec t;
+    t.tv_sec = cycles / SIM_CLOCK;
+    t.tv_nsec = (cycles % SIM_CLOCK) * (1000000000 / SIM_CLOCK);
+    return t;
+}
+
+uint64_t simNow(void)
+{
+    return now;
+}
+
+void simSetRealTime(bool on)
+{
+    realTime = on;
+}
+
+static uint64_t nextEvent(void)
+{
+    uint64_t next = SIM_NEVER, t;
+    uint8_t i;
+    for (i = 0; i < deviceCount; i++)
+    {
+        if (devices[i]->nextEvent)
+        {
+            t = devices[i]->nextEvent(devices[i]->context);
+            if (t < next)
+                next = t;
+        }
+    }
+    return next;
+}
+
+// Keeps simulated time from running ahead of the wall clock
+static void pace(void)
+{
+    uint64_t wall;
+    struct timespec t;
+    if (!realTime)
+        return;
+    wall = wallCycles();
+    if (now > wall + PACE_SLACK)
+    {
+        t = toTimespec(now - wall);
+        nanosleep(&t, 0);
+    }
+}
+
+// Brings every device up to the current time and takes pending interrupts
+void simService(void)
+{
+    uint8_t i;
+    for (i = 0; i < deviceCount; i++)
+        if (devices[i]->update)
+            devices[i]->update(devices[i]->context, now);
+    simDispatch();
+}
+
+// Advances time, stopping at each device event on the way
+void simAdvance(uint64_t cycles)
+{
+    uint64_t target = now + cycles, next;
+    while (now < target)
+    {
+        next = nextEvent();
+        now = (next > now && next < target) ? next : target;
+        pace();
+        simService();
+    }
+}
+
+// Time the CPU cannot execute (flash operations), interrupts are taken afterwards
+void simStall(uint64_t cycles)
+{
+    now += cycles;
+    pace();
+}
+
+// The firmware is polling, skip to the next event or input
+void simIdle(void)
+{
+    uint64_t next = nextEvent(), wall, limit;
+    struct pollfd fds[MAX_INPUTS];
+    struct timespec t;
+    uint8_t i;
+
+    if (next <= now)
+    {
+        simService();
+        return;
+    }
+    if (!realTime)
+    {
+        if (next == SIM_NEVER)
+            simFatal("firmware is waiting and no event is pending");
+        now = next;
+        simService();
+        return;
+    }
+
+    for (i = 0; i < inputCount; i++)
+    {
+        fds[i].fd = inputs[i];
+        fds[i].events = POLLIN;
+    }
+    wall = wallCycles();
+    limit = (now > wall ? now : wall) + IDLE_LIMIT;
+    if (next < limit)
+        limit = next;
+    if (limit > wall)
+    {
+        t = toTimespec(limit - wall);
+        if (ppoll(fds, inputCount, &t, 0) < 0 && errno != EINTR)
+            simFatal("ppoll: %s", strerror(errno));
+        wall = wallCycles();
+    }
+    if (wall > next)
+        wall = next;
+    if (wall > now)
+        now = wall;
+    simService();
+}
+
+//-----------------------------------------------------------------------------
+// Register access emulation
+//-----------------------------------------------------------------------------
+
+static void protectPage(uint32_t address, int protection)
+{
+    if (mprotect((void *)(uintptr_t)(address & ~(PAGE_SIZE - 1)), PAGE_SIZE, protection) < 0)
+        simFatal("mprotect: %s", strerror(errno));
+}
+
+// A timed wait between two reads, so they are not a polling loop
+void simEndPoll(void)
+{
+    lastAddress = 0;
+    repeats = 0;
+}
+
+// Counts reads that repeat the previous access, a polling loop waits for an event
+// at each read once it is detected. The count is kept across the ISRs taken
+// here, so a poll resumes as a poll when they return.
+static void completeAccess(uint32_t address, bool write, uint32_t value)
+{
+    uint32_t savedAddress, savedValue;
+    uint8_t savedRepeats;
+
+    if (!write && address == lastAddress && value == lastValue)
+    {
+        if (repeats < SPIN_REPEATS)
+            repeats++;
+    }
+    else
+        repeats = 0;
+    savedAddress = lastAddress = write ? 0 : address;
+    savedValue = lastValue = value;
+    savedRepeats = repeats;
+
+    if (repeats == SPIN_REPEATS)
+        simIdle();
+    now += SIM_ACCESS_CYCLES;
+    simService();
+
+    lastAddress = savedAddress;
+    lastValue = savedValue;
+    repeats = savedRepeats;
+}
+
+// Decodes the ModRM memory operand, returns its length with the SIB and
+// displacement bytes
+static uint8_t decodeOperand(const uint8_t *modrm, uint8_t rex, MOVE *move)
+{
+    uint8_t mod = modrm[0] >> 6, rm = modrm[0] & 7, sib;
+    uint8_t length = 1;
+    int8_t disp8;
+
+    move->base = (rm | (rex & 1 ? 8 : 0));
+    move->index = NO_REGISTER;
+    move->scale = 0;
+    move->displacement = 0;
+    if (rm == 4)
+    {
+        sib = modrm[length++];
+        move->base = (sib & 7) | (rex & 1 ? 8 : 0);
+        move->index = ((sib >> 3) & 7) | (rex & 2 ? 8 : 0);
+        move->scale = sib >> 6;
+        if (move->index == 4)
+            move->index = NO_REGISTER;
+        if (mod == 0 && (sib & 7) == 5)
+            move->base = NO_REGISTER;
+    }
+    else if (mod == 0 && rm == 5)
+        move->base = RIP_REGISTER;
+    if (mod == 1)
+    {
+        memcpy(&disp8, modrm + length, 1);
+        move->displacement = disp8;
+        length += 1;
+    }
+    else if (mod == 2 || move->base == NO_REGISTER || move->base == RIP_REGISTER)
+    {
+        memcpy(&move->displacement, modrm + length, 4);
+        length += 4;
+    }
+    return length;
+}
+
+// Decodes the 32-bit moves compilers emit for volatile registers,
+// returns false if the instruction has to be single stepped
+static bool decodeMove(const uint8_t *ip, MOVE *move)
+{
+    uint8_t rex = 0, length = 0, modrm;
+    move->address32 = ip[length] == 0x67;
+    if (move->address32)
+        length++;
+    if ((ip[length] & 0xF0) == 0x40)
+        rex = ip[length++];
+    if (rex & 8)                            // REX.W, 64-bit operand
+        return false;
+    modrm = ip[length + 1];
+    if (ip[length] == 0x8B || ip[length] == 0x89)
+    {
+        move->write = ip[length] == 0x89;
+        move->immediate = false;
+        move->reg = ((modrm >> 3) & 7) | (rex & 4 ? 8 : 0);
+        move->length = length + 1 + decodeOperand(ip + length + 1, rex, move);
+        return move->reg != 4;
+    }
+    if (ip[length] == 0xC7 && ((modrm >> 3) & 7) == 0)
+    {
+        length += 1 + decodeOperand(ip + length + 1, rex, move);
+        move->write = true;
+        move->immediate = true;
+        memcpy(&move->value, ip + length, 4);
+        move->length = length + 4;
+        return true;
+    }
+    return false;
+}
+
+// Sets up pending for an access to address
+static void beginAccess(uint32_t address, REGION *r, bool write)
+{
+    pending.write = write;
+    pending.address = address;
+    pending.bitband = r == &regions[REGION_BITBAND];
+    if (pending.bitband)
+    {
+        pending.word = regions[REGION_PERIPHERAL].base + (((address - r->base) >> 5) & ~3);
+        pending.bit = ((address - r->base) >> 2) & 31;
+    }
+    else
+        pending.word = address & ~3;
+}
+
+// Writes a register or one bit of it through the bit-band alias
+static void writeAccess(uint32_t value)
+{
+    if (pending.bitband)
+    {
+        uint32_t word = readRegister(pending.word, false) & ~(1 << pending.bit);
+        writeRegister(pending.word, word | ((value & 1) << pending.bit));
+    }
+    else
+        writeRegister(pending.word, value);
+}
+
+// Performs a decoded move, reg is the register operand
+static void emulateMove(const MOVE *move, uint64_t *reg)
+{
+    uint32_t value;
+    if (move->write)
+    {
+        value = move->immediate ? move->value : (uint32_t)*reg;
+        writeAccess(value);
+    }
+    else
+    {
+        value = readRegister(pending.word, true);
+        if (pending.bitband)
+            value = (value >> pending.bit) & 1;
+        *reg = value;                       // 32-bit loads zero extend
+    }
+    completeAccess(pending.address, move->write, value);
+}
+
+//-----------------------------------------------------------------------------
+// Access site patching
+//-----------------------------------------------------------------------------
+
+// A move to a fixed register address is patched into a jump to a stub that
+// pushes its site number and enters simAccessThunk (simthunk.S). The thunk
+// saves the CPU state in a SIM_FRAME and calls simPatchedAccess(), which
+// emulates the move and points the return slot past it. Later accesses from
+// the site cost a call instead of a fault.
+
+static void patchSite(uint8_t *ip, const MOVE *move)
+{
+    uint8_t *stub = stubs + siteCount * STUB_SIZE;
+    uintptr_t page = (uintptr_t)ip & ~(uintptr_t)(PAGE_SIZE - 1);
+    int32_t offset;
+
+    if (move->length < 5 || move->base == RIP_REGISTER || move->base == 4 || siteCount == MAX_SITES)
+        return;
+    sites[siteCount].move = *move;
+    sites[siteCount].resume = (uintptr_t)ip + move->length;
+
+    stub[0] = 0x68;                         // push imm32
+    memcpy(stub + 1, &siteCount, 4);
+    stub[5] = 0xE9;                         // jmp rel32
+    offset = (int32_t)((uintptr_t)simAccessThunk - (uintptr_t)(stub + 10));
+    memcpy(stub + 6, &offset, 4);
+
+    if (mprotect((void *)page, PAGE_SIZE * 2, PROT_READ | PROT_WRITE | PROT_EXEC) < 0)
+        return;
+    offset = (int32_t)((uintptr_t)stub - (uintptr_t)(ip + 5));
+    ip[0] = 0xE9;
+    memcpy(ip + 1, &offset, 4);
+    memset(ip + 5, 0x90, move->length - 5); // nop
+    mprotect((void *)page, PAGE_SIZE * 2, PROT_READ | PROT_EXEC);
+    siteCount++;
+}
+
+void simPatchedAccess(SIM_FRAME *frame)
+{
+    static const uint8_t registers[16] =
+    {
+        FRAME_RAX, FRAME_RCX, FRAME_RDX, FRAME_RBX, 0, FRAME_RBP, FRAME_RSI, FRAME_RDI,
+        FRAME_R8, FRAME_R9, FRAME_R10, FRAME_R11, FRAME_R12, FRAME_R13, FRAME_R14, FRAME_R15
+    };
+    const SITE *site = &sites[frame->slot];
+    const MOVE *move = &site->move;
+    uint64_t address = move->displacement;
+    REGION *r;
+
+    frame->slot = site->resume;
+    if (move->base != NO_REGISTER)
+        address += frame->registers[registers[move->base]];
+    if (move->index != NO_REGISTER)
+        address += frame->registers[registers[move->index]] << move->scale;
+    if (move->address32)
+        address = (uint32_t)address;
+    r = findRegion(address);
+    if (!r || address > UINT32_MAX || r == &regions[REGION_FLASH])
+        simFatal("patched access to 0x%lx is not a register", (unsigned long)address);
+    beginAccess(address, r, move->write);
+    emulateMove(move, &frame->registers[registers[move->reg]]);
+}
+
+//-----------------------------------------------------------------------------
+// Fault handling
+//-----------------------------------------------------------------------------
+
+// Fault on a mapped out register: emulate a plain move, or stage the value
+// and single step anything else
+static void onFault(int signal, siginfo_t *info, void *context)
+{
+    static const uint8_t registers[16] =
+    {
+        REG_RAX, REG_RCX, REG_RDX, REG_RBX, REG_RSP, REG_RBP, REG_RSI, REG_RDI,
+        REG_R8, REG_R9, REG_R10, REG_R11, REG_R12, REG_R13, REG_R14, REG_R15
+    };
+    ucontext_t *uc = context;
+    uint8_t *ip = (uint8_t *)uc->uc_mcontext.gregs[REG_RIP];
+    uint32_t address = (uint32_t)(uintptr_t)info->si_addr;
+    REGION *r = findRegion(address);
+    uint32_t value;
+    MOVE move;
+    (void)signal;
+
+    if (!r || (uintptr_t)info->si_addr > UINT32_MAX || pending.pending)
+    {
+        fprintf(stderr, "sim: segmentation fault at %p\n", info->si_addr);
+        abort();
+    }
+    if (r == &regions[REGION_FLASH])
+        simFatal("firmware wrote flash at 0x%08X without the flash controller", address);
+
+    beginAccess(address, r, uc->uc_mcontext.gregs[REG_ERR] & 2);
+    if (decodeMove(ip, &move) && move.write == pending.write)
+    {
+        uc->uc_mcontext.gregs[REG_RIP] += move.length;
+        patchSite(ip, &move);
+        emulateMove(&move, (uint64_t *)&uc->uc_mcontext.gregs[registers[move.reg]]);
+        return;
+    }
+
+    pending.pending = true;
+    value = readRegister(pending.word, !pending.write);
+    pending.staged = pending.bitband ? (value >> pending.bit) & 1 : value;
+    *simRegister(address & ~3) = pending.staged;
+
+    protectPage(address, PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= TRAP_FLAG;
+}
+
+// The access instruction has run: map the page out and apply a write
+static void onStep(int signal, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = context;
+    uint32_t value;
+    (void)signal;
+    (void)info;
+
+    if (!pending.pending)
+        return;
+    uc->uc_mcontext.gregs[REG_EFL] &= ~TRAP_FLAG;
+    protectPage(pending.address, PROT_NONE);
+    pending.pending = false;
+
+    value = *simRegister(pending.address & ~3);
+    if (pending.write)
+    {
+        *simRegister(pending.address & ~3) = pending.staged;   // the model decides what is stored
+        writeAccess(value);
+    }
+    completeAccess(pending.address, pending.write, value);
+}
+
+static void mapRegion(REGION *r, int fd, int protection)
+{
+    void *p;
+    r->view = mmap(0, r->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (r->view == MAP_FAILED)
+        simFatal("mmap: %s", strerror(errno));
+    p = mmap((void *)(uintptr_t)r->mapped, r->size, protection, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    if (p != (void *)(uintptr_t)r->mapped)
+        simFatal("cannot map 0x%08X: %s", r->mapped, strerror(errno));
+}
+
+// Simulates size bytes of flash from base instead of the history area, mapped
+// at mapped for the firmware. The start of the flash cannot be mapped at its
+// own address on the host. Called before simInit().
+void simSetFlash(uint32_t base, uint32_t size, uint32_t mapped)
+{
+    regions[REGION_FLASH].base = base;
+    regions[REGION_FLASH].size = size;
+    regions[REGION_FLASH].mapped = mapped;
+}
+
+// Maps the register regions out and the flash from flashPath
+void simInit(const char *flashPath)
+{
+    struct sigaction action;
+    int fd;
+    uint8_t i;
+    bool created;
+
+    for (i = 0; i < REGION_COUNT; i++)
+    {
+        if (i == REGION_FLASH)
+            continue;
+        fd = memfd_create("tm4c123", 0);
+        if (fd < 0 || ftruncate(fd, regions[i].size) < 0)
+            simFatal("memfd: %s", strerror(errno));
+        mapRegion(&regions[i], fd, PROT_NONE);
+        close(fd);
+    }
+
+    fd = open(flashPath, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        simFatal("%s: %s", flashPath, strerror(errno));
+    created = lseek(fd, 0, SEEK_END) == 0;
+    if (ftruncate(fd, regions[REGION_FLASH].size) < 0)
+        simFatal("%s: %s", flashPath, strerror(errno));
+    mapRegion(&regions[REGION_FLASH], fd, PROT_READ);
+    if (created)
+        memset(regions[REGION_FLASH].view, 0xFF, regions[REGION_FLASH].size);   // erased
+    close(fd);
+
+    stubs = mmap((void *)STUB_BASE, MAX_SITES * STUB_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (stubs != (void *)STUB_BASE)
+        simFatal("cannot map stubs: %s", strerror(errno));
+
+    memset(&action, 0, sizeof(action));
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;      // ISRs run in the handler and fault again
+    action.sa_sigaction = onFault;
+    sigaction(SIGSEGV, &action, 0);
+    action.sa_sigaction = onStep;
+    sigaction(SIGTRAP, &action, 0);
+
+    clock_gettime(CLOCK_MONOTONIC, &wallStart);
+}
+
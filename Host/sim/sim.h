@@ -0,0 +1,65 @@
+// TM4C123GH6PM peripheral simulator core
+
+// The firmware runs natively with its register addresses mapped PROT_NONE.
+// Each access faults and the simulator hands the value to or from the
+// peripheral model. Plain 32-bit moves are emulated and their instruction is
+// patched into a call, so later accesses from it do not fault, anything else
+// is single stepped with the page mapped in. Interrupts are dispatched by
+// simNvic between register accesses, so ISRs preempt the firmware at the same
+// points a real CPU could.
+
+// Time is counted in system clocks (40 MHz). Register accesses and waits
+// advance it, when the firmware spins on a status register it jumps to the
+// next device event. Real time mode then sleeps until the wall clock catches
+// up, so the firmware runs at its real pace with cycle exact timers. Virtual
+// time mode (simSetRealTime(false)) never waits, a run is deterministic.
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_CLOCK           40000000
+#define SIM_ACCESS_CYCLES   10              // charged per register access
+#define SIM_NEVER           UINT64_MAX
+
+// Memory mapped peripheral model, hooks may be 0
+// Registers without a read or write hook are plain storage (simRegister())
+typedef struct _SIM_DEVICE
+{
+    const char *name;
+    uint32_t base;
+    uint32_t size;
+    void *context;
+    uint32_t (*read)(void *context, uint32_t offset, bool sideEffects);
+    void (*write)(void *context, uint32_t offset, uint32_t value);
+    void (*update)(void *context, uint64_t now);    // latches events up to now
+    uint64_t (*nextEvent)(void *context);           // time of the next event, SIM_NEVER if none
+} SIM_DEVICE;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simSetFlash(uint32_t base, uint32_t size, uint32_t mapped);
+void simInit(const char *flashPath);
+void simAddDevice(const SIM_DEVICE *device);
+void simAddInput(int fd);
+void simRemoveInput(int fd);
+
+volatile uint32_t *simRegister(uint32_t address);
+uint8_t *simFlash(uint32_t address);
+bool simIsFlash(uint32_t address);
+
+uint64_t simNow(void);
+void simAdvance(uint64_t cycles);
+void simStall(uint64_t cycles);
+void simService(void);
+void simIdle(void);
+void simEndPoll(void);
+void simSetRealTime(bool on);
+
+void simFatal(const char *format, ...);
+
+#endif
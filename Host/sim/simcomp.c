@@ -0,0 +1,109 @@
+// Analog comparator model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+#include "simgpio.h"
+#include "simplant.h"
+#include "simcomp.h"
+
+#define COMP_BASE       0x4003C000
+#define OFS_ACMIS       0x000
+#define OFS_ACRIS       0x004
+#define OFS_ACINTEN     0x008
+#define OFS_ACSTAT0     0x020
+
+#define DISH_PORT       SIM_PORTD
+#define DISH_PIN        1
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint64_t trip = SIM_NEVER;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(ofs) (*simRegister(COMP_BASE + (ofs)))
+
+static void updateIrq(void)
+{
+    simSetIrq(INT_COMP0, REG(OFS_ACRIS) & REG(OFS_ACINTEN) & COMP_ACRIS_IN0);
+}
+
+static void updateComp(void *context, uint64_t now)
+{
+    (void)context;
+    if (trip <= now)
+    {
+        REG(OFS_ACRIS) |= COMP_ACRIS_IN0;
+        REG(OFS_ACSTAT0) |= COMP_ACSTAT0_OVAL;
+        trip = SIM_NEVER;
+    }
+    updateIrq();
+}
+
+static uint64_t getNextCompEvent(void *context)
+{
+    (void)context;
+    return trip;
+}
+
+static uint32_t readComp(void *context, uint32_t offset, bool sideEffects)
+{
+    (void)context;
+    (void)sideEffects;
+    if (offset == OFS_ACMIS)
+        return REG(OFS_ACRIS) & REG(OFS_ACINTEN);
+    return REG(offset);
+}
+
+static void writeComp(void *context, uint32_t offset, uint32_t value)
+{
+    (void)context;
+    switch (offset)
+    {
+        case OFS_ACMIS:
+            REG(OFS_ACRIS) &= ~value;
+            break;
+        case OFS_ACRIS:
+        case OFS_ACSTAT0:
+            return;
+        default:
+            REG(offset) = value;
+    }
+    updateIrq();
+}
+
+// DISH high discharges the sensor, low lets it charge
+static void onDish(SIM_PORT port, uint8_t pin, bool value)
+{
+    (void)port;
+    (void)pin;
+    if (value)
+    {
+        trip = SIM_NEVER;
+        REG(OFS_ACSTAT0) &= ~COMP_ACSTAT0_OVAL;
+    }
+    else
+        trip = simNow() + simGetPlantChargeCycles();
+}
+
+static const SIM_DEVICE comp =
+{
+    "COMP", COMP_BASE, 0x1000, 0, readComp, writeComp, updateComp, getNextCompEvent
+};
+
+void simInitComp(void)
+{
+    simWatchPin(DISH_PORT, DISH_PIN, onDish);
+    simAddDevice(&comp);
+}
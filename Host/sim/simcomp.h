@@ -0,0 +1,15 @@
+// Analog comparator model
+
+// Comparator 0 trips once the sensor has charged, which starts when DISH
+// (PD1) goes low, the delay comes from the water bowl model.
+
+#ifndef SIMCOMP_H_
+#define SIMCOMP_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitComp(void);
+
+#endif
@@ -0,0 +1,109 @@
+// EEPROM model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "sim.h"
+#include "simeeprom.h"
+
+#define EEPROM_BASE     0x400AF000
+#define OFS_EESIZE      0x000
+#define OFS_EEBLOCK     0x004
+#define OFS_EEOFFSET    0x008
+#define OFS_EERDWR      0x010
+#define OFS_EERDWRINC   0x014
+#define OFS_EEDONE      0x018
+
+#define EEPROM_WORDS    512
+#define EEPROM_BLOCKS   32
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint32_t *words;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(ofs) (*simRegister(EEPROM_BASE + (ofs)))
+
+static uint32_t *getWord(void)
+{
+    return &words[(REG(OFS_EEBLOCK) % EEPROM_BLOCKS) * 16 + (REG(OFS_EEOFFSET) & 15)];
+}
+
+static void increment(void)
+{
+    REG(OFS_EEOFFSET) = (REG(OFS_EEOFFSET) + 1) & 15;
+}
+
+static uint32_t readEepromRegister(void *context, uint32_t offset, bool sideEffects)
+{
+    uint32_t value;
+    (void)context;
+    switch (offset)
+    {
+        case OFS_EESIZE:
+            return (EEPROM_BLOCKS << 16) | EEPROM_WORDS;
+        case OFS_EERDWR:
+            return *getWord();
+        case OFS_EERDWRINC:
+            value = *getWord();
+            if (sideEffects)
+                increment();
+            return value;
+        case OFS_EEDONE:
+            return 0;                               // never busy
+    }
+    return REG(offset);
+}
+
+static void writeEepromRegister(void *context, uint32_t offset, uint32_t value)
+{
+    (void)context;
+    switch (offset)
+    {
+        case OFS_EERDWR:
+            *getWord() = value;
+            return;
+        case OFS_EERDWRINC:
+            *getWord() = value;
+            increment();
+            return;
+    }
+    REG(offset) = value;
+}
+
+static const SIM_DEVICE eeprom =
+{
+    "EEPROM", EEPROM_BASE, 0x1000, 0, readEepromRegister, writeEepromRegister, 0, 0
+};
+
+// A new file starts erased (all ones)
+void simInitEeprom(const char *path)
+{
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    bool created;
+    if (fd < 0)
+        simFatal("%s: %s", path, strerror(errno));
+    created = lseek(fd, 0, SEEK_END) == 0;
+    if (ftruncate(fd, EEPROM_WORDS * 4) < 0)
+        simFatal("%s: %s", path, strerror(errno));
+    words = mmap(0, EEPROM_WORDS * 4, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (words == MAP_FAILED)
+        simFatal("%s: %s", path, strerror(errno));
+    close(fd);
+    if (created)
+        memset(words, 0xFF, EEPROM_WORDS * 4);
+    simAddDevice(&eeprom);
+}
@@ -0,0 +1,14 @@
+// EEPROM model
+
+// 2 KB in 32 blocks of 16 words, kept in a file so settings survive runs
+
+#ifndef SIMEEPROM_H_
+#define SIMEEPROM_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitEeprom(const char *path);
+
+#endif
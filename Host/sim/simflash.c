@@ -0,0 +1,85 @@
+// Flash controller model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simflash.h"
+
+#define FLASH_BASE      0x400FD000
+#define OFS_FMA         0x000
+#define OFS_FMD         0x004
+#define OFS_FMC         0x008
+#define OFS_FCRIS       0x00C
+#define OFS_FCMISC      0x014
+
+#define PAGE_SIZE       1024
+#define WRITE_CYCLES    (SIM_CLOCK / 1000000 * 50)  // 50 us per word
+#define ERASE_CYCLES    (SIM_CLOCK / 1000 * 15)     // 15 ms per page
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(ofs) (*simRegister(FLASH_BASE + (ofs)))
+
+static void writeFlashRegister(void *context, uint32_t offset, uint32_t value)
+{
+    uint32_t address = REG(OFS_FMA);
+    uint32_t *word;
+    (void)context;
+    switch (offset)
+    {
+        case OFS_FMC:
+            if ((value & 0xFFFF0000) != FLASH_FMC_WRKEY)
+                return;
+            if (value & FLASH_FMC_WRITE)
+            {
+                if (!simIsFlash(address) || (address & 3))
+                    REG(OFS_FCRIS) |= FLASH_FCRIS_ARIS;
+                else
+                {
+                    word = (uint32_t *)simFlash(address);
+                    *word &= REG(OFS_FMD);              // programming only clears bits
+                    REG(OFS_FCRIS) |= FLASH_FCRIS_PRIS;
+                    simStall(WRITE_CYCLES);
+                }
+            }
+            else if (value & FLASH_FMC_ERASE)
+            {
+                address &= ~(PAGE_SIZE - 1);
+                if (!simIsFlash(address))
+                    REG(OFS_FCRIS) |= FLASH_FCRIS_ARIS;
+                else
+                {
+                    memset(simFlash(address), 0xFF, PAGE_SIZE);
+                    REG(OFS_FCRIS) |= FLASH_FCRIS_ERIS;
+                    simStall(ERASE_CYCLES);
+                }
+            }
+            else if (value & FLASH_FMC_MERASE)
+                REG(OFS_FCRIS) |= FLASH_FCRIS_ARIS;     // would erase the firmware
+            return;                                     // FMC reads 0, the operation is done
+        case OFS_FCMISC:
+            REG(OFS_FCRIS) &= ~value;
+            return;
+        case OFS_FCRIS:
+            return;
+    }
+    REG(offset) = value;
+}
+
+static const SIM_DEVICE flash =
+{
+    "FLASH", FLASH_BASE, 0x1000, 0, 0, writeFlashRegister, 0, 0
+};
+
+void simInitFlash(void)
+{
+    simAddDevice(&flash);
+}
@@ -0,0 +1,16 @@
+// Flash controller model
+
+// Word programming (clears bits) and 1 KB page erase through FMA, FMD and
+// FMC. Only the history area mapped by simInit() can be changed, other
+// addresses raise the access violation flag.
+
+#ifndef SIMFLASH_H_
+#define SIMFLASH_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitFlash(void);
+
+#endif
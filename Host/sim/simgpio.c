@@ -0,0 +1,176 @@
+// GPIO model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+#include "simgpio.h"
+
+#define OFS_DIR     0x400
+#define OFS_IS      0x404
+#define OFS_IBE     0x408
+#define OFS_IEV     0x40C
+#define OFS_IM      0x410
+#define OFS_RIS     0x414
+#define OFS_MIS     0x418
+#define OFS_ICR     0x41C
+#define OFS_LOCK    0x520
+#define OFS_END     0x1000
+
+#define MAX_WATCHERS 16
+
+typedef struct _PORT_STATE
+{
+    uint32_t apb;
+    uint32_t ahb;
+    uint8_t vector;
+    uint8_t input;                          // external pin levels
+    uint32_t registers[OFS_END / 4];        // shared by both apertures
+    SIM_DEVICE devices[2];
+} PORT_STATE;
+
+typedef struct _WATCHER
+{
+    SIM_PORT port;
+    uint8_t pin;
+    SIM_PIN_WATCHER callback;
+} WATCHER;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static PORT_STATE ports[SIM_PORT_COUNT] =
+{
+    {0x40004000, 0x40058000, INT_GPIOA},
+    {0x40005000, 0x40059000, INT_GPIOB},
+    {0x40006000, 0x4005A000, INT_GPIOC},
+    {0x40007000, 0x4005B000, INT_GPIOD},
+    {0x40024000, 0x4005C000, INT_GPIOE},
+    {0x40025000, 0x4005D000, INT_GPIOF}
+};
+
+static WATCHER watchers[MAX_WATCHERS];
+static uint8_t watcherCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(p, ofs) ((p)->registers[(ofs) / 4])
+
+static uint8_t getPins(PORT_STATE *p)
+{
+    uint8_t dir = REG(p, OFS_DIR);
+    return (REG(p, 0x3FC) & dir) | (p->input & ~dir);
+}
+
+static void updateIrq(PORT_STATE *p)
+{
+    simSetIrq(p->vector, REG(p, OFS_RIS) & REG(p, OFS_IM) & 0xFF);
+}
+
+// Latches edges and levels on the pins in changed, pins are the new levels
+static void detect(PORT_STATE *p, uint8_t changed, uint8_t pins)
+{
+    uint8_t level = REG(p, OFS_IS);
+    uint8_t both = REG(p, OFS_IBE);
+    uint8_t rising = REG(p, OFS_IEV);
+    uint8_t edges = changed & ~level & (both | (rising & pins) | (~rising & ~pins));
+    REG(p, OFS_RIS) |= edges | (level & ~(pins ^ rising));
+    updateIrq(p);
+}
+
+static void notify(PORT_STATE *p, uint8_t changed, uint8_t pins)
+{
+    uint8_t i;
+    for (i = 0; i < watcherCount; i++)
+        if (&ports[watchers[i].port] == p && (changed >> watchers[i].pin) & 1)
+            watchers[i].callback(watchers[i].port, watchers[i].pin, (pins >> watchers[i].pin) & 1);
+}
+
+static uint32_t readPort(void *context, uint32_t offset, bool sideEffects)
+{
+    PORT_STATE *p = context;
+    (void)sideEffects;
+    if (offset < OFS_DIR)
+        return getPins(p) & (offset >> 2);          // address bits 9:2 mask the data
+    if (offset == OFS_MIS)
+        return REG(p, OFS_RIS) & REG(p, OFS_IM);
+    if (offset == OFS_LOCK)
+        return 0;                                   // unlocked
+    return REG(p, offset);
+}
+
+static void writePort(void *context, uint32_t offset, uint32_t value)
+{
+    PORT_STATE *p = context;
+    uint8_t before = getPins(p), outputs = REG(p, 0x3FC) & REG(p, OFS_DIR), mask, after;
+    if (offset < OFS_DIR)
+    {
+        mask = offset >> 2;
+        REG(p, 0x3FC) = (REG(p, 0x3FC) & ~mask) | (value & mask);
+    }
+    else if (offset == OFS_ICR)
+        REG(p, OFS_RIS) &= ~value;
+    else if (offset != OFS_RIS && offset != OFS_MIS)
+        REG(p, offset) = value;
+
+    after = getPins(p);
+    if (after != before)
+        detect(p, after ^ before, after);
+    if ((REG(p, 0x3FC) & REG(p, OFS_DIR)) != outputs)
+        notify(p, (REG(p, 0x3FC) & REG(p, OFS_DIR)) ^ outputs, after);
+    updateIrq(p);
+}
+
+void simInitGpio(void)
+{
+    uint8_t i, j;
+    for (i = 0; i < SIM_PORT_COUNT; i++)
+    {
+        PORT_STATE *p = &ports[i];
+        for (j = 0; j < 2; j++)
+        {
+            SIM_DEVICE *d = &p->devices[j];
+            d->name = "GPIO";
+            d->base = j ? p->ahb : p->apb;
+            d->size = OFS_END;
+            d->context = p;
+            d->read = readPort;
+            d->write = writePort;
+            simAddDevice(d);
+        }
+    }
+}
+
+void simSetPinInput(SIM_PORT port, uint8_t pin, bool value)
+{
+    PORT_STATE *p = &ports[port];
+    uint8_t before = getPins(p), after;
+    p->input = (p->input & ~(1 << pin)) | (value << pin);
+    after = getPins(p);
+    if (after != before)
+        detect(p, after ^ before, after);
+}
+
+bool simGetPinOutput(SIM_PORT port, uint8_t pin)
+{
+    PORT_STATE *p = &ports[port];
+    return (REG(p, 0x3FC) & REG(p, OFS_DIR)) >> pin & 1;
+}
+
+void simWatchPin(SIM_PORT port, uint8_t pin, SIM_PIN_WATCHER watcher)
+{
+    if (watcherCount == MAX_WATCHERS)
+        simFatal("too many pin watchers");
+    watchers[watcherCount].port = port;
+    watchers[watcherCount].pin = pin;
+    watchers[watcherCount].callback = watcher;
+    watcherCount++;
+}
@@ -0,0 +1,30 @@
+// GPIO model
+
+// Ports A-F on both the APB and AHB apertures. Pins read back the output
+// latch when they are outputs and the external level set by simSetPinInput()
+// when they are inputs. Output changes are reported to watchers.
+
+#ifndef SIMGPIO_H_
+#define SIMGPIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum _SIM_PORT
+{
+    SIM_PORTA, SIM_PORTB, SIM_PORTC, SIM_PORTD, SIM_PORTE, SIM_PORTF, SIM_PORT_COUNT
+} SIM_PORT;
+
+// Called when an output pin changes level
+typedef void (*SIM_PIN_WATCHER)(SIM_PORT port, uint8_t pin, bool value);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitGpio(void);
+void simSetPinInput(SIM_PORT port, uint8_t pin, bool value);
+bool simGetPinOutput(SIM_PORT port, uint8_t pin);
+void simWatchPin(SIM_PORT port, uint8_t pin, SIM_PIN_WATCHER watcher);
+
+#endif
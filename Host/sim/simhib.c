@@ -0,0 +1,165 @@
+// Hibernation module RTC model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+#include "simhib.h"
+#include "simtrace.h"
+
+#define HIB_BASE        0x400FC000
+#define OFS_RTCC        0x000
+#define OFS_RTCM0       0x004
+#define OFS_RTCLD       0x00C
+#define OFS_CTL         0x010
+#define OFS_IM          0x014
+#define OFS_RIS         0x018
+#define OFS_MIS         0x01C
+#define OFS_IC          0x020
+#define OFS_RTCSS       0x028
+
+#define RTC_CLOCK       32768
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint64_t baseTicks = 0;              // counter in 1/32768 s at baseTime
+static uint64_t baseTime = 0;
+static bool running = false;
+static uint64_t checked = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(ofs) (*simRegister(HIB_BASE + (ofs)))
+
+static uint64_t getTicks(uint64_t now)
+{
+    if (!running)
+        return baseTicks;
+    return baseTicks + (unsigned __int128)(now - baseTime) * RTC_CLOCK / SIM_CLOCK;
+}
+
+// Time the counter reaches ticks
+static uint64_t getTickTime(uint64_t ticks)
+{
+    if (!running || ticks < baseTicks)
+        return SIM_NEVER;
+    return baseTime + ((unsigned __int128)(ticks - baseTicks) * SIM_CLOCK + RTC_CLOCK - 1) / RTC_CLOCK;
+}
+
+// Match 0 at subsecond 0 of RTCM0
+static uint64_t getNextAlarm(void)
+{
+    uint64_t t = getTickTime((uint64_t)REG(OFS_RTCM0) * RTC_CLOCK);
+    return t > checked ? t : SIM_NEVER;
+}
+
+static void updateIrq(void)
+{
+    simSetIrq(INT_HIBERNATE, REG(OFS_RIS) & REG(OFS_IM));
+}
+
+static void updateHib(void *context, uint64_t now)
+{
+    (void)context;
+    if (getNextAlarm() <= now)
+        REG(OFS_RIS) |= HIB_RIS_RTCALT0;
+    checked = now;
+    updateIrq();
+}
+
+static uint64_t getNextHibEvent(void *context)
+{
+    (void)context;
+    return REG(OFS_IM) & HIB_RIS_RTCALT0 ? getNextAlarm() : SIM_NEVER;
+}
+
+static uint32_t readHib(void *context, uint32_t offset, bool sideEffects)
+{
+    uint64_t ticks = getTicks(simNow());
+    (void)context;
+    (void)sideEffects;
+    switch (offset)
+    {
+        case OFS_RTCC:
+            return ticks / RTC_CLOCK;
+        case OFS_RTCSS:
+            return (REG(OFS_RTCSS) & ~HIB_RTCSS_RTCSSC_M) | (ticks % RTC_CLOCK);
+        case OFS_CTL:
+            return REG(OFS_CTL) | HIB_CTL_WRC;       // writes complete at once
+        case OFS_MIS:
+            return REG(OFS_RIS) & REG(OFS_IM);
+    }
+    return REG(offset);
+}
+
+static void traceAlarm(uint32_t seconds)
+{
+    char time[24];
+    if (seconds == 0xFFFFFFFF)
+    {
+        simTrace("alarm none");
+        return;
+    }
+    simFormatTime(time, seconds);
+    simTrace("alarm %s", time);
+}
+
+static void writeHib(void *context, uint32_t offset, uint32_t value)
+{
+    uint64_t now = simNow();
+    (void)context;
+    switch (offset)
+    {
+        case OFS_RTCLD:
+            baseTicks = (uint64_t)value * RTC_CLOCK;
+            baseTime = checked = now;
+            return;
+        case OFS_CTL:
+            if ((value & HIB_CTL_RTCEN) != running)
+            {
+                baseTicks = getTicks(now);
+                baseTime = checked = now;
+                running = value & HIB_CTL_RTCEN;
+            }
+            break;
+        case OFS_RTCM0:
+            traceAlarm(value);
+            break;
+        case OFS_IC:
+            REG(OFS_RIS) &= ~value;
+            updateIrq();
+            return;
+        case OFS_RTCC:
+        case OFS_RIS:
+        case OFS_MIS:
+            return;
+    }
+    REG(offset) = value;
+    updateIrq();
+}
+
+static const SIM_DEVICE hib =
+{
+    "HIB", HIB_BASE, 0x1000, 0, readHib, writeHib, updateHib, getNextHibEvent
+};
+
+// The RTC keeps its count through a reset, seconds is the count at power up
+void simInitHib(uint32_t seconds)
+{
+    baseTicks = (uint64_t)seconds * RTC_CLOCK;
+    simAddDevice(&hib);
+}
+
+uint32_t simGetRtcSeconds(void)
+{
+    return getTicks(simNow()) / RTC_CLOCK;
+}
@@ -0,0 +1,18 @@
+// Hibernation module RTC model
+
+// 32.768 kHz counter with seconds (RTCC), subseconds (RTCSS), load and
+// match 0. The counter runs from the simulator clock.
+
+#ifndef SIMHIB_H_
+#define SIMHIB_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitHib(uint32_t seconds);
+uint32_t simGetRtcSeconds(void);
+
+#endif
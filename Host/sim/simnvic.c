@@ -0,0 +1,209 @@
+// NVIC model
+// SysTick counts at the system clock while enabled, its interrupt is not modelled
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ti_host.h"
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+
+#define NVIC_BASE       0xE000E000
+#define NVIC_WORDS      5                   // 139 interrupts
+#define OFS_ST_CTRL     0x010
+#define OFS_ST_RELOAD   0x014
+#define OFS_ST_CURRENT  0x018
+#define OFS_EN          0x100
+#define OFS_DIS         0x180
+#define OFS_PEND        0x200
+#define OFS_UNPEND      0x280
+#define OFS_ACTIVE      0x300
+#define OFS_PRI         0x400
+#define OFS_VTOR        0xD08
+#define OFS_SWTRIG      0xF00
+
+#define THREAD_PRIORITY 0x100               // below every exception priority
+
+typedef void (*ISR)(void);
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+extern void (* const g_pfnVectors[])(void);
+
+static uint32_t enabled[NVIC_WORDS];
+static uint32_t pending[NVIC_WORDS];        // set by software, lines are level sensitive
+static uint32_t lines[NVIC_WORDS];
+static uint32_t active[NVIC_WORDS];
+static uint32_t primask = 0;
+static uint32_t basepri = 0;
+static uint32_t runningPriority = THREAD_PRIORITY;
+static uint8_t activeVector = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint32_t *bank(uint32_t offset, uint32_t first, uint32_t *words)
+{
+    if (offset >= first && offset < first + NVIC_WORDS * 4)
+        return &words[(offset - first) / 4];
+    return 0;
+}
+
+static uint32_t readNvic(void *context, uint32_t offset, bool sideEffects)
+{
+    uint32_t *p, reload;
+    (void)context;
+    (void)sideEffects;
+    if ((p = bank(offset, OFS_EN, enabled)) || (p = bank(offset, OFS_DIS, enabled))
+        || (p = bank(offset, OFS_ACTIVE, active)))
+        return *p;
+    if ((p = bank(offset, OFS_PEND, pending)) || (p = bank(offset, OFS_UNPEND, pending)))
+        return *p | (lines[p - pending] & ~active[p - pending]);
+    if (offset == OFS_ST_CURRENT && (*simRegister(NVIC_BASE + OFS_ST_CTRL) & NVIC_ST_CTRL_ENABLE))
+    {
+        reload = *simRegister(NVIC_BASE + OFS_ST_RELOAD) & 0x00FFFFFF;
+        return reload - simNow() % (reload + 1);
+    }
+    return *simRegister(NVIC_BASE + offset);
+}
+
+static void writeNvic(void *context, uint32_t offset, uint32_t value)
+{
+    uint32_t *p;
+    (void)context;
+    if ((p = bank(offset, OFS_EN, enabled)) || (p = bank(offset, OFS_PEND, pending)))
+        *p |= value;
+    else if ((p = bank(offset, OFS_DIS, enabled)) || (p = bank(offset, OFS_UNPEND, pending)))
+        *p &= ~value;
+    else if (offset == OFS_SWTRIG && value < NVIC_WORDS * 32)
+        pending[value / 32] |= 1 << (value % 32);
+    else if (!bank(offset, OFS_ACTIVE, active))
+        *simRegister(NVIC_BASE + offset) = value;
+}
+
+static const SIM_DEVICE nvic =
+{
+    "NVIC", NVIC_BASE, 0x1000, 0, readNvic, writeNvic, 0, 0
+};
+
+void simInitNvic(void)
+{
+    *simRegister(NVIC_BASE + OFS_VTOR) = (uint32_t)(uintptr_t)g_pfnVectors;
+    simAddDevice(&nvic);
+}
+
+void simSetIrq(uint8_t vector, bool level)
+{
+    uint8_t irq = vector - 16;
+    if (level)
+        lines[irq / 32] |= 1 << (irq % 32);
+    else
+        lines[irq / 32] &= ~(1 << (irq % 32));
+}
+
+// Vector of the running ISR, 0 in thread mode
+uint8_t simActiveVector(void)
+{
+    return activeVector;
+}
+
+static uint8_t getPriority(uint8_t irq)
+{
+    return ((volatile uint8_t *)simRegister(NVIC_BASE + OFS_PRI))[irq] & 0xE0;
+}
+
+// Takes pending interrupts above the running priority, highest first
+void simDispatch(void)
+{
+    uint32_t threshold, candidates, savedPriority;
+    uint8_t word, bit, irq, best, bestPriority, savedVector;
+    ISR isr;
+
+    while (!primask)
+    {
+        threshold = runningPriority;
+        if (basepri && basepri < threshold)
+            threshold = basepri;
+        best = 0xFF;
+        bestPriority = 0xFF;
+        for (word = 0; word < NVIC_WORDS; word++)
+        {
+            candidates = enabled[word] & (pending[word] | lines[word]) & ~active[word];
+            while (candidates)
+            {
+                bit = __builtin_ctz(candidates);
+                candidates &= candidates - 1;
+                irq = word * 32 + bit;
+                if (getPriority(irq) < threshold && (best == 0xFF || getPriority(irq) < bestPriority))
+                {
+                    best = irq;
+                    bestPriority = getPriority(irq);
+                }
+            }
+        }
+        if (best == 0xFF)
+            return;
+
+        isr = ((const ISR *)(uintptr_t)*simRegister(NVIC_BASE + OFS_VTOR))[best + 16];
+        if (!isr)
+            simFatal("no vector for interrupt %d", best + 16);
+        pending[best / 32] &= ~(1 << (best % 32));
+        active[best / 32] |= 1 << (best % 32);
+        savedPriority = runningPriority;
+        savedVector = activeVector;
+        runningPriority = bestPriority;
+        activeVector = best + 16;
+        isr();
+        runningPriority = savedPriority;
+        activeVector = savedVector;
+        active[best / 32] &= ~(1 << (best % 32));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// TI intrinsics
+//-----------------------------------------------------------------------------
+
+uint32_t simDisableInterrupts(void)
+{
+    uint32_t state = primask;
+    primask = 1;
+    return state;
+}
+
+uint32_t simEnableInterrupts(void)
+{
+    uint32_t state = primask;
+    primask = 0;
+    simDispatch();
+    return state;
+}
+
+// Charged like a register access, so a loop that only masks and unmasks
+// (putcUart0 waiting for queue space) still lets time pass
+void simRestoreInterrupts(uint32_t state)
+{
+    primask = state & 1;
+    simAdvance(SIM_ACCESS_CYCLES);
+    simDispatch();
+}
+
+uint32_t simSetInterruptPriority(uint32_t priority)
+{
+    uint32_t state = basepri;
+    basepri = priority & 0xE0;
+    simDispatch();
+    return state;
+}
+
+void simDelayCycles(uint32_t cycles)
+{
+    simAdvance(cycles);
+}
@@ -0,0 +1,22 @@
+// NVIC model
+
+// Interrupt lines are levels driven by the peripheral models. An enabled line
+// is taken when its priority is above the running priority, BASEPRI and PRIMASK,
+// by calling the vector from the table at VTOR (the startup file's at reset).
+
+#ifndef SIMNVIC_H_
+#define SIMNVIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitNvic(void);
+void simSetIrq(uint8_t vector, bool level);
+void simDispatch(void);
+uint8_t simActiveVector(void);
+
+#endif
@@ -0,0 +1,111 @@
+// Feeder plant model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim.h"
+#include "simgpio.h"
+#include "simpwm.h"
+#include "simtrace.h"
+#include "simplant.h"
+
+#define PUMP_PORT       SIM_PORTC
+#define PUMP_PIN        4
+#define FOOD_MODULE     0                   // M0PWM7
+#define FOOD_GENERATOR  3
+#define FOOD_OUTPUT     1
+
+#define CHARGE_OFFSET   2370                // TIMER1 ticks at 0 mL
+#define CHARGE_PER_50ML 48
+#define CHARGE_LATENCY  (3 * SIM_ACCESS_CYCLES)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static double level = 0;                    // mL at updated
+static uint64_t updated = 0;
+static double fillRate = 0;                 // mL/s
+static double drinkRate = 0;
+static bool pumpOn = false;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void updateLevel(void)
+{
+    uint64_t now = simNow();
+    double rate = (pumpOn ? fillRate : 0) - drinkRate;
+    level += rate * (now - updated) / SIM_CLOCK;
+    if (level < 0)
+        level = 0;
+    if (level > SIM_BOWL_ML)
+        level = SIM_BOWL_ML;
+    updated = now;
+}
+
+static void onPump(SIM_PORT port, uint8_t pin, bool value)
+{
+    (void)port;
+    (void)pin;
+    updateLevel();
+    pumpOn = value;
+    simTrace("pump %s %.1f mL", value ? "on" : "off", level);
+}
+
+static void onFood(uint16_t duty)
+{
+    static bool on = false;
+    if ((duty != 0) != on)
+    {
+        on = duty != 0;
+        simTrace("food %s", on ? "on" : "off");
+    }
+}
+
+void simInitPlant(double initialLevel, double fill, double drink)
+{
+    level = initialLevel;
+    fillRate = fill;
+    drinkRate = drink;
+    simWatchPin(PUMP_PORT, PUMP_PIN, onPump);
+    simWatchPwm(FOOD_MODULE, FOOD_GENERATOR, FOOD_OUTPUT, onFood);
+}
+
+void simSetPlantLevel(double value)
+{
+    updateLevel();
+    level = value;
+    updateLevel();
+}
+
+void simSetPlantFillRate(double rate)
+{
+    updateLevel();
+    fillRate = rate;
+}
+
+void simSetPlantDrinkRate(double rate)
+{
+    updateLevel();
+    drinkRate = rate;
+}
+
+double simGetPlantLevel(void)
+{
+    updateLevel();
+    return level;
+}
+
+// Time from releasing the sensor (DISH low) to the comparator trip
+// comprt0Isr truncates to 50 mL steps, so the model adds half a step and the
+// accesses wideTimer1Isr makes between DISH and starting TIMER1
+uint64_t simGetPlantChargeCycles(void)
+{
+    return CHARGE_OFFSET + (uint64_t)(simGetPlantLevel() * CHARGE_PER_50ML / 50)
+         + CHARGE_PER_50ML / 2 + CHARGE_LATENCY;
+}
@@ -0,0 +1,26 @@
+// Feeder plant model
+
+// The bowl level rises at the fill rate while the pump (PC4) is on and falls
+// at the drink rate, between 0 and the bowl capacity. The capacitive sensor
+// charges in 2370 + 0.96 TIMER1 ticks per mL, the inverse of comprt0Isr.
+// Pump and food motor (M0PWM7) changes are traced.
+
+#ifndef SIMPLANT_H_
+#define SIMPLANT_H_
+
+#include <stdint.h>
+
+#define SIM_BOWL_ML     1000
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitPlant(double level, double fillRate, double drinkRate);
+void simSetPlantLevel(double level);
+void simSetPlantFillRate(double rate);
+void simSetPlantDrinkRate(double rate);
+double simGetPlantLevel(void);
+uint64_t simGetPlantChargeCycles(void);
+
+#endif
@@ -0,0 +1,286 @@
+// PWM model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+#include "simpwm.h"
+
+#define OFS_ENABLE      0x008
+#define OFS_INTEN       0x014
+#define OFS_RIS         0x018
+#define OFS_ISC         0x01C
+#define OFS_GEN         0x040               // generator n at OFS_GEN + n * GEN_SIZE
+#define GEN_SIZE        0x040
+
+// Generator register offsets
+#define GEN_CTL         0x00
+#define GEN_INTEN       0x04
+#define GEN_RIS         0x08
+#define GEN_ISC         0x0C
+#define GEN_LOAD        0x10
+#define GEN_COUNT       0x14
+#define GEN_CMPA        0x18
+#define GEN_CMPB        0x1C
+#define GEN_GENA        0x20
+#define GEN_GENB        0x24
+
+#define GEN_COUNTER_INTS (PWM_0_INTEN_INTCNTZERO | PWM_0_INTEN_INTCNTLOAD)
+#define GEN_INT_MASK    0x3F
+
+#define ACTION_LOW      2
+#define ACTION_HIGH     3
+
+#define RCC             0x400FE060
+
+#define MAX_WATCHERS    4
+
+typedef struct _GENERATOR
+{
+    bool running;
+    uint64_t start;                         // counter loaded with LOAD
+    uint64_t checked;
+} GENERATOR;
+
+typedef struct _MODULE
+{
+    SIM_DEVICE device;
+    uint8_t vectors[4];
+    GENERATOR generators[4];
+} MODULE;
+
+typedef struct _WATCHER
+{
+    uint8_t module;
+    uint8_t generator;
+    uint8_t output;
+    uint16_t duty;
+    SIM_PWM_WATCHER callback;
+} WATCHER;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static MODULE modules[2] =
+{
+    {{"PWM0", 0x40028000}, {INT_PWM0_0, INT_PWM0_1, INT_PWM0_2, INT_PWM0_3}},
+    {{"PWM1", 0x40029000}, {INT_PWM1_0, INT_PWM1_1, INT_PWM1_2, INT_PWM1_3}}
+};
+
+static WATCHER watchers[MAX_WATCHERS];
+static uint8_t watcherCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(m, ofs) (*simRegister((m)->device.base + (ofs)))
+#define GEN_REG(m, n, ofs) REG(m, OFS_GEN + (n) * GEN_SIZE + (ofs))
+
+static uint32_t getDivider(void)
+{
+    uint32_t rcc = *simRegister(RCC);
+    if (!(rcc & SYSCTL_RCC_USEPWMDIV))
+        return 1;
+    return 2 << ((rcc & SYSCTL_RCC_PWMDIV_M) >> 17);
+}
+
+static uint64_t getPeriod(MODULE *m, uint8_t n)
+{
+    uint64_t load = GEN_REG(m, n, GEN_LOAD) & 0xFFFF;
+    if (GEN_REG(m, n, GEN_CTL) & PWM_0_CTL_MODE)
+        return 2 * load * getDivider();                 // up/down
+    return (load + 1) * getDivider();
+}
+
+// First load and zero after the checked time
+static uint64_t getNext(MODULE *m, uint8_t n, bool zero)
+{
+    GENERATOR *g = &m->generators[n];
+    uint64_t period = getPeriod(m, n);
+    uint64_t first = g->start + period;
+    if (zero)
+        first = g->start + (GEN_REG(m, n, GEN_CTL) & PWM_0_CTL_MODE ? period / 2 : period - getDivider());
+    if (first > g->checked)
+        return first;
+    return first + ((g->checked - first) / period + 1) * period;
+}
+
+static uint32_t getStatus(MODULE *m, uint8_t n)
+{
+    return GEN_REG(m, n, GEN_RIS) & GEN_REG(m, n, GEN_INTEN) & GEN_INT_MASK;
+}
+
+static void updateIrq(MODULE *m)
+{
+    uint8_t n;
+    for (n = 0; n < 4; n++)
+        simSetIrq(m->vectors[n], getStatus(m, n) && (REG(m, OFS_INTEN) >> n & 1));
+}
+
+static void updatePwm(void *context, uint64_t now)
+{
+    MODULE *m = context;
+    uint8_t n;
+    for (n = 0; n < 4; n++)
+    {
+        GENERATOR *g = &m->generators[n];
+        if (!g->running)
+            continue;
+        if (getNext(m, n, false) <= now)
+            GEN_REG(m, n, GEN_RIS) |= PWM_0_INTEN_INTCNTLOAD;
+        if (getNext(m, n, true) <= now)
+            GEN_REG(m, n, GEN_RIS) |= PWM_0_INTEN_INTCNTZERO;
+        g->checked = now;
+    }
+    updateIrq(m);
+}
+
+// Counter events only while their interrupt can reach the NVIC
+static uint64_t getNextPwmEvent(void *context)
+{
+    MODULE *m = context;
+    uint64_t next = SIM_NEVER, t;
+    uint8_t n;
+    for (n = 0; n < 4; n++)
+    {
+        uint32_t inten = GEN_REG(m, n, GEN_INTEN);
+        if (!m->generators[n].running || !(REG(m, OFS_INTEN) >> n & 1))
+            continue;
+        if ((inten & PWM_0_INTEN_INTCNTLOAD) && (t = getNext(m, n, false)) < next)
+            next = t;
+        if ((inten & PWM_0_INTEN_INTCNTZERO) && (t = getNext(m, n, true)) < next)
+            next = t;
+    }
+    return next;
+}
+
+static uint32_t readPwm(void *context, uint32_t offset, bool sideEffects)
+{
+    MODULE *m = context;
+    uint32_t value = 0;
+    uint8_t n;
+    (void)sideEffects;
+    if (offset >= OFS_GEN && offset < OFS_GEN + 4 * GEN_SIZE)
+    {
+        n = (offset - OFS_GEN) / GEN_SIZE;
+        switch ((offset - OFS_GEN) % GEN_SIZE)
+        {
+            case GEN_ISC:
+                return getStatus(m, n);
+            case GEN_COUNT:
+                if (!m->generators[n].running)
+                    return 0;
+                return GEN_REG(m, n, GEN_LOAD)
+                     - ((simNow() - m->generators[n].start) % getPeriod(m, n)) / getDivider();
+        }
+    }
+    else if (offset == OFS_RIS || offset == OFS_ISC)
+    {
+        for (n = 0; n < 4; n++)
+            if (getStatus(m, n))
+                value |= 1 << n;
+        return offset == OFS_ISC ? value & REG(m, OFS_INTEN) : value;
+    }
+    return REG(m, offset);
+}
+
+static void notify(void)
+{
+    uint16_t duty;
+    uint8_t i;
+    for (i = 0; i < watcherCount; i++)
+    {
+        duty = simGetPwmDuty(watchers[i].module, watchers[i].generator, watchers[i].output);
+        if (duty != watchers[i].duty)
+        {
+            watchers[i].duty = duty;
+            watchers[i].callback(duty);
+        }
+    }
+}
+
+static void writePwm(void *context, uint32_t offset, uint32_t value)
+{
+    MODULE *m = context;
+    uint8_t n;
+    if (offset >= OFS_GEN && offset < OFS_GEN + 4 * GEN_SIZE)
+    {
+        GENERATOR *g;
+        n = (offset - OFS_GEN) / GEN_SIZE;
+        g = &m->generators[n];
+        switch ((offset - OFS_GEN) % GEN_SIZE)
+        {
+            case GEN_CTL:
+                if ((value & PWM_0_CTL_ENABLE) && !g->running)
+                    g->start = g->checked = simNow();
+                g->running = value & PWM_0_CTL_ENABLE;
+                break;
+            case GEN_ISC:
+                GEN_REG(m, n, GEN_RIS) &= ~value;
+                updateIrq(m);
+                return;
+            case GEN_RIS:
+            case GEN_COUNT:
+                return;
+        }
+    }
+    else if (offset == OFS_RIS || offset == OFS_ISC)
+        return;
+    REG(m, offset) = value;
+    updateIrq(m);
+    notify();
+}
+
+void simInitPwm(void)
+{
+    uint8_t i;
+    for (i = 0; i < 2; i++)
+    {
+        MODULE *m = &modules[i];
+        m->device.size = 0x1000;
+        m->device.context = m;
+        m->device.read = readPwm;
+        m->device.write = writePwm;
+        m->device.update = updatePwm;
+        m->device.nextEvent = getNextPwmEvent;
+        simAddDevice(&m->device);
+    }
+}
+
+// Duty of an output in parts per 10000 for the count down actions pwm.c uses
+uint16_t simGetPwmDuty(uint8_t module, uint8_t generator, uint8_t output)
+{
+    MODULE *m = &modules[module];
+    uint32_t action = GEN_REG(m, generator, output ? GEN_GENB : GEN_GENA);
+    uint32_t load = GEN_REG(m, generator, GEN_LOAD) + 1;
+    uint32_t compare = GEN_REG(m, generator, output ? GEN_CMPB : GEN_CMPA);
+    uint8_t atLoad = (action >> 2) & 3;
+    uint8_t atCompare = (action >> (output ? 10 : 6)) & 3;
+
+    if (!m->generators[generator].running || !(REG(m, OFS_ENABLE) >> (generator * 2 + output) & 1))
+        return 0;
+    if (atLoad == ACTION_LOW && atCompare == ACTION_HIGH)
+        return (uint64_t)(compare + 1) * 10000 / load;
+    if (atLoad == ACTION_HIGH && atCompare == ACTION_LOW)
+        return (uint64_t)(load - 1 - compare) * 10000 / load;
+    return atLoad == ACTION_HIGH ? 10000 : 0;
+}
+
+void simWatchPwm(uint8_t module, uint8_t generator, uint8_t output, SIM_PWM_WATCHER watcher)
+{
+    if (watcherCount == MAX_WATCHERS)
+        simFatal("too many pwm watchers");
+    watchers[watcherCount].module = module;
+    watchers[watcherCount].generator = generator;
+    watchers[watcherCount].output = output;
+    watchers[watcherCount].duty = 0;
+    watchers[watcherCount].callback = watcher;
+    watcherCount++;
+}
@@ -0,0 +1,24 @@
+// PWM model
+
+// Generators count down from LOAD at the PWM clock (RCC divider) and raise
+// their zero and load interrupts. Outputs are not simulated per edge,
+// simGetPwmDuty() reports the duty the GENx, CMPx and ENABLE registers select.
+// Watchers are called when a register write changes the duty of their output.
+
+#ifndef SIMPWM_H_
+#define SIMPWM_H_
+
+#include <stdint.h>
+
+// Called with the new duty in parts per 10000
+typedef void (*SIM_PWM_WATCHER)(uint16_t duty);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitPwm(void);
+uint16_t simGetPwmDuty(uint8_t module, uint8_t generator, uint8_t output);
+void simWatchPwm(uint8_t module, uint8_t generator, uint8_t output, SIM_PWM_WATCHER watcher);
+
+#endif
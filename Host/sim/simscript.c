@@ -0,0 +1,173 @@
+// Simulator commands and scripts
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "sim.h"
+#include "simgpio.h"
+#include "simhib.h"
+#include "simpwm.h"
+#include "simplant.h"
+#include "simtrace.h"
+#include "simuart.h"
+#include "simscript.h"
+
+#define SENSOR_PORT     SIM_PORTF
+#define SENSOR_PIN      4
+#define LINE_SIZE       256
+
+typedef struct _STEP
+{
+    uint64_t time;                          // cycles
+    uint32_t line;
+    char *command;
+} STEP;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const char *scriptPath;
+static STEP *steps = 0;
+static uint32_t stepCount = 0;
+static uint32_t next = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void printStatus(void)
+{
+    uint32_t seconds = simGetRtcSeconds();
+    char rtc[24];
+    simFormatTime(rtc, seconds);
+    if (simIsTracing())
+        simTrace("status rtc %s level %.1f mL pump %s food %u", rtc, simGetPlantLevel(),
+                 simGetPinOutput(SIM_PORTC, 4) ? "on" : "off", simGetPwmDuty(0, 3, 1));
+    else
+        fprintf(stderr, "sim: %.3f s, rtc %s, level %.1f mL, pump %s, food %u\n",
+                (double)simNow() / SIM_CLOCK, rtc, simGetPlantLevel(),
+                simGetPinOutput(SIM_PORTC, 4) ? "on" : "off", simGetPwmDuty(0, 3, 1));
+}
+
+// Returns false for an unknown command or a missing argument
+bool simRunCommand(char *command)
+{
+    char *name = strtok(command, " \t");
+    char *argument = strtok(0, "");
+    char text[LINE_SIZE + 1];
+
+    if (!name)
+        return true;
+    if (!strcmp(name, "uart"))
+    {
+        snprintf(text, sizeof(text), "%s\r", argument ? argument : "");
+        simUartInput(text, strlen(text));
+    }
+    else if (!strcmp(name, "status"))
+        printStatus();
+    else if (!strcmp(name, "end") || !strcmp(name, "quit"))
+        exit(0);
+    else if (!argument)
+        return false;
+    else if (!strcmp(name, "level"))
+        simSetPlantLevel(atof(argument));
+    else if (!strcmp(name, "fill"))
+        simSetPlantFillRate(atof(argument));
+    else if (!strcmp(name, "drink"))
+        simSetPlantDrinkRate(atof(argument));
+    else if (!strcmp(name, "motion"))
+        simSetPinInput(SENSOR_PORT, SENSOR_PIN, atoi(argument));
+    else
+        return false;
+    return true;
+}
+
+static void updateScript(void *context, uint64_t now)
+{
+    (void)context;
+    while (next < stepCount && steps[next].time <= now)
+    {
+        simTrace("> %s", steps[next].command);
+        if (!simRunCommand(steps[next].command))
+            simFatal("%s:%u: unknown command or missing argument", scriptPath, steps[next].line);
+        next++;
+    }
+    if (next == stepCount)
+        exit(0);
+}
+
+static uint64_t getNextScriptEvent(void *context)
+{
+    (void)context;
+    return next < stepCount ? steps[next].time : SIM_NEVER;
+}
+
+// Not mapped at any address, only updated with the devices
+static const SIM_DEVICE script =
+{
+    "SCRIPT", 0, 0, 0, 0, 0, updateScript, getNextScriptEvent
+};
+
+// [D+]HH:MM[:SS] in seconds, -1 if invalid
+static int64_t parseTime(const char *text, int *length)
+{
+    unsigned days = 0, hours, minutes, seconds = 0;
+    int n = 0;
+    if (sscanf(text, "%u+%n", &days, &n) == 1 && n)
+        text += n;
+    else
+        n = days = 0;
+    *length = n;
+    if (sscanf(text, "%u:%u%n:%u%n", &hours, &minutes, length, &seconds, length) < 2
+        || hours > 23 || minutes > 59 || seconds > 59)
+        return -1;
+    *length += n;
+    return (int64_t)days * 86400 + hours * 3600 + minutes * 60 + seconds;
+}
+
+// Steps before the start run at once
+void simLoadScript(const char *path, uint32_t startSeconds)
+{
+    FILE *file = fopen(path, "r");
+    char line[LINE_SIZE], *text;
+    uint32_t number = 0, capacity = 0;
+    int64_t seconds, last = 0;
+    int length;
+
+    if (!file)
+        simFatal("%s: %s", path, strerror(errno));
+    while (fgets(line, sizeof(line), file))
+    {
+        number++;
+        line[strcspn(line, "#\r\n")] = 0;
+        text = line + strspn(line, " \t");
+        if (!*text)
+            continue;
+        seconds = parseTime(text, &length);
+        if (seconds < 0 || seconds < last)
+            simFatal("%s:%u: expected a time after the previous line", path, number);
+        last = seconds;
+        text += length;
+        text += strspn(text, " \t");
+        if (stepCount == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            steps = realloc(steps, capacity * sizeof(STEP));
+        }
+        steps[stepCount].time = seconds > startSeconds ? (seconds - startSeconds) * SIM_CLOCK : 0;
+        steps[stepCount].line = number;
+        steps[stepCount].command = strdup(text);
+        stepCount++;
+    }
+    fclose(file);
+    scriptPath = path;
+    simAddDevice(&script);
+}
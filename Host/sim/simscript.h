@@ -0,0 +1,27 @@
+// Simulator commands and scripts
+
+// Commands, from the console or a script:
+//   uart TEXT          TEXT and CR to the UART0 receiver
+//   level ML           bowl level
+//   fill ML/S          pump rate
+//   drink ML/S         drinking rate
+//   motion 0|1         motion sensor (PF4)
+//   status             time, RTC, level, pump and food motor
+//   end                stops the simulation (quit from the console)
+// Script lines are [D+]HH:MM[:SS] COMMAND in time order, on the trace clock.
+// # starts a comment. The run ends after the last line.
+
+#ifndef SIMSCRIPT_H_
+#define SIMSCRIPT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool simRunCommand(char *command);
+void simLoadScript(const char *path, uint32_t startSeconds);
+
+#endif
@@ -0,0 +1,42 @@
+// System control model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sim.h"
+#include "simsysctl.h"
+
+#define SYSCTL_BASE     0x400FE000
+#define OFS_RCC         0x060
+#define OFS_RCGC        0x600               // RCGCWD, RCGCTIMER, ...
+#define OFS_PR          0xA00               // PRWD, PRTIMER, ...
+#define OFS_PR_END      0xB00
+
+#define RCC_RESET       0x078E3AD1
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint32_t readSysctl(void *context, uint32_t offset, bool sideEffects)
+{
+    (void)context;
+    (void)sideEffects;
+    if (offset >= OFS_PR && offset < OFS_PR_END)
+        return *simRegister(SYSCTL_BASE + OFS_RCGC + offset - OFS_PR);
+    return *simRegister(SYSCTL_BASE + offset);
+}
+
+static const SIM_DEVICE sysctl =
+{
+    "SYSCTL", SYSCTL_BASE, 0x1000, 0, readSysctl, 0, 0, 0
+};
+
+void simInitSysctl(void)
+{
+    *simRegister(SYSCTL_BASE + OFS_RCC) = RCC_RESET;
+    simAddDevice(&sysctl);
+}
@@ -0,0 +1,15 @@
+// System control model
+
+// Clock gating registers are storage, the peripheral ready registers
+// (PRx) report the peripherals enabled in RCGCx as ready at once.
+
+#ifndef SIMSYSCTL_H_
+#define SIMSYSCTL_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitSysctl(void);
+
+#endif
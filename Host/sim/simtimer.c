@@ -0,0 +1,242 @@
+// General purpose timer model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+#include "simtimer.h"
+
+#define OFS_TAMR        0x004
+#define OFS_CTL         0x00C
+#define OFS_IMR         0x018
+#define OFS_RIS         0x01C
+#define OFS_MIS         0x020
+#define OFS_ICR         0x024
+#define OFS_TAILR       0x028
+#define OFS_TAMATCHR    0x030
+#define OFS_TAR         0x048
+#define OFS_TAV         0x050
+
+#define TIMER_COUNT     12
+#define TIMER_A_MASK    0x1F                // timer A bits of IMR, RIS and MIS
+
+typedef struct _TIMER
+{
+    SIM_DEVICE device;
+    uint8_t vector;
+    bool running;
+    uint64_t start;                         // time the counter was at startValue
+    uint32_t startValue;
+    uint32_t value;                         // counter while stopped
+    uint64_t checked;                       // events are latched up to this time
+} TIMER;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static TIMER timers[TIMER_COUNT] =
+{
+    {{"TIMER0", 0x40030000}, INT_TIMER0A},
+    {{"TIMER1", 0x40031000}, INT_TIMER1A},
+    {{"TIMER2", 0x40032000}, INT_TIMER2A},
+    {{"TIMER3", 0x40033000}, INT_TIMER3A},
+    {{"TIMER4", 0x40034000}, INT_TIMER4A},
+    {{"TIMER5", 0x40035000}, INT_TIMER5A},
+    {{"WTIMER0", 0x40036000}, INT_WTIMER0A},
+    {{"WTIMER1", 0x40037000}, INT_WTIMER1A},
+    {{"WTIMER2", 0x4004C000}, INT_WTIMER2A},
+    {{"WTIMER3", 0x4004D000}, INT_WTIMER3A},
+    {{"WTIMER4", 0x4004E000}, INT_WTIMER4A},
+    {{"WTIMER5", 0x4004F000}, INT_WTIMER5A}
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(t, ofs) (*simRegister((t)->device.base + (ofs)))
+
+static bool isCountingUp(TIMER *t)
+{
+    return REG(t, OFS_TAMR) & TIMER_TAMR_TACDIR;
+}
+
+static bool isOneShot(TIMER *t)
+{
+    return (REG(t, OFS_TAMR) & TIMER_TAMR_TAMR_M) == TIMER_TAMR_TAMR_1_SHOT;
+}
+
+static uint64_t getPeriod(TIMER *t)
+{
+    return (uint64_t)REG(t, OFS_TAILR) + 1;
+}
+
+static uint32_t getValue(TIMER *t, uint64_t now)
+{
+    uint64_t elapsed = now - t->start;
+    if (!t->running)
+        return t->value;
+    if (isCountingUp(t))
+        return ((uint64_t)t->startValue + elapsed) % getPeriod(t);
+    if (elapsed <= t->startValue)
+        return t->startValue - elapsed;
+    return REG(t, OFS_TAILR) - (elapsed - t->startValue - 1) % getPeriod(t);
+}
+
+// Time the counter first reaches value after the start
+static uint64_t getFirst(TIMER *t, uint32_t value)
+{
+    uint64_t period = getPeriod(t);
+    if (isCountingUp(t))
+        return t->start + ((uint64_t)value + period - t->startValue % period) % period;
+    if (value <= t->startValue)
+        return t->start + t->startValue - value;
+    return t->start + t->startValue + 1 + (REG(t, OFS_TAILR) - value);
+}
+
+// First occurrence after time of an event repeating every period from first
+static uint64_t getNext(uint64_t first, uint64_t period, uint64_t time)
+{
+    if (first > time)
+        return first;
+    return first + ((time - first) / period + 1) * period;
+}
+
+static uint64_t getNextTimeout(TIMER *t)
+{
+    uint64_t first = getFirst(t, isCountingUp(t) ? REG(t, OFS_TAILR) : 0);
+    if (isOneShot(t))
+        return first > t->checked ? first : SIM_NEVER;
+    return getNext(first, getPeriod(t), t->checked);
+}
+
+static uint64_t getNextMatch(TIMER *t)
+{
+    if (!(REG(t, OFS_TAMR) & TIMER_TAMR_TAMIE) || REG(t, OFS_TAMATCHR) > REG(t, OFS_TAILR))
+        return SIM_NEVER;
+    return getNext(getFirst(t, REG(t, OFS_TAMATCHR)), getPeriod(t), t->checked);
+}
+
+static void updateIrq(TIMER *t)
+{
+    simSetIrq(t->vector, REG(t, OFS_RIS) & REG(t, OFS_IMR) & TIMER_A_MASK);
+}
+
+static void startCounter(TIMER *t, uint32_t value)
+{
+    t->start = t->checked = simNow();
+    t->startValue = t->value = value;
+}
+
+static void updateTimer(void *context, uint64_t now)
+{
+    TIMER *t = context;
+    if (!t->running)
+        return;
+    if (getNextMatch(t) <= now)
+        REG(t, OFS_RIS) |= TIMER_RIS_TAMRIS;
+    if (getNextTimeout(t) <= now)
+    {
+        REG(t, OFS_RIS) |= TIMER_RIS_TATORIS;
+        if (isOneShot(t))
+        {
+            t->running = false;
+            t->value = isCountingUp(t) ? 0 : REG(t, OFS_TAILR);
+            REG(t, OFS_CTL) &= ~TIMER_CTL_TAEN;
+        }
+    }
+    t->checked = now;
+    updateIrq(t);
+}
+
+// Only events that change the state or raise an unmasked interrupt
+static uint64_t getNextTimerEvent(void *context)
+{
+    TIMER *t = context;
+    uint64_t next = SIM_NEVER, match;
+    if (!t->running)
+        return SIM_NEVER;
+    if (isOneShot(t) || (REG(t, OFS_IMR) & TIMER_IMR_TATOIM))
+        next = getNextTimeout(t);
+    if (REG(t, OFS_IMR) & TIMER_IMR_TAMIM)
+    {
+        match = getNextMatch(t);
+        if (match < next)
+            next = match;
+    }
+    return next;
+}
+
+static uint32_t readTimer(void *context, uint32_t offset, bool sideEffects)
+{
+    TIMER *t = context;
+    (void)sideEffects;
+    if (offset == OFS_TAR || offset == OFS_TAV)
+        return getValue(t, simNow());
+    if (offset == OFS_MIS)
+        return REG(t, OFS_RIS) & REG(t, OFS_IMR);
+    return REG(t, offset);
+}
+
+static void writeTimer(void *context, uint32_t offset, uint32_t value)
+{
+    TIMER *t = context;
+    uint64_t now = simNow();
+    switch (offset)
+    {
+        case OFS_CTL:
+            if ((value & TIMER_CTL_TAEN) && !t->running)
+            {
+                startCounter(t, t->value);
+                t->running = true;
+            }
+            else if (!(value & TIMER_CTL_TAEN) && t->running)
+            {
+                t->value = getValue(t, now);
+                t->running = false;
+            }
+            break;
+        case OFS_TAV:
+            startCounter(t, value);
+            return;
+        case OFS_TAILR:
+            if (!isCountingUp(t))
+                startCounter(t, value);             // down counters load the new value at once
+            break;
+        case OFS_ICR:
+            REG(t, OFS_RIS) &= ~value;
+            updateIrq(t);
+            return;
+        case OFS_RIS:
+        case OFS_MIS:
+        case OFS_TAR:
+            return;                                 // read only
+    }
+    REG(t, offset) = value;
+    updateIrq(t);
+}
+
+void simInitTimers(void)
+{
+    uint8_t i;
+    for (i = 0; i < TIMER_COUNT; i++)
+    {
+        TIMER *t = &timers[i];
+        t->device.size = 0x1000;
+        t->device.context = t;
+        t->device.read = readTimer;
+        t->device.write = writeTimer;
+        t->device.update = updateTimer;
+        t->device.nextEvent = getNextTimerEvent;
+        REG(t, OFS_TAILR) = 0xFFFFFFFF;
+        REG(t, OFS_TAMATCHR) = 0xFFFFFFFF;
+        t->value = 0xFFFFFFFF;
+        simAddDevice(&t->device);
+    }
+}
@@ -0,0 +1,16 @@
+// General purpose timer model
+
+// Timer A of the 16/32-bit and 32/64-bit timers in 32-bit one-shot or
+// periodic mode, counting up or down, with timeout and match interrupts.
+// Counter values are computed from the time the timer was started.
+
+#ifndef SIMTIMER_H_
+#define SIMTIMER_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitTimers(void);
+
+#endif
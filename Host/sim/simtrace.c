@@ -0,0 +1,68 @@
+// Simulation trace
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include "sim.h"
+#include "simtrace.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static FILE *trace = 0;
+static uint32_t start = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// "-" traces to stdout
+void simOpenTrace(const char *path, uint32_t startSeconds)
+{
+    trace = strcmp(path, "-") ? fopen(path, "w") : stdout;
+    if (!trace)
+        simFatal("%s: %s", path, strerror(errno));
+    setvbuf(trace, 0, _IOLBF, 0);           // complete up to a hang or a crash
+    start = startSeconds;
+}
+
+bool simIsTracing(void)
+{
+    return trace;
+}
+
+// Simulated wall clock in ms
+uint64_t simGetClockMs(void)
+{
+    return (uint64_t)start * 1000 + simNow() / (SIM_CLOCK / 1000);
+}
+
+// D+HH:MM:SS, text holds at least 24 characters
+void simFormatTime(char *text, uint64_t seconds)
+{
+    sprintf(text, "%u+%02u:%02u:%02u", (unsigned)(seconds / 86400), (unsigned)(seconds / 3600 % 24),
+            (unsigned)(seconds / 60 % 60), (unsigned)(seconds % 60));
+}
+
+void simTrace(const char *format, ...)
+{
+    uint64_t ms = simGetClockMs();
+    char time[24];
+    va_list args;
+    if (!trace)
+        return;
+    simFormatTime(time, ms / 1000);
+    fprintf(trace, "%s.%03u ", time, (unsigned)(ms % 1000));
+    va_start(args, format);
+    vfprintf(trace, format, args);
+    va_end(args);
+    fputc('\n', trace);
+}
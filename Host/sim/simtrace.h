@@ -0,0 +1,27 @@
+// Simulation trace
+
+// One line per event, stamped with the simulated wall clock
+// (the --time start plus the elapsed time) as D+HH:MM:SS.mmm:
+//   > COMMAND          script line applied
+//   uart TEXT          line sent by the firmware
+//   alarm D+HH:MM:SS   RTC match programmed, alarm none for 0xFFFFFFFF
+//   pump on|off        PC4 with the bowl level
+//   food on|off        food motor output
+
+#ifndef SIMTRACE_H_
+#define SIMTRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simOpenTrace(const char *path, uint32_t startSeconds);
+bool simIsTracing(void);
+uint64_t simGetClockMs(void);
+void simFormatTime(char *text, uint64_t seconds);
+void simTrace(const char *format, ...);
+
+#endif
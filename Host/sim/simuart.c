@@ -0,0 +1,283 @@
+// UART0 model
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include "tm4c123gh6pm.h"
+#include "sim.h"
+#include "simnvic.h"
+#include "simtrace.h"
+#include "simuart.h"
+
+#define UART0_BASE      0x4000C000
+#define OFS_DR          0x000
+#define OFS_FR          0x018
+#define OFS_IBRD        0x024
+#define OFS_FBRD        0x028
+#define OFS_CTL         0x030
+#define OFS_IFLS        0x034
+#define OFS_IM          0x038
+#define OFS_RIS         0x03C
+#define OFS_MIS         0x040
+#define OFS_ICR         0x044
+
+#define FIFO_SIZE       16
+#define HOST_SIZE       1024                // bytes read ahead from rxFd or queued
+#define LINE_SIZE       256
+#define BITS_PER_BYTE   10                  // 8N1
+
+typedef struct _FIFO
+{
+    uint8_t data[FIFO_SIZE];
+    uint8_t read;
+    uint8_t count;
+} FIFO;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static int rxFd = -1;
+static int txFd = -1;
+static bool lineInput = false;
+
+static FIFO tx, rx;
+static uint64_t txDone = SIM_NEVER;         // first byte of tx is on the line until then
+static uint64_t rxReady = 0;                // next byte can arrive
+static uint8_t host[HOST_SIZE];
+static uint16_t hostRead = 0, hostCount = 0;
+static char line[LINE_SIZE];                // traced output
+static uint16_t lineCount = 0;
+static uint32_t noiseInterval = 0;          // every nth received byte is damaged, 0 for none
+static uint32_t noiseCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+#define REG(ofs) (*simRegister(UART0_BASE + (ofs)))
+
+static void push(FIFO *f, uint8_t c)
+{
+    f->data[(f->read + f->count++) % FIFO_SIZE] = c;
+}
+
+static uint8_t pop(FIFO *f)
+{
+    uint8_t c = f->data[f->read];
+    f->read = (f->read + 1) % FIFO_SIZE;
+    f->count--;
+    return c;
+}
+
+// 16 clocks per bit at IBRD + FBRD / 64, 8 with HSE
+static uint64_t getByteCycles(void)
+{
+    uint64_t divisor = (uint64_t)REG(OFS_IBRD) * 64 + REG(OFS_FBRD);
+    if (divisor == 0)
+        divisor = 64;
+    return divisor * (REG(OFS_CTL) & UART_CTL_HSE ? 8 : 16) * BITS_PER_BYTE / 64;
+}
+
+// Fifo level select, 1/8 to 7/8 of the fifo
+static uint8_t getLevel(uint32_t select)
+{
+    static const uint8_t levels[] = {2, 4, 8, 12, 14};
+    return select < 5 ? levels[select] : 14;
+}
+
+static bool isEnabled(uint32_t bit)
+{
+    return (REG(OFS_CTL) & UART_CTL_UARTEN) && (REG(OFS_CTL) & bit);
+}
+
+static void updateIrq(void)
+{
+    simSetIrq(INT_UART0, REG(OFS_RIS) & REG(OFS_IM));
+}
+
+static void traceByte(uint8_t c)
+{
+    if (c == '\n' || lineCount == LINE_SIZE - 1)
+    {
+        line[lineCount] = 0;
+        lineCount = 0;
+        simTrace("uart %s", line);
+    }
+    if (c != '\n' && c != '\r')
+        line[lineCount++] = c;
+}
+
+static void sendByte(uint8_t c)
+{
+    if (simIsTracing())
+        traceByte(c);
+    if (txFd >= 0)
+        while (write(txFd, &c, 1) < 0 && errno == EINTR);
+}
+
+static void readHost(void)
+{
+    ssize_t n;
+    if (hostCount || rxFd < 0)
+        return;
+    n = read(rxFd, host, sizeof(host));
+    if (n > 0)
+    {
+        hostRead = 0;
+        hostCount = n;
+    }
+    else if (n == 0)
+    {
+        simRemoveInput(rxFd);
+        rxFd = -1;
+    }
+}
+
+static void updateUart(void *context, uint64_t now)
+{
+    uint64_t cycles = getByteCycles();
+    uint8_t level;
+    (void)context;
+
+    level = getLevel(REG(OFS_IFLS) & UART_IFLS_TX_M);
+    while (tx.count && txDone <= now)
+    {
+        sendByte(pop(&tx));
+        if (tx.count == level)
+            REG(OFS_RIS) |= UART_RIS_TXRIS;
+        txDone = tx.count ? txDone + cycles : SIM_NEVER;
+    }
+
+    readHost();
+    level = getLevel((REG(OFS_IFLS) & UART_IFLS_RX_M) >> 3);
+    while (hostCount && rx.count < FIFO_SIZE && rxReady <= now && isEnabled(UART_CTL_RXE))
+    {
+        uint8_t c = host[hostRead++];
+        hostCount--;
+        if (noiseInterval && ++noiseCount == noiseInterval)
+        {
+            noiseCount = 0;
+            c ^= 0x10;
+            simTrace("uart noise");
+        }
+        push(&rx, lineInput && c == '\n' ? '\r' : c);
+        if (rx.count == level)
+            REG(OFS_RIS) |= UART_RIS_RXRIS;
+        rxReady = now + cycles;
+        readHost();
+    }
+    updateIrq();
+}
+
+static uint64_t getNextUartEvent(void *context)
+{
+    uint64_t next = txDone;
+    (void)context;
+    if (hostCount && rx.count < FIFO_SIZE && rxReady < next)
+        next = rxReady;
+    return next;
+}
+
+static uint32_t readUart(void *context, uint32_t offset, bool sideEffects)
+{
+    uint32_t value = 0;
+    (void)context;
+    switch (offset)
+    {
+        case OFS_DR:
+            if (!rx.count)
+                return 0;
+            if (!sideEffects)
+                return rx.data[rx.read];
+            value = pop(&rx);
+            if (rx.count < getLevel((REG(OFS_IFLS) & UART_IFLS_RX_M) >> 3))
+                REG(OFS_RIS) &= ~UART_RIS_RXRIS;
+            updateIrq();
+            return value;
+        case OFS_FR:
+            if (tx.count == FIFO_SIZE)
+                value |= UART_FR_TXFF;
+            if (!tx.count)
+                value |= UART_FR_TXFE;
+            else
+                value |= UART_FR_BUSY;
+            if (!rx.count)
+                value |= UART_FR_RXFE;
+            if (rx.count == FIFO_SIZE)
+                value |= UART_FR_RXFF;
+            return value;
+        case OFS_MIS:
+            return REG(OFS_RIS) & REG(OFS_IM);
+    }
+    return REG(offset);
+}
+
+static void writeUart(void *context, uint32_t offset, uint32_t value)
+{
+    (void)context;
+    switch (offset)
+    {
+        case OFS_DR:
+            if (tx.count == FIFO_SIZE || !isEnabled(UART_CTL_TXE))
+                return;
+            if (!tx.count)
+                txDone = simNow() + getByteCycles();
+            push(&tx, value);
+            if (tx.count > getLevel(REG(OFS_IFLS) & UART_IFLS_TX_M))
+                REG(OFS_RIS) &= ~UART_RIS_TXRIS;
+            break;
+        case OFS_ICR:
+            REG(OFS_RIS) &= ~value;
+            break;
+        case OFS_FR:
+        case OFS_RIS:
+        case OFS_MIS:
+            return;
+        default:
+            REG(offset) = value;
+    }
+    updateIrq();
+}
+
+static const SIM_DEVICE uart =
+{
+    "UART0", UART0_BASE, 0x1000, 0, readUart, writeUart, updateUart, getNextUartEvent
+};
+
+// rxFd should be non-blocking, it is also polled while the firmware idles
+// Either fd may be -1, without an rxFd input only comes from simUartInput()
+void simInitUart(int in, int out, bool lines)
+{
+    rxFd = in;
+    txFd = out;
+    lineInput = lines;
+    REG(OFS_IFLS) = 0x12;                   // 1/2 full for tx and rx
+    if (in >= 0)
+        simAddInput(in);
+    simAddDevice(&uart);
+}
+
+// Queues bytes behind any input not yet received
+void simUartInput(const char *data, uint16_t length)
+{
+    if (hostCount + length > HOST_SIZE)
+        simFatal("uart input overflow");
+    memmove(host, host + hostRead, hostCount);
+    memcpy(host + hostCount, data, length);
+    hostRead = 0;
+    hostCount += length;
+}
+
+// Flips a bit of every interval-th byte the firmware receives, 0 for a clean line
+void simUartNoise(uint32_t interval)
+{
+    noiseInterval = interval;
+    noiseCount = 0;
+}
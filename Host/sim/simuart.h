@@ -0,0 +1,22 @@
+// UART0 model
+
+// Bytes written to the transmit fifo leave on txFd at the programmed baud
+// rate and bytes read from rxFd enter the receive fifo at the same rate.
+// With lineInput, LF from a terminal or a file arrives as the CR getsUart0 expects.
+// Output lines are traced. A noisy line can be simulated with simUartNoise().
+
+#ifndef SIMUART_H_
+#define SIMUART_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void simInitUart(int rxFd, int txFd, bool lineInput);
+void simUartInput(const char *data, uint16_t length);
+void simUartNoise(uint32_t interval);
+
+#endif
@@ -0,0 +1,25 @@
+// TI compiler intrinsics for the host build
+// Force-included (-include) into the firmware sources, so they compile unchanged
+
+#ifndef TI_HOST_H_
+#define TI_HOST_H_
+
+#include <stdint.h>
+
+uint32_t simDisableInterrupts(void);
+uint32_t simEnableInterrupts(void);
+void simRestoreInterrupts(uint32_t primask);
+uint32_t simSetInterruptPriority(uint32_t basepri);
+void simDelayCycles(uint32_t cycles);
+
+#define _disable_interrupts()           simDisableInterrupts()
+#define _enable_interrupts()            simEnableInterrupts()
+#define _restore_interrupts(state)      simRestoreInterrupts(state)
+#define _set_interrupt_priority(pri)    simSetInterruptPriority(pri)
+#define _delay_cycles(cycles)           simDelayCycles(cycles)
+#define _norm(x)                        ((x) ? __builtin_clz(x) : 32)
+
+// The startup code branches to the C runtime with inline assembly
+#define __asm(code)
+
+#endif
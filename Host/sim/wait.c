@@ -0,0 +1,22 @@
+// Wait functions for the host build
+
+// Replaces wait.s, the wait advances simulated time so interrupts are taken during it,
+// and a loop that waits between register reads is not taken for a polling loop
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "sim.h"
+#include "wait.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void waitMicrosecond(uint32_t us)
+{
+    simAdvance((uint64_t)us * (SIM_CLOCK / 1000000));
+    simEndPoll();
+}
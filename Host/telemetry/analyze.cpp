@@ -0,0 +1,146 @@
+// Telemetry analysis
+
+#include "analyze.h"
+#include <cmath>
+#include <cinttypes>
+
+namespace
+{
+
+const int HALF_BINS = 16;
+
+// Running mean and variance (Welford)
+struct Running
+{
+    uint64_t count = 0;
+    double mean = 0;
+    double m2 = 0;
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+
+    void add(uint32_t x)
+    {
+        count++;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+        if (x < min)
+            min = x;
+        if (x > max)
+            max = x;
+    }
+    double stddev() const { return count > 1 ? std::sqrt(m2 / (count - 1)) : 0; }
+};
+
+// On/off periods of one flag bit
+struct Timeline
+{
+    const char *name;
+    uint8_t mask;
+    bool on = false;
+    double start = 0;
+    uint64_t periods = 0;
+    double total = 0;
+
+    void update(uint8_t flags, double time, FILE *out, bool print)
+    {
+        bool now = flags & mask;
+        if (now && !on)
+            start = time;
+        if (!now && on)
+        {
+            periods++;
+            total += time - start;
+            if (print)
+                fprintf(out, "  %-5s %12.3f s  %8.3f s\n", name, start, time - start);
+        }
+        on = now;
+    }
+};
+
+}
+
+void analyze(const ColumnFile &file, const AnalyzeOptions &options, FILE *out)
+{
+    const ParserStats &s = file.stats();
+    fprintf(out, "rows %" PRIu64 "\n", file.rows());
+    fprintf(out, "input %" PRIu64 " bytes, %" PRIu64 " packets, %" PRIu64 " skipped bytes, %" PRIu64
+            " crc errors, %" PRIu64 " dropped packets\n",
+            s.bytes, s.packets, s.skippedBytes, s.crcErrors, s.droppedPackets);
+    if (file.rows() == 0)
+        return;
+
+    Running level, ticks;
+    Timeline food {"food", TELEMETRY_MOTOR};
+    Timeline pump {"pump", TELEMETRY_PUMP};
+    uint64_t histogram[2 * HALF_BINS + 2] = {};
+    uint64_t quietSamples = 0;
+    bool havePrevious = false;
+    uint32_t previousTicks = 0;
+    double first = 0, last = 0;
+
+    if (options.timeline)
+        fprintf(out, "timeline (start, duration):\n");
+    for (size_t b = 0; b < file.blockCount(); b++)
+    {
+        ColumnBlock block = file.block(b);
+        for (size_t i = 0; i < block.rows; i++)
+        {
+            double time = block.seconds[i] + block.subseconds[i] / 32768.0;
+            if (b == 0 && i == 0)
+                first = time;
+            last = time;
+            level.add(block.level[i]);
+            ticks.add(block.ticks[i]);
+            uint8_t flags = block.flags[i];
+            food.update(flags, time, out, options.timeline);
+            pump.update(flags, time, out, options.timeline);
+
+            // Noise is only meaningful while the level is not being changed
+            bool quiet = !(flags & (TELEMETRY_PUMP | TELEMETRY_MOTOR | TELEMETRY_RAMPING));
+            if (quiet && havePrevious)
+            {
+                int64_t delta = static_cast<int64_t>(block.ticks[i]) - previousTicks;
+                int64_t bin = delta >= 0 ? delta / options.binTicks : -((-delta + options.binTicks - 1) / options.binTicks);
+                if (bin < -HALF_BINS)
+                    histogram[0]++;
+                else if (bin >= HALF_BINS)
+                    histogram[2 * HALF_BINS + 1]++;
+                else
+                    histogram[bin + HALF_BINS + 1]++;
+                quietSamples++;
+            }
+            havePrevious = quiet;
+            previousTicks = block.ticks[i];
+        }
+    }
+
+    fprintf(out, "span %.3f s to %.3f s\n", first, last);
+    fprintf(out, "level mL: min %u max %u mean %.1f stddev %.2f\n", level.min, level.max, level.mean, level.stddev());
+    fprintf(out, "ticks: min %u max %u mean %.1f stddev %.2f\n", ticks.min, ticks.max, ticks.mean, ticks.stddev());
+    fprintf(out, "food: %" PRIu64 " feedings, %.3f s running\n", food.periods, food.total);
+    fprintf(out, "pump: %" PRIu64 " periods, %.3f s running\n", pump.periods, pump.total);
+
+    fprintf(out, "tick noise, %" PRIu64 " quiet sample pairs, %u ticks per bin:\n", quietSamples, options.binTicks);
+    uint64_t peak = 1;
+    for (uint64_t count : histogram)
+        if (count > peak)
+            peak = count;
+    for (int i = 0; i < 2 * HALF_BINS + 2; i++)
+    {
+        if (!histogram[i])
+            continue;
+        if (i == 0)
+            fprintf(out, "  %9s < %7" PRId64, "", -static_cast<int64_t>(HALF_BINS) * options.binTicks);
+        else if (i == 2 * HALF_BINS + 1)
+            fprintf(out, "  %9s >= %6" PRId64, "", static_cast<int64_t>(HALF_BINS) * options.binTicks);
+        else
+        {
+            int64_t low = static_cast<int64_t>(i - HALF_BINS - 1) * options.binTicks;
+            fprintf(out, "  %7" PRId64 " .. %7" PRId64, low, low + options.binTicks - 1);
+        }
+        int width = static_cast<int>(50 * histogram[i] / peak);
+        fprintf(out, " %10" PRIu64 " %.*s\n", histogram[i], width,
+                "##################################################");
+    }
+}
@@ -0,0 +1,20 @@
+// Telemetry analysis
+
+#ifndef ANALYZE_H_
+#define ANALYZE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include "columns.h"
+
+struct AnalyzeOptions
+{
+    uint32_t binTicks = 16;                 // noise histogram bin width
+    bool timeline = true;
+};
+
+// Prints level statistics, feeding and pump timelines and a histogram of
+// sample to sample comparator tick changes while nothing is running
+void analyze(const ColumnFile &file, const AnalyzeOptions &options, FILE *out);
+
+#endif
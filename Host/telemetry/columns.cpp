@@ -0,0 +1,168 @@
+// Columnar telemetry file
+
+#include "columns.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+
+const char MAGIC[8] = "FDRTLM1";
+const size_t HEADER_SIZE = 4096;            // keeps the blocks page aligned
+
+// Column offsets in a block, widest fields first
+const size_t SECONDS_OFFSET = 0;
+const size_t TICKS_OFFSET = SECONDS_OFFSET + 4 * ColumnFile::BLOCK_ROWS;
+const size_t SEQUENCE_OFFSET = TICKS_OFFSET + 4 * ColumnFile::BLOCK_ROWS;
+const size_t SUBSECONDS_OFFSET = SEQUENCE_OFFSET + 2 * ColumnFile::BLOCK_ROWS;
+const size_t LEVEL_OFFSET = SUBSECONDS_OFFSET + 2 * ColumnFile::BLOCK_ROWS;
+const size_t MOTOR_OFFSET = LEVEL_OFFSET + 2 * ColumnFile::BLOCK_ROWS;
+const size_t FLAGS_OFFSET = MOTOR_OFFSET + 2 * ColumnFile::BLOCK_ROWS;
+const size_t BLOCK_SIZE = FLAGS_OFFSET + ColumnFile::BLOCK_ROWS;
+
+std::runtime_error systemError(const std::string &what)
+{
+    return std::runtime_error(what + ": " + strerror(errno));
+}
+
+}
+
+ColumnFile::ColumnFile(int fd, bool writable)
+    : fd_(fd), writable_(writable)
+{
+}
+
+ColumnFile::ColumnFile(ColumnFile &&other)
+    : fd_(other.fd_), writable_(other.writable_), map_(other.map_), size_(other.size_)
+{
+    other.fd_ = -1;
+    other.map_ = nullptr;
+}
+
+ColumnFile::~ColumnFile()
+{
+    if (map_)
+    {
+        if (writable_)
+            msync(map_, size_, MS_SYNC);
+        munmap(map_, size_);
+    }
+    if (fd_ >= 0)
+        close(fd_);
+}
+
+ColumnFile ColumnFile::create(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw systemError(path);
+    ColumnFile file(fd, true);
+    if (ftruncate(fd, HEADER_SIZE) < 0)
+        throw systemError(path);
+    file.map(HEADER_SIZE);
+    memcpy(file.header()->magic, MAGIC, sizeof(MAGIC));
+    file.header()->blockRows = BLOCK_ROWS;
+    return file;
+}
+
+ColumnFile ColumnFile::open(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw systemError(path);
+    ColumnFile file(fd, false);
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+        throw systemError(path);
+    if (static_cast<size_t>(st.st_size) < HEADER_SIZE)
+        throw std::runtime_error(path + ": not a telemetry column file");
+    file.map(st.st_size);
+    const ColumnHeader *h = file.header();
+    if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->blockRows != BLOCK_ROWS
+        || HEADER_SIZE + file.blockCount() * BLOCK_SIZE > file.size_)
+        throw std::runtime_error(path + ": not a telemetry column file");
+    return file;
+}
+
+void ColumnFile::map(size_t size)
+{
+    void *p;
+    if (map_)
+        p = mremap(map_, size_, size, MREMAP_MAYMOVE);
+    else
+        p = mmap(nullptr, size, writable_ ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED)
+        throw systemError("mmap");
+    map_ = p;
+    size_ = size;
+    if (!writable_)
+        madvise(map_, size_, MADV_SEQUENTIAL);
+}
+
+// Adds one block to the end of the file
+void ColumnFile::grow()
+{
+    size_t size = size_ + BLOCK_SIZE;
+    if (ftruncate(fd_, size) < 0)
+        throw systemError("ftruncate");
+    map(size);
+}
+
+ColumnBlock ColumnFile::block(size_t index) const
+{
+    uint8_t *base = static_cast<uint8_t *>(map_) + HEADER_SIZE + index * BLOCK_SIZE;
+    uint64_t first = index * BLOCK_ROWS;
+    ColumnBlock b;
+    b.seconds = reinterpret_cast<uint32_t *>(base + SECONDS_OFFSET);
+    b.ticks = reinterpret_cast<uint32_t *>(base + TICKS_OFFSET);
+    b.sequence = reinterpret_cast<uint16_t *>(base + SEQUENCE_OFFSET);
+    b.subseconds = reinterpret_cast<uint16_t *>(base + SUBSECONDS_OFFSET);
+    b.level = reinterpret_cast<uint16_t *>(base + LEVEL_OFFSET);
+    b.motor = reinterpret_cast<uint16_t *>(base + MOTOR_OFFSET);
+    b.flags = base + FLAGS_OFFSET;
+    b.rows = rows() - first < BLOCK_ROWS ? rows() - first : BLOCK_ROWS;
+    return b;
+}
+
+void ColumnFile::append(const Packet *packets, size_t count)
+{
+    while (count)
+    {
+        uint64_t row = rows();
+        size_t offset = row % BLOCK_ROWS;
+        if (offset == 0)
+            grow();
+        ColumnBlock b = block(row / BLOCK_ROWS);
+        size_t n = BLOCK_ROWS - offset < count ? BLOCK_ROWS - offset : count;
+        for (size_t i = 0; i < n; i++)
+        {
+            const Packet &p = packets[i];
+            b.sequence[offset + i] = p.sequence;
+            b.seconds[offset + i] = p.seconds;
+            b.subseconds[offset + i] = p.subseconds;
+            b.level[offset + i] = p.level;
+            b.ticks[offset + i] = p.ticks;
+            b.motor[offset + i] = p.motor;
+            b.flags[offset + i] = p.flags;
+        }
+        header()->rows = row + n;
+        packets += n;
+        count -= n;
+    }
+}
+
+void ColumnFile::setStats(const ParserStats &stats)
+{
+    header()->stats = stats;
+}
+
+void ColumnFile::sync()
+{
+    if (msync(map_, size_, MS_SYNC) < 0)
+        throw systemError("msync");
+}
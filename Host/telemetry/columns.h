@@ -0,0 +1,70 @@
+// Columnar telemetry file
+
+// Header followed by blocks of BLOCK_ROWS rows. Each block stores every field
+// as its own array, so a scan over one field touches only that field's pages.
+// The file is memory mapped: the writer grows it a block at a time and the
+// reader maps it read only.
+
+#ifndef COLUMNS_H_
+#define COLUMNS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "packet.h"
+
+struct ColumnHeader
+{
+    char magic[8];
+    uint64_t rows;
+    uint64_t blockRows;
+    ParserStats stats;
+};
+
+// Field arrays of one block
+struct ColumnBlock
+{
+    uint16_t *sequence;
+    uint32_t *seconds;
+    uint16_t *subseconds;
+    uint16_t *level;
+    uint32_t *ticks;
+    uint16_t *motor;
+    uint8_t *flags;
+    size_t rows;
+};
+
+class ColumnFile
+{
+public:
+    static constexpr uint64_t BLOCK_ROWS = 65536;
+
+    // Creates (truncating) or opens an existing file
+    static ColumnFile create(const std::string &path);
+    static ColumnFile open(const std::string &path);
+    ColumnFile(ColumnFile &&other);
+    ~ColumnFile();
+
+    void append(const Packet *packets, size_t count);
+    void setStats(const ParserStats &stats);
+    // Writes the header and mapped blocks back to the file
+    void sync();
+
+    uint64_t rows() const { return header()->rows; }
+    const ParserStats &stats() const { return header()->stats; }
+    size_t blockCount() const { return (rows() + BLOCK_ROWS - 1) / BLOCK_ROWS; }
+    ColumnBlock block(size_t index) const;
+
+private:
+    ColumnFile(int fd, bool writable);
+    ColumnHeader *header() const { return static_cast<ColumnHeader *>(map_); }
+    void map(size_t size);
+    void grow();
+
+    int fd_;
+    bool writable_;
+    void *map_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif
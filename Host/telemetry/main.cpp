@@ -0,0 +1,257 @@
+// Feeder telemetry tool
+//
+// feedertool record INPUT OUTPUT [--baud N]
+//   Decodes a serial device, pty, capture file or "-" (stdin) into a column file
+//   Stops at end of input or on SIGINT/SIGTERM
+// feedertool analyze FILE [--bin TICKS] [--no-timeline]
+// feedertool dump FILE [FIRST [COUNT]]
+// feedertool synth OUTPUT COUNT [--corrupt PERCENT]
+//   Writes a raw capture of simulated packets with optional damage, for replay tests
+
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "analyze.h"
+#include "columns.h"
+#include "packet.h"
+#include "source.h"
+
+namespace
+{
+
+volatile sig_atomic_t stopRequested = 0;
+
+void requestStop(int)
+{
+    stopRequested = 1;
+}
+
+// Installed without SA_RESTART so a blocked read returns
+void installStopHandler()
+{
+    struct sigaction action = {};
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+void usage()
+{
+    fprintf(stderr,
+            "usage: feedertool record INPUT OUTPUT [--baud N]\n"
+            "       feedertool analyze FILE [--bin TICKS] [--no-timeline]\n"
+            "       feedertool dump FILE [FIRST [COUNT]]\n"
+            "       feedertool synth OUTPUT COUNT [--corrupt PERCENT]\n");
+    exit(2);
+}
+
+uint32_t toNumber(const char *s)
+{
+    char *end;
+    unsigned long value = strtoul(s, &end, 0);
+    if (*s == '\0' || *end != '\0' || value > UINT32_MAX)
+        throw std::runtime_error(std::string("invalid number ") + s);
+    return value;
+}
+
+int record(int argc, char **argv)
+{
+    if (argc < 2)
+        usage();
+    uint32_t baud = 19200;
+    for (int i = 2; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--baud") && i + 1 < argc)
+            baud = toNumber(argv[++i]);
+        else
+            usage();
+    }
+
+    Source source(argv[0], baud);
+    ColumnFile file = ColumnFile::create(argv[1]);
+    static PacketParser parser;
+    installStopHandler();
+
+    auto sink = [&file](const Packet *packets, size_t count) { file.append(packets, count); };
+    auto start = std::chrono::steady_clock::now();
+    size_t n;
+    while (!stopRequested)
+    {
+        n = source.read(parser.space(), parser.spaceLength());
+        if (n == 0)
+            break;
+        parser.commit(n, sink);
+        file.setStats(parser.stats());
+    }
+    file.sync();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const ParserStats &s = parser.stats();
+    fprintf(stderr, "%" PRIu64 " bytes, %" PRIu64 " packets, %" PRIu64 " skipped bytes, %" PRIu64
+            " crc errors, %" PRIu64 " dropped packets\n",
+            s.bytes, s.packets, s.skippedBytes, s.crcErrors, s.droppedPackets);
+    if (!source.isTerminal() && elapsed > 0)
+        fprintf(stderr, "%.3f s, %.1f MB/s, %.2f Mpackets/s\n", elapsed, s.bytes / elapsed / 1e6,
+                s.packets / elapsed / 1e6);
+    return 0;
+}
+
+int analyzeFile(int argc, char **argv)
+{
+    if (argc < 1)
+        usage();
+    AnalyzeOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--bin") && i + 1 < argc)
+            options.binTicks = toNumber(argv[++i]);
+        else if (!strcmp(argv[i], "--no-timeline"))
+            options.timeline = false;
+        else
+            usage();
+    }
+    if (options.binTicks == 0)
+        throw std::runtime_error("bin width must be non-zero");
+    ColumnFile file = ColumnFile::open(argv[0]);
+    analyze(file, options, stdout);
+    return 0;
+}
+
+int dump(int argc, char **argv)
+{
+    if (argc < 1 || argc > 3)
+        usage();
+    ColumnFile file = ColumnFile::open(argv[0]);
+    uint64_t first = argc > 1 ? toNumber(argv[1]) : 0;
+    uint64_t count = argc > 2 ? toNumber(argv[2]) : file.rows();
+    uint64_t end = first + count < file.rows() ? first + count : file.rows();
+    printf("row,sequence,seconds,subseconds,level,ticks,motor,flags\n");
+    for (uint64_t row = first; row < end; row++)
+    {
+        ColumnBlock b = file.block(row / ColumnFile::BLOCK_ROWS);
+        size_t i = row % ColumnFile::BLOCK_ROWS;
+        printf("%" PRIu64 ",%u,%u,%u,%u,%u,%u,%u\n", row, b.sequence[i], b.seconds[i], b.subseconds[i],
+               b.level[i], b.ticks[i], b.motor[i], b.flags[i]);
+    }
+    return 0;
+}
+
+void put16(uint8_t *p, uint16_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+void put32(uint8_t *p, uint32_t value)
+{
+    put16(p, value);
+    put16(p + 2, value >> 16);
+}
+
+// Simulated feeder: level drifts down, the pump refills below 300 mL and the
+// food motor runs 5 s of every 10 minutes, at 10 packets per second
+int synth(int argc, char **argv)
+{
+    if (argc < 2)
+        usage();
+    uint32_t count = toNumber(argv[1]);
+    uint32_t corrupt = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--corrupt") && i + 1 < argc)
+            corrupt = toNumber(argv[++i]);
+        else
+            usage();
+    }
+    FILE *out = strcmp(argv[0], "-") ? fopen(argv[0], "wb") : stdout;
+    if (!out)
+        throw std::runtime_error(std::string(argv[0]) + ": " + strerror(errno));
+
+    std::mt19937 random(1);
+    std::normal_distribution<double> noise(0, 20);
+    std::vector<uint8_t> buffer;
+    double level = 500;
+    bool pump = false;
+    for (uint32_t n = 0; n < count; n++)
+    {
+        uint32_t tenths = n;
+        bool motor = tenths % 6000 < 50;
+        if (level < 300)
+            pump = true;
+        if (level > 480)
+            pump = false;
+        level += pump ? 0.5 : -0.01;
+
+        uint8_t p[TELEMETRY_PACKET_SIZE];
+        put16(p, TELEMETRY_SYNC);
+        put16(p + 2, n);
+        put32(p + 4, tenths / 10);
+        put16(p + 8, tenths % 10 * 3277);
+        put16(p + 10, static_cast<uint16_t>(level));
+        put32(p + 12, static_cast<uint32_t>(40000 + level * 10 + noise(random)));
+        put16(p + 16, motor ? 10000 : 0);
+        p[18] = (pump ? TELEMETRY_PUMP : 0) | (motor ? TELEMETRY_MOTOR : 0);
+        p[19] = 0;
+        put16(p + 20, packetCrc(p, TELEMETRY_PACKET_SIZE - 2));
+
+        // Damage: flipped bit, dropped packet or line noise
+        if (corrupt && random() % 100 < corrupt)
+        {
+            switch (random() % 3)
+            {
+                case 0:
+                    p[random() % TELEMETRY_PACKET_SIZE] ^= 1 << (random() % 8);
+                    break;
+                case 1:
+                    continue;
+                case 2:
+                    for (uint32_t i = random() % 8; i; i--)
+                        buffer.push_back(random());
+                    break;
+            }
+        }
+        buffer.insert(buffer.end(), p, p + TELEMETRY_PACKET_SIZE);
+        if (buffer.size() >= 1 << 20)
+        {
+            fwrite(buffer.data(), 1, buffer.size(), out);
+            buffer.clear();
+        }
+    }
+    fwrite(buffer.data(), 1, buffer.size(), out);
+    if (out != stdout)
+        fclose(out);
+    return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+        usage();
+    try
+    {
+        std::string command = argv[1];
+        if (command == "record")
+            return record(argc - 2, argv + 2);
+        if (command == "analyze")
+            return analyzeFile(argc - 2, argv + 2);
+        if (command == "dump")
+            return dump(argc - 2, argv + 2);
+        if (command == "synth")
+            return synth(argc - 2, argv + 2);
+        usage();
+    }
+    catch (const std::exception &e)
+    {
+        fprintf(stderr, "feedertool: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,65 @@
+// Telemetry packet decoding
+
+#include "packet.h"
+
+namespace
+{
+
+// CRC-16/CCITT-FALSE, byte at a time
+struct CrcTable
+{
+    uint16_t value[256];
+    CrcTable()
+    {
+        for (int i = 0; i < 256; i++)
+        {
+            uint16_t crc = i << 8;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+            value[i] = crc;
+        }
+    }
+};
+
+const CrcTable crcTable;
+
+uint16_t get16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+}
+
+uint16_t packetCrc(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++)
+        crc = (crc << 8) ^ crcTable.value[(crc >> 8) ^ data[i]];
+    return crc;
+}
+
+// Appends the packet at p to the batch, false if its CRC does not match
+bool PacketParser::decode(const uint8_t *p)
+{
+    if (packetCrc(p, TELEMETRY_PACKET_SIZE - 2) != get16(p + TELEMETRY_PACKET_SIZE - 2))
+        return false;
+    Packet &packet = batch_[batchLength_++];
+    packet.sequence = get16(p + 2);
+    packet.seconds = get32(p + 4);
+    packet.subseconds = get16(p + 8);
+    packet.level = get16(p + 10);
+    packet.ticks = get32(p + 12);
+    packet.motor = get16(p + 16);
+    packet.flags = p[18];
+    if (haveSequence_ && packet.sequence != nextSequence_)
+        stats_.droppedPackets += static_cast<uint16_t>(packet.sequence - nextSequence_);
+    haveSequence_ = true;
+    nextSequence_ = packet.sequence + 1;
+    stats_.packets++;
+    return true;
+}
@@ -0,0 +1,126 @@
+// Telemetry packet decoding
+
+// Packet layout and flags are defined by the firmware in Project/telemetry.h.
+// Input is read straight into the parser's buffer (space()/commit()), so bytes
+// are never copied except for the tail of a packet split between reads.
+// After corruption the parser resynchronizes on the next sync word whose
+// packet passes the CRC. Decoded packets are handed out in batches, nothing
+// is allocated per packet.
+
+#ifndef PACKET_H_
+#define PACKET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "telemetry.h"
+
+struct Packet
+{
+    uint16_t sequence;
+    uint32_t seconds;
+    uint16_t subseconds;
+    uint16_t level;
+    uint32_t ticks;
+    uint16_t motor;
+    uint8_t flags;
+};
+
+struct ParserStats
+{
+    uint64_t bytes = 0;
+    uint64_t packets = 0;
+    uint64_t skippedBytes = 0;                      // bytes outside of valid packets
+    uint64_t crcErrors = 0;
+    uint64_t droppedPackets = 0;                    // sequence number gaps
+};
+
+uint16_t packetCrc(const uint8_t *data, size_t length);
+
+class PacketParser
+{
+public:
+    static constexpr size_t CAPACITY = 1 << 16;
+    static constexpr size_t BATCH = 4096;
+
+    uint8_t *space() { return buffer_ + length_; }
+    size_t spaceLength() const { return CAPACITY - length_; }
+
+    // Decodes the n bytes written at space(), calling sink(const Packet *, size_t)
+    // for each batch of packets
+    template <typename Sink>
+    void commit(size_t n, Sink &&sink);
+
+    template <typename Sink>
+    void feed(const uint8_t *data, size_t length, Sink &&sink);
+
+    const ParserStats &stats() const { return stats_; }
+
+private:
+    bool decode(const uint8_t *p);
+
+    uint8_t buffer_[CAPACITY];
+    size_t length_ = 0;
+    Packet batch_[BATCH];
+    size_t batchLength_ = 0;
+    bool haveSequence_ = false;
+    uint16_t nextSequence_ = 0;
+    ParserStats stats_;
+};
+
+template <typename Sink>
+void PacketParser::commit(size_t n, Sink &&sink)
+{
+    const uint8_t sync0 = TELEMETRY_SYNC & 0xFF;
+    const uint8_t sync1 = TELEMETRY_SYNC >> 8;
+    size_t i = 0;
+    stats_.bytes += n;
+    length_ += n;
+    while (length_ - i >= TELEMETRY_PACKET_SIZE)
+    {
+        const uint8_t *p = buffer_ + i;
+        if (p[0] != sync0 || p[1] != sync1)
+        {
+            const void *next = memchr(p + 1, sync0, length_ - i - 1);
+            size_t skip = next ? static_cast<const uint8_t *>(next) - p : length_ - i;
+            stats_.skippedBytes += skip;
+            i += skip;
+            continue;
+        }
+        if (!decode(p))
+        {
+            stats_.crcErrors++;
+            stats_.skippedBytes++;
+            i++;
+            continue;
+        }
+        i += TELEMETRY_PACKET_SIZE;
+        if (batchLength_ == BATCH)
+        {
+            sink(static_cast<const Packet *>(batch_), batchLength_);
+            batchLength_ = 0;
+        }
+    }
+    if (batchLength_)
+    {
+        sink(static_cast<const Packet *>(batch_), batchLength_);
+        batchLength_ = 0;
+    }
+    memmove(buffer_, buffer_ + i, length_ - i);
+    length_ -= i;
+}
+
+template <typename Sink>
+void PacketParser::feed(const uint8_t *data, size_t length, Sink &&sink)
+{
+    while (length)
+    {
+        size_t n = length < spaceLength() ? length : spaceLength();
+        memcpy(space(), data, n);
+        commit(n, sink);
+        data += n;
+        length -= n;
+    }
+}
+
+#endif
@@ -0,0 +1,79 @@
+// Telemetry input
+
+#include "source.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+
+speed_t toSpeed(uint32_t baud)
+{
+    switch (baud)
+    {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 500000: return B500000;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        case 4000000: return B4000000;
+    }
+    throw std::runtime_error("unsupported baud rate " + std::to_string(baud));
+}
+
+std::runtime_error systemError(const std::string &what)
+{
+    return std::runtime_error(what + ": " + strerror(errno));
+}
+
+}
+
+Source::Source(const std::string &path, uint32_t baud)
+{
+    if (path == "-")
+        fd_ = STDIN_FILENO;
+    else if ((fd_ = open(path.c_str(), O_RDONLY | O_NOCTTY)) < 0)
+        throw systemError(path);
+    terminal_ = isatty(fd_);
+    if (terminal_)
+    {
+        termios tio;
+        if (tcgetattr(fd_, &tio) < 0)
+            throw systemError(path);
+        cfmakeraw(&tio);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        cfsetispeed(&tio, toSpeed(baud));
+        cfsetospeed(&tio, toSpeed(baud));
+        if (tcsetattr(fd_, TCSANOW, &tio) < 0)
+            throw systemError(path);
+    }
+}
+
+Source::~Source()
+{
+    if (fd_ != STDIN_FILENO)
+        close(fd_);
+}
+
+size_t Source::read(uint8_t *data, size_t length)
+{
+    ssize_t n = ::read(fd_, data, length);
+    if (n >= 0)
+        return n;
+    if (errno == EINTR)
+        return 0;
+    throw systemError("read");
+}
@@ -0,0 +1,31 @@
+// Telemetry input
+
+// Reads a serial device, a pty or a captured file ("-" is stdin).
+// Terminals are switched to raw mode at the requested baud rate.
+
+#ifndef SOURCE_H_
+#define SOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Source
+{
+public:
+    Source(const std::string &path, uint32_t baud);
+    ~Source();
+    Source(const Source &) = delete;
+    Source &operator=(const Source &) = delete;
+
+    // Bytes read, 0 at end of input or when interrupted by a signal
+    // Throws on errors
+    size_t read(uint8_t *data, size_t length);
+    bool isTerminal() const { return terminal_; }
+
+private:
+    int fd_;
+    bool terminal_;
+};
+
+#endif
@@ -0,0 +1,283 @@
+// uart0 command library benchmark
+
+// Measures the command line path of Project/uart0.c, and Project/format.c
+// next to the snprintf() it replaced, in the style of Google Benchmark: each
+// case runs in growing batches until it has taken at least --min-time
+// seconds, then reports the time per line and the rate.
+//   uart0bench [--min-time=SECONDS] [--filter=TEXT]
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "stub.h"
+#include "uart0.h"
+#include "format.h"
+
+#define LINE_COUNT (sizeof(lines) / sizeof(lines[0]))
+
+typedef struct _BENCHMARK
+{
+    const char *name;
+    const char *unit;                       // what one iteration processes, plural
+    uint64_t (*run)(uint64_t iterations);   // returns the bytes processed
+} BENCHMARK;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// A provisioning session, and a few lines the command loop rejects
+static const char *lines[] =
+{
+    "feed 0 5 50 7 30", "feed 1 8 80 18 0", "feed 2 3 60 12 15", "water 300", "fill auto",
+    "alert on", "time 12 30", "time", "history 7", "telemetry binary 100", "feed 3 delete",
+    "log", "latency", "fill motion", "bogus command with several words 1 2 3",
+    "feed 99999999999 12345678901234567890 77 88 99 and more fields than fit",
+};
+
+static uint8_t stream[16384];
+static size_t streamLength = 0;
+static volatile int32_t sink;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static double seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static uint64_t parseLines(uint64_t iterations)
+{
+    USER_DATA data;
+    uint64_t bytes = 0;
+    uint64_t i;
+    for (i = 0; i < iterations; i++)
+    {
+        const char *line = lines[i % LINE_COUNT];
+        strcpy(data.buffer, line);
+        parseFields(&data);
+        sink = data.fieldCount;
+        bytes += strlen(line);
+    }
+    return bytes;
+}
+
+// parseFields() and the Lab8 command loop's isCommand() and getFieldInteger() calls
+static uint64_t dispatchLines(uint64_t iterations)
+{
+    USER_DATA data;
+    uint64_t bytes = 0;
+    uint64_t i;
+    uint8_t field;
+    for (i = 0; i < iterations; i++)
+    {
+        const char *line = lines[i % LINE_COUNT];
+        strcpy(data.buffer, line);
+        parseFields(&data);
+        bytes += strlen(line);
+        if (isCommand(&data, "time", 2) || isCommand(&data, "time", 0) || isCommand(&data, "feed", 5)
+            || isCommand(&data, "feed", 2) || isCommand(&data, "water", 1) || isCommand(&data, "fill", 1)
+            || isCommand(&data, "alert", 1) || isCommand(&data, "history", 1)
+            || isCommand(&data, "telemetry", 2) || isCommand(&data, "latency", 0)
+            || isCommand(&data, "log", 0))
+        {
+            for (field = 1; field < data.fieldCount; field++)
+                sink = getFieldInteger(&data, field);
+        }
+    }
+    return bytes;
+}
+
+// getsUart0() reading the lines from the stubbed receive fifo, then parseFields()
+static uint64_t receiveLines(uint64_t iterations)
+{
+    USER_DATA data;
+    uint64_t bytes = 0;
+    uint64_t i;
+    stubUart0Input(stream, streamLength);
+    for (i = 0; i < iterations; i++)
+    {
+        if (!stubUart0Pending())
+            stubUart0Input(stream, streamLength);
+        getsUart0(&data);
+        parseFields(&data);
+        bytes += strlen(lines[i % LINE_COUNT]) + 1;
+    }
+    return bytes;
+}
+
+static uint64_t sendLines(uint64_t iterations)
+{
+    char line[MAX_CHARS + 2];
+    uint64_t bytes = 0;
+    uint64_t i;
+    size_t length;
+    for (i = 0; i < iterations; i++)
+    {
+        if (i % 256 == 0)
+            stubUart0ClearOutput();
+        snprintf(line, sizeof(line), "%s\n", lines[i % LINE_COUNT]);
+        putsUart0(line);
+        bytes += strlen(line);
+    }
+    stubUart0Output(&length);
+    return bytes;
+}
+
+// The Lab8 status lines, formatted by formatString() or by snprintf()
+static uint64_t formatLines(uint64_t iterations, bool library)
+{
+    char line[100];
+    uint64_t bytes = 0;
+    uint64_t i;
+    int32_t n;
+    for (i = 0; i < iterations; i++)
+    {
+        n = (int32_t)i;
+        switch (i % 4)
+        {
+        case 0:
+            bytes += library ? snprintf(line, sizeof(line), "Event[%d] --> Dur:%d   PWM:%d   Hr:%d   Min:%d\n",
+                                        n % 10, n % 60, n % 100, n % 24, n % 60)
+                             : formatString(line, sizeof(line), "Event[%d] --> Dur:%d   PWM:%d   Hr:%d   Min:%d\n",
+                                            n % 10, n % 60, n % 100, n % 24, n % 60);
+            break;
+        case 1:
+            bytes += library ? snprintf(line, sizeof(line), "Day %d %02d:%02d:%02d %s %d\n", n % 7, n % 24, n % 60,
+                                        n % 60, "feed", n % 10)
+                             : formatString(line, sizeof(line), "Day %d %02d:%02d:%02d %s %d\n", n % 7, n % 24,
+                                            n % 60, n % 60, "feed", n % 10);
+            break;
+        case 2:
+            bytes += library ? snprintf(line, sizeof(line), "%02d:%02d:%02d.%03d %s %d\n", n % 24, n % 60, n % 60,
+                                        n % 1000, "water", n)
+                             : formatString(line, sizeof(line), "%02d:%02d:%02d.%03d %s %d\n", n % 24, n % 60,
+                                            n % 60, n % 1000, "water", n);
+            break;
+        default:
+            bytes += library ? snprintf(line, sizeof(line), "%s: %d cycles (%d.%d us)\n", "uart0Isr", n % 4000,
+                                        n % 4000 / 40, n % 4000 / 4 % 10)
+                             : formatString(line, sizeof(line), "%s: %d cycles (%.1q us)\n", "uart0Isr", n % 4000,
+                                            n % 4000 / 4);
+            break;
+        }
+        sink = line[0];
+    }
+    return bytes;
+}
+
+static uint64_t formatStringLines(uint64_t iterations)
+{
+    return formatLines(iterations, false);
+}
+
+static uint64_t snprintfLines(uint64_t iterations)
+{
+    return formatLines(iterations, true);
+}
+
+// An event line through putfUart0(), or snprintf() then putsUart0()
+static uint64_t printLines(uint64_t iterations, bool library)
+{
+    char line[100];
+    uint64_t i;
+    size_t length;
+    for (i = 0; i < iterations; i++)
+    {
+        if (i % 256 == 0)
+            stubUart0ClearOutput();
+        if (library)
+        {
+            snprintf(line, sizeof(line), "Event[%d] --> Dur:%d   PWM:%d   Hr:%d   Min:%d\n", (int)(i % 10), 30, 80, 18, 0);
+            putsUart0(line);
+        }
+        else
+            putfUart0("Event[%d] --> Dur:%d   PWM:%d   Hr:%d   Min:%d\n", (int)(i % 10), 30, 80, 18, 0);
+    }
+    stubUart0Output(&length);
+    return iterations * 45;
+}
+
+static uint64_t putfLines(uint64_t iterations)
+{
+    return printLines(iterations, false);
+}
+
+static uint64_t snprintfPutsLines(uint64_t iterations)
+{
+    return printLines(iterations, true);
+}
+
+static const BENCHMARK benchmarks[] =
+{
+    {"parseFields", "lines", parseLines},
+    {"dispatch", "lines", dispatchLines},
+    {"getsUart0+parseFields", "lines", receiveLines},
+    {"putsUart0", "lines", sendLines},
+    {"formatString", "lines", formatStringLines},
+    {"snprintf", "lines", snprintfLines},
+    {"putfUart0", "lines", putfLines},
+    {"snprintf+putsUart0", "lines", snprintfPutsLines},
+};
+
+int main(int argc, char *argv[])
+{
+    double minTime = 0.5;
+    const char *filter = "";
+    uint64_t iterations, bytes;
+    double start, elapsed;
+    size_t i;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strncmp(argv[arg], "--min-time=", 11) == 0)
+            minTime = atof(argv[arg] + 11);
+        else if (strncmp(argv[arg], "--filter=", 9) == 0)
+            filter = argv[arg] + 9;
+        else
+        {
+            fprintf(stderr, "usage: %s [--min-time=SECONDS] [--filter=TEXT]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // The receive stream is the lines ending in returns, as typed
+    for (i = 0; i < LINE_COUNT; i++)
+    {
+        memcpy(&stream[streamLength], lines[i], strlen(lines[i]));
+        streamLength += strlen(lines[i]);
+        stream[streamLength++] = 13;
+    }
+
+    printf("%-24s %14s %14s %15s %9s\n", "Benchmark", "Time", "Iterations", "Rate", "Bytes/s");
+    printf("-------------------------------------------------------------------------------------\n");
+    for (i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++)
+    {
+        if (!strstr(benchmarks[i].name, filter))
+            continue;
+        for (iterations = LINE_COUNT; ; iterations *= 2)
+        {
+            start = seconds();
+            bytes = benchmarks[i].run(iterations);
+            elapsed = seconds() - start;
+            if (elapsed >= minTime)
+                break;
+        }
+        printf("%-24s %11.1f ns %14llu %7.2fM %s/s %8.1fM\n", benchmarks[i].name, elapsed * 1e9 / iterations,
+               (unsigned long long)iterations, iterations / elapsed / 1e6, benchmarks[i].unit,
+               bytes / elapsed / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,377 @@
+// uart0 command library checks
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stub.h"
+#include "uart0.h"
+#include "format.h"
+#include "check.h"
+
+#define INPUT_SIZE 4096
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Commands executeCommand() in Lab8 accepts, with their argument counts
+// (macro is split off by runCommandLine() before it gets there)
+static const struct
+{
+    const char *name;
+    uint8_t arguments;
+} commands[] =
+{
+    {"time", 2}, {"time", 0}, {"feed", 5}, {"feed", 2}, {"water", 1}, {"fill", 1},
+    {"alert", 1}, {"history", 1}, {"telemetry", 1}, {"telemetry", 2}, {"latency", 0},
+    {"log", 0}, {"baud", 1}, {"run", 1},
+};
+
+static uint8_t input[INPUT_SIZE + 1];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static bool isLetter(char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static void fail(const char *line, const char *message, int field)
+{
+    fprintf(stderr, "uart0 check failed: %s (field %d)\nline: \"%s\"\n", message, field, line);
+    abort();
+}
+
+// What getsUart0() should return for the bytes from *position, or false if they hold no line
+static bool referenceLine(const uint8_t *data, size_t size, size_t *position, char line[])
+{
+    size_t count = 0;
+    while (*position < size)
+    {
+        char c = data[(*position)++];
+        if ((c == 8 || c == 127) && count > 0)
+            count--;
+        else if (c == 13)
+            break;
+        else if (c >= 32)
+        {
+            line[count++] = c;
+            if (count >= MAX_CHARS)
+                break;
+        }
+        if (*position == size)
+            return false;
+    }
+    line[count] = 0;
+    return true;
+}
+
+static int32_t referenceInteger(const char *text)
+{
+    int64_t value = 0;
+    while (isDigit(*text))
+    {
+        value = value * 10 + (*text++ - '0');
+        if (value > INT32_MAX)
+            return INT32_MAX;
+    }
+    return value;
+}
+
+static void checkLine(const char line[])
+{
+    USER_DATA data;
+    char expected[MAX_CHARS + 1];
+    uint8_t positions[MAX_FIELDS];
+    char types[MAX_FIELDS];
+    uint8_t count = 0;
+    int i;
+
+    // Fields start at a letter after a non-letter or a digit after a non-digit
+    for (i = 0; line[i] != 0 && count < MAX_FIELDS; i++)
+    {
+        char previous = i ? line[i - 1] : 0;
+        if (isLetter(line[i]) && !isLetter(previous))
+            types[count] = 'a';
+        else if (isDigit(line[i]) && !isDigit(previous))
+            types[count] = 'n';
+        else
+            continue;
+        positions[count++] = i;
+    }
+    for (i = 0; line[i] != 0; i++)
+        expected[i] = isLetter(line[i]) || isDigit(line[i]) ? line[i] : 0;
+    expected[i] = 0;
+
+    strcpy(data.buffer, line);
+    parseFields(&data);
+
+    if (data.fieldCount != count)
+        fail(line, "field count", data.fieldCount);
+    if (memcmp(data.buffer, expected, i + 1) != 0)
+        fail(line, "delimiters", -1);
+    for (i = 0; i < count; i++)
+    {
+        if (data.fieldPosition[i] != positions[i] || data.fieldType[i] != types[i])
+            fail(line, "field position or type", i);
+        if (getFieldString(&data, i) != &data.buffer[positions[i]])
+            fail(line, "getFieldString", i);
+        if (getFieldInteger(&data, i) != (types[i] == 'n' ? referenceInteger(&data.buffer[positions[i]]) : 0))
+            fail(line, "getFieldInteger", i);
+    }
+    for (; i <= MAX_FIELDS; i++)
+        if (getFieldString(&data, i) != NULL || getFieldInteger(&data, i) != 0)
+            fail(line, "field past the end", i);
+
+    for (i = 0; i < (int)(sizeof(commands) / sizeof(commands[0])); i++)
+    {
+        bool match = data.buffer[0] != 0 && strncmp(data.buffer, commands[i].name, strlen(commands[i].name)) == 0
+                     && count == commands[i].arguments + 1;
+        if (isCommand(&data, commands[i].name, commands[i].arguments) != match)
+            fail(line, "isCommand", i);
+    }
+}
+
+void checkInput(const uint8_t *data, size_t size)
+{
+    USER_DATA user;
+    char line[MAX_CHARS + 1];
+    char echo[4 * MAX_CHARS + 1];
+    size_t position = 0;
+    size_t length;
+    const char *output;
+    int i;
+
+    // Lines are read until the input runs out, the last one is completed with a return
+    if (size > INPUT_SIZE)
+        size = INPUT_SIZE;
+    memcpy(input, data, size);
+    input[size] = 13;
+    stubUart0Input(input, size + 1);
+    while (stubUart0Pending())
+    {
+        if (!referenceLine(input, size + 1, &position, line))
+            break;
+        getsUart0(&user);
+        if (strcmp(user.buffer, line) != 0 || stubUart0Pending() != size + 1 - position)
+            fail(line, "getsUart0", -1);
+        checkLine(user.buffer);
+
+        // Echoed back 4 times in one string, longer than a uint8_t index can reach
+        length = strlen(line);
+        for (i = 0; i < 4; i++)
+            memcpy(&echo[i * length], line, length + 1);
+        stubUart0ClearOutput();
+        putsUart0(echo);
+        output = stubUart0Output(&length);
+        if (length != strlen(echo) || memcmp(output, echo, length) != 0)
+            fail(line, "putsUart0", -1);
+    }
+}
+
+void checkCommands(const uint8_t *data, size_t size)
+{
+    USER_DATA user;
+    char *line = (char *)input;
+    char *start, *end;
+    size_t length;
+
+    // The bytes up to the first 0 are the line, as getsUart0Line() would return it
+    if (size > INPUT_SIZE)
+        size = INPUT_SIZE;
+    memcpy(input, data, size);
+    input[size] = 0;
+    while (*line != 0)
+    {
+        for (start = line; *start == ' '; start++);
+        for (end = start; *end != 0 && *end != ';'; end++);
+        length = end - start;
+
+        if (getCommand(&line, &user) != (length <= MAX_CHARS))
+            fail(start, "getCommand length", (int)length);
+        if (line != end + (*end == ';'))
+            fail(start, "getCommand next", (int)length);
+        if (length > MAX_CHARS)
+            length = MAX_CHARS;
+        if (strlen(user.buffer) != length || memcmp(user.buffer, start, length) != 0)
+            fail(start, "getCommand", (int)length);
+        checkLine(user.buffer);
+    }
+}
+
+// What %.Nq should print, built with snprintf() from the integer and fraction parts
+static void referenceFixed(char text[], size_t size, const char flags[], int width, int decimals, int32_t value)
+{
+    char number[32];
+    uint32_t magnitude = value < 0 ? 0 - (uint32_t)value : (uint32_t)value;
+    uint64_t scale = 1;
+    int i, pad;
+
+    if (decimals > FORMAT_MAX_DECIMALS)
+        decimals = FORMAT_MAX_DECIMALS;
+    for (i = 0; i < decimals; i++)
+        scale *= 10;
+    if (decimals > 0)
+        snprintf(number, sizeof(number), "%s%u.%0*u", value < 0 ? "-" : "", (unsigned)(magnitude / scale), decimals,
+                 (unsigned)(magnitude % scale));
+    else
+        snprintf(number, sizeof(number), "%s%u", value < 0 ? "-" : "", magnitude);
+
+    pad = width - (int)strlen(number);
+    if (strchr(flags, '-'))
+        snprintf(text, size, "%-*s", width, number);
+    else if (strchr(flags, '0') && pad > 0)
+        snprintf(text, size, "%.*s%0*d%s", value < 0, "-", pad, 0, number + (value < 0));
+    else
+        snprintf(text, size, "%*s", width, number);
+}
+
+void checkFormat(const uint8_t *data, size_t size)
+{
+    static const char conversions[] = "duxcsq";
+    static const char *flagSets[] = {"", "0", "-", "0-"};
+    char format[32], expected[160], actual[160];
+    char text[40];
+    const char *flags;
+    char conversion;
+    int width, decimals;
+    uint32_t length, limit;
+    int32_t value;
+    int count;
+
+    if (size < 8)
+        return;
+    conversion = conversions[data[0] % 6];
+    flags = flagSets[data[1] % 4];
+    width = data[2] % 24;
+    decimals = data[3] % 16;                        // past FORMAT_MAX_DECIMALS too
+    memcpy(&value, data + 4, sizeof(value));
+    limit = size > 8 ? data[8] % sizeof(actual) : sizeof(actual);
+    // Zero padding of %c and %s is undefined in C, and not supported by formatString()
+    if (conversion == 'c' || conversion == 's')
+        flags = strchr(flags, '-') ? "-" : "";
+    if (conversion == 'c' && (uint8_t)value == 0)
+        value = '?';
+
+    count = size - 9 < sizeof(text) - 1 ? (int)(size - 9) : (int)sizeof(text) - 1;
+    for (int i = 0; i < count; i++)
+        text[i] = data[9 + i] ? data[9 + i] : '.';
+    text[count > 0 ? count : 0] = 0;
+
+    if (conversion == 'q')
+    {
+        snprintf(format, sizeof(format), "<%%%s%d.%dq>", flags, width, decimals);
+        referenceFixed(actual, sizeof(actual), flags, width, decimals, value);
+        snprintf(expected, sizeof(expected), "<%s>", actual);
+    }
+    else
+    {
+        snprintf(format, sizeof(format), "<%%%s%d%c>", flags, width, conversion);
+        if (conversion == 's')
+            snprintf(expected, sizeof(expected), format, text);
+        else
+            snprintf(expected, sizeof(expected), format, value);
+    }
+
+    memset(actual, '#', sizeof(actual));
+    if (conversion == 's')
+        length = formatString(actual, limit, format, text);
+    else
+        length = formatString(actual, limit, format, value);
+    if (length != strlen(expected))
+        fail(format, "formatString length", (int)length);
+    if (limit > 0 && (strncmp(actual, expected, limit - 1) != 0 ||
+                      actual[length < limit ? length : limit - 1] != 0))
+        fail(format, "formatString text", (int)limit);
+    if (limit < sizeof(actual) && actual[limit] != '#')
+        fail(format, "formatString wrote past the buffer", (int)limit);
+}
+
+// What setUart0BaudRate() should choose, from the exact divisor: 16 clocks
+// per bit unless fcyc is too slow, the closest 1/64, and its error in ppm
+static bool referenceDivisor(uint32_t baudRate, uint32_t fcyc, uint32_t *divisor, bool *hse, double *error)
+{
+    double exact, sampling;
+    if (baudRate == 0)
+        return false;
+    *hse = (double)baudRate * 16 > fcyc;
+    sampling = *hse ? 8 : 16;
+    exact = (double)fcyc * 64 / (sampling * baudRate);
+    if (exact + 0.5 < 64 || exact + 0.5 >= 65536.0 * 64)
+        return false;
+    *divisor = (uint32_t)(exact + 0.5);
+    *error = ((double)fcyc * 64 / (sampling * *divisor * baudRate) - 1) * 1e6;
+    return true;
+}
+
+void checkBaud(const uint8_t *data, size_t size)
+{
+    static const uint32_t clocks[] = {16000000, 40000000, 50000000, 80000000};
+    static const uint32_t rates[] =
+    {
+        1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 1000000
+    };
+    char name[64];
+    uint32_t fcyc, baudRate, divisor, delay, timeoutMs, rate;
+    uint8_t c;
+    int32_t error;
+    double expected;
+    bool hse, valid, set;
+
+    if (size < 9)
+        return;
+    fcyc = clocks[data[0] % 4];
+    memcpy(&baudRate, data + 1, sizeof(baudRate));
+    baudRate = baudRate % (fcyc / 4) + 1;           // past fcyc / 8, where no divisor exists
+    snprintf(name, sizeof(name), "%u baud at %u Hz", baudRate, fcyc);
+
+    stubRegister[STUB_UART0_IBRD] = 0xFFFFFFFF;
+    stubRegister[STUB_UART0_CTL] = 0;
+    error = getUart0BaudError(baudRate, fcyc);
+    set = setUart0BaudRate(baudRate, fcyc);
+    valid = referenceDivisor(baudRate, fcyc, &divisor, &hse, &expected);
+    if (!valid && (error != INT32_MAX || set))
+        fail(name, "getUart0BaudError without a divisor", error);
+    if (valid && (error - expected > 1 || expected - error > 1))
+        fail(name, "getUart0BaudError", error);
+    if (set != (valid && error <= UART0_MAX_BAUD_ERROR && error >= -UART0_MAX_BAUD_ERROR))
+        fail(name, "setUart0BaudRate tolerance", error);
+    if (set && (stubRegister[STUB_UART0_IBRD] != divisor >> 6 || stubRegister[STUB_UART0_FBRD] != (divisor & 63)
+                || !(stubRegister[STUB_UART0_CTL] & UART_CTL_HSE) != !hse
+                || !(stubRegister[STUB_UART0_CTL] & UART_CTL_UARTEN)))
+        fail(name, "setUart0BaudRate divisor", (int)divisor);
+    if (!set && stubRegister[STUB_UART0_IBRD] != 0xFFFFFFFF)
+        fail(name, "setUart0BaudRate changed a rejected rate", error);
+
+    // Auto-baud on one in 8 inputs, it polls the line for the whole timeout
+    // when there is no 'U' on it
+    if (data[5] % 8)
+        return;
+    fcyc = data[0] & 1 ? 80000000 : 40000000;
+    rate = rates[data[6] % 12];
+    c = data[7] & 1 ? 'U' : data[8];
+    delay = 1000 + data[8] * 1000;                  // the line is idle first
+    timeoutMs = ((uint64_t)delay + (uint64_t)fcyc * 20 / rate) * 1000 / fcyc + 1;
+    snprintf(name, sizeof(name), "0x%02X at %u baud, %u Hz, after %u clocks", c, rate, fcyc, delay);
+
+    stubRegister[STUB_GPIO_PORTA_AFSEL] = 3;
+    stubUart0Line(&c, 1, rate, fcyc, delay);
+    baudRate = detectUart0BaudRate(fcyc, timeoutMs);
+    if (baudRate != (c == 'U' ? rate : 0))
+        fail(name, "detectUart0BaudRate", (int)baudRate);
+    if (stubRegister[STUB_GPIO_PORTA_AFSEL] != 3 || stubRegister[STUB_NVIC_ST_CTRL] != 0)
+        fail(name, "detectUart0BaudRate did not restore PA0 and SysTick", -1);
+}
@@ -0,0 +1,29 @@
+// uart0 command library checks
+
+// checkInput() runs a block of received bytes through getsUart0(),
+// parseFields(), getFieldString(), getFieldInteger() and isCommand() the way
+// the firmware's command loop does, and compares every result with a plain
+// reference implementation. checkCommands() splits the bytes as one command
+// line with getCommand() and checks each command the same way. checkFormat() builds one conversion from the
+// bytes and compares formatString() with snprintf(). checkBaud() sets a rate
+// and compares the divisor and error with an exact computation, and runs
+// detectUart0BaudRate() on a character sent at a standard rate. A mismatch
+// prints the line and aborts, so the fuzzer and the test driver report it as
+// a crash with the input saved.
+
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void checkInput(const uint8_t *data, size_t size);
+void checkCommands(const uint8_t *data, size_t size);
+void checkFormat(const uint8_t *data, size_t size);
+void checkBaud(const uint8_t *data, size_t size);
+
+#endif
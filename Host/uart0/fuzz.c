@@ -0,0 +1,28 @@
+// uart0 command library fuzz target
+
+// libFuzzer entry point, built with -fsanitize=fuzzer when the compiler is
+// clang, and linked with fuzzmain.c (a replay and random input driver) when
+// it is not:
+//   uart0fuzz -dict=uart0.dict CORPUS_DIR
+//   uart0fuzz -runs=100000 -seed=1
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stddef.h>
+#include "check.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    checkInput(data, size);
+    checkCommands(data, size);
+    checkFormat(data, size);
+    checkBaud(data, size);
+    return 0;
+}
@@ -0,0 +1,169 @@
+// uart0 fuzz driver without libFuzzer
+
+// Runs the files and directories named on the command line through the fuzz
+// target, then -runs=N inputs generated from -seed=S. The inputs are lines of
+// command words, numbers (some past INT32_MAX), delimiters, backspaces and
+// random bytes. A failing input is written to crash-SEED-RUN before the check
+// aborts, the same as libFuzzer's crash-* files.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <signal.h>
+#include <sys/stat.h>
+
+#define INPUT_SIZE 1024
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const char *tokens[] =
+{
+    "time", "feed", "water", "fill", "alert", "history", "telemetry", "latency", "log", "baud",
+    "run", "macro", "auto", "motion", "on", "off", "delete", "binary", "text", "U", "115200", "1000000",
+    "0", "7", "59", "255", "256", "2147483647", "2147483648", "4294967296", "99999999999999999999",
+    " ", "  ", "\t", ",", ":", ";", "-", ".", "\b", "\x7f", "\r", "\n", "\x80", "\xff",
+};
+
+static uint64_t state;
+static uint8_t input[INPUT_SIZE];
+static size_t inputSize = 0;
+static char crashName[64] = "";
+static uint64_t checked = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// xorshift64*
+static uint32_t randomNumber(uint32_t range)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (uint32_t)((state * 0x2545F4914F6CDD1DULL) >> 32) % range;
+}
+
+static void append(const void *data, size_t length)
+{
+    if (length > INPUT_SIZE - inputSize)
+        length = INPUT_SIZE - inputSize;
+    memcpy(&input[inputSize], data, length);
+    inputSize += length;
+}
+
+static void generate(void)
+{
+    uint32_t count = 1 + randomNumber(randomNumber(8) ? 16 : 200);
+    uint8_t byte;
+    inputSize = 0;
+    while (count--)
+    {
+        switch (randomNumber(8))
+        {
+        case 0:
+            byte = randomNumber(256);
+            append(&byte, 1);
+            break;
+        case 1:
+            byte = '0' + randomNumber(10);
+            while (randomNumber(4))
+                append(&byte, 1);
+            break;
+        default:
+            byte = randomNumber(sizeof(tokens) / sizeof(tokens[0]));
+            append(tokens[byte], strlen(tokens[byte]));
+            break;
+        }
+    }
+}
+
+// Saves the input that is being checked when a check aborts
+static void onAbort(int signal)
+{
+    FILE *file;
+    if (crashName[0] && (file = fopen(crashName, "wb")))
+    {
+        fwrite(input, 1, inputSize, file);
+        fclose(file);
+        fprintf(stderr, "input written to %s\n", crashName);
+    }
+}
+
+static void runFile(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror(path);
+        exit(1);
+    }
+    inputSize = fread(input, 1, INPUT_SIZE, file);
+    fclose(file);
+    LLVMFuzzerTestOneInput(input, inputSize);
+    checked++;
+}
+
+static void runPath(const char *path)
+{
+    struct stat info;
+    DIR *dir;
+    struct dirent *entry;
+    char name[4096];
+    if (stat(path, &info) == 0 && S_ISDIR(info.st_mode) && (dir = opendir(path)))
+    {
+        while ((entry = readdir(dir)))
+        {
+            if (entry->d_name[0] == '.')
+                continue;
+            snprintf(name, sizeof(name), "%s/%s", path, entry->d_name);
+            runFile(name);
+        }
+        closedir(dir);
+    }
+    else
+        runFile(path);
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t runs = 0;
+    uint64_t seed = 1;
+    uint64_t i;
+    int arg;
+
+    signal(SIGABRT, onAbort);
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strncmp(argv[arg], "-runs=", 6) == 0)
+            runs = strtoull(argv[arg] + 6, 0, 10);
+        else if (strncmp(argv[arg], "-seed=", 6) == 0)
+            seed = strtoull(argv[arg] + 6, 0, 10);
+        else if (argv[arg][0] == '-')
+            continue;                               // other libFuzzer options
+        else
+            runPath(argv[arg]);
+    }
+
+    state = seed ? seed : 1;
+    for (i = 0; i < runs; i++)
+    {
+        snprintf(crashName, sizeof(crashName), "crash-%llu-%llu", (unsigned long long)seed,
+                 (unsigned long long)i);
+        generate();
+        LLVMFuzzerTestOneInput(input, inputSize);
+        checked++;
+    }
+    printf("uart0fuzz: %llu inputs passed\n", (unsigned long long)checked);
+    return 0;
+}
@@ -0,0 +1,165 @@
+// UART0 register stub
+
+// Every access to UART0_DR_R calls stubUart0Data(), which cannot tell a read
+// from a write. It loads the next input byte, tagged with STUB_LOADED, into
+// the register. At the next access (or stubUart0Output()) a register that
+// still holds the loaded value was read, anything else was written: the byte
+// goes to the output and the input byte is put back.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stub.h"
+#include "nvic.h"
+
+#define STUB_LOADED     0x10000             // outside the 12 bits the UART returns
+#define OUTPUT_SIZE     65536               // between stubUart0ClearOutput() calls
+#define SPIN_LIMIT      1000000             // empty fifo reads before a wait is a hang
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+volatile uint32_t stubRegister[STUB_REGISTER_COUNT];
+
+static const uint8_t *input = 0;
+static size_t inputLength = 0;
+static size_t inputRead = 0;
+
+static volatile uint32_t data = 0;
+static uint32_t loaded = 0;
+static bool accessed = false;
+static bool consumed = false;
+
+static char output[OUTPUT_SIZE];
+static size_t outputLength = 0;
+static uint32_t spins = 0;
+
+// PA0 waveform, in system clocks since stubUart0Line()
+static uint64_t cycles = 0;
+static const uint8_t *line = 0;
+static size_t lineLength = 0;
+static uint32_t lineBaud = 1;
+static uint32_t lineClock = 1;
+static uint32_t lineDelay = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Settles the last data register access
+static void settle(void)
+{
+    if (accessed && data != loaded)
+    {
+        if (consumed)
+            inputRead--;
+        if (outputLength == OUTPUT_SIZE)
+        {
+            fprintf(stderr, "uart0 stub: output overflow, a write loop did not end\n");
+            abort();
+        }
+        output[outputLength++] = data & 0xFF;
+    }
+    accessed = false;
+}
+
+// The bytes are not copied, they must stay valid until they have been read
+void stubUart0Input(const void *bytes, size_t length)
+{
+    settle();
+    input = bytes;
+    inputLength = length;
+    inputRead = 0;
+}
+
+size_t stubUart0Pending(void)
+{
+    settle();
+    return inputLength - inputRead;
+}
+
+// Bytes written so far, not terminated
+const char *stubUart0Output(size_t *length)
+{
+    settle();
+    *length = outputLength;
+    return output;
+}
+
+void stubUart0ClearOutput(void)
+{
+    settle();
+    outputLength = 0;
+}
+
+volatile uint32_t *stubUart0Data(void)
+{
+    settle();
+    consumed = inputRead < inputLength;
+    loaded = consumed ? input[inputRead++] | STUB_LOADED : STUB_LOADED;
+    data = loaded;
+    accessed = true;
+    spins = 0;
+    return &data;
+}
+
+uint32_t stubUart0Flags(void)
+{
+    settle();
+    if (inputRead < inputLength)
+        return UART_FR_TXFE;
+    if (++spins > SPIN_LIMIT)
+    {
+        fprintf(stderr, "uart0 stub: waiting for input that was never queued\n");
+        abort();
+    }
+    return UART_FR_TXFE | UART_FR_RXFE;
+}
+
+// The characters start, 8N1 and back to back, delay clocks from now
+// The bytes are not copied, they must stay valid until the line is read
+void stubUart0Line(const void *bytes, size_t length, uint32_t baudRate, uint32_t fcyc, uint32_t delay)
+{
+    cycles = 0;
+    line = bytes;
+    lineLength = length;
+    lineBaud = baudRate;
+    lineClock = fcyc;
+    lineDelay = delay;
+}
+
+// PA0 is high when idle and in the stop bit
+uint32_t stubPortAData(void)
+{
+    uint64_t bit;
+    uint32_t position;
+    cycles += STUB_READ_CYCLES;
+    if (cycles < lineDelay)
+        return 1;
+    bit = (cycles - lineDelay) * lineBaud / lineClock;
+    if (bit >= (uint64_t)lineLength * 10)
+        return 1;
+    position = bit % 10;
+    if (position == 0)
+        return 0;
+    if (position == 9)
+        return 1;
+    return (line[bit / 10] >> (position - 1)) & 1;
+}
+
+uint32_t stubSysTickCurrent(void)
+{
+    cycles += STUB_READ_CYCLES;
+    return (uint32_t)(0x00FFFFFF - cycles % 0x01000000);
+}
+
+void enableNvicInterrupt(uint8_t vectorNumber)
+{
+}
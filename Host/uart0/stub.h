@@ -0,0 +1,97 @@
+// UART0 register stub
+
+// Force-included (-include) into Project/uart0.c, so it compiles unchanged
+// against memory instead of the UART. The data register returns the bytes
+// queued with stubUart0Input() and captures the bytes written to it, the
+// flag register reports an empty receive fifo once the input is used up and
+// a transmit fifo that is never full. For detectUart0BaudRate(), every read
+// of PA0 or the SysTick counter takes STUB_READ_CYCLES, and PA0 carries the
+// characters given to stubUart0Line(). The other registers are plain storage.
+
+#ifndef STUB_H_
+#define STUB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "tm4c123gh6pm.h"
+
+typedef enum _STUB_REGISTER
+{
+    STUB_SYSCTL_RCGCUART, STUB_SYSCTL_RCGCGPIO, STUB_GPIO_PORTA_DR2R, STUB_GPIO_PORTA_DEN,
+    STUB_GPIO_PORTA_AFSEL, STUB_GPIO_PORTA_PCTL, STUB_UART0_CTL, STUB_UART0_CC, STUB_UART0_IBRD,
+    STUB_UART0_FBRD, STUB_UART0_LCRH, STUB_UART0_IFLS, STUB_UART0_IM, STUB_UART0_ICR,
+    STUB_NVIC_ST_CTRL, STUB_NVIC_ST_RELOAD,
+    STUB_REGISTER_COUNT
+} STUB_REGISTER;
+
+#define STUB_READ_CYCLES 6
+
+extern volatile uint32_t stubRegister[STUB_REGISTER_COUNT];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void stubUart0Input(const void *data, size_t length);
+size_t stubUart0Pending(void);
+const char *stubUart0Output(size_t *length);
+void stubUart0ClearOutput(void);
+
+volatile uint32_t *stubUart0Data(void);
+uint32_t stubUart0Flags(void);
+
+void stubUart0Line(const void *data, size_t length, uint32_t baudRate, uint32_t fcyc, uint32_t delay);
+uint32_t stubPortAData(void);
+uint32_t stubSysTickCurrent(void);
+
+#undef SYSCTL_RCGCUART_R
+#undef SYSCTL_RCGCGPIO_R
+#undef GPIO_PORTA_DR2R_R
+#undef GPIO_PORTA_DEN_R
+#undef GPIO_PORTA_AFSEL_R
+#undef GPIO_PORTA_PCTL_R
+#undef UART0_CTL_R
+#undef UART0_CC_R
+#undef UART0_IBRD_R
+#undef UART0_FBRD_R
+#undef UART0_LCRH_R
+#undef UART0_IFLS_R
+#undef UART0_IM_R
+#undef UART0_ICR_R
+#undef UART0_DR_R
+#undef UART0_FR_R
+#undef GPIO_PORTA_DATA_R
+#undef NVIC_ST_CTRL_R
+#undef NVIC_ST_RELOAD_R
+#undef NVIC_ST_CURRENT_R
+
+#define SYSCTL_RCGCUART_R       stubRegister[STUB_SYSCTL_RCGCUART]
+#define SYSCTL_RCGCGPIO_R       stubRegister[STUB_SYSCTL_RCGCGPIO]
+#define GPIO_PORTA_DR2R_R       stubRegister[STUB_GPIO_PORTA_DR2R]
+#define GPIO_PORTA_DEN_R        stubRegister[STUB_GPIO_PORTA_DEN]
+#define GPIO_PORTA_AFSEL_R      stubRegister[STUB_GPIO_PORTA_AFSEL]
+#define GPIO_PORTA_PCTL_R       stubRegister[STUB_GPIO_PORTA_PCTL]
+#define UART0_CTL_R             stubRegister[STUB_UART0_CTL]
+#define UART0_CC_R              stubRegister[STUB_UART0_CC]
+#define UART0_IBRD_R            stubRegister[STUB_UART0_IBRD]
+#define UART0_FBRD_R            stubRegister[STUB_UART0_FBRD]
+#define UART0_LCRH_R            stubRegister[STUB_UART0_LCRH]
+#define UART0_IFLS_R            stubRegister[STUB_UART0_IFLS]
+#define UART0_IM_R              stubRegister[STUB_UART0_IM]
+#define UART0_ICR_R             stubRegister[STUB_UART0_ICR]
+#define UART0_DR_R              (*stubUart0Data())
+#define UART0_FR_R              stubUart0Flags()
+#define GPIO_PORTA_DATA_R       stubPortAData()
+#define NVIC_ST_CTRL_R          stubRegister[STUB_NVIC_ST_CTRL]
+#define NVIC_ST_RELOAD_R        stubRegister[STUB_NVIC_ST_RELOAD]
+#define NVIC_ST_CURRENT_R       stubSysTickCurrent()
+
+// TI compiler intrinsics, there is nothing to mask
+#define _disable_interrupts()           0
+#define _enable_interrupts()            0
+#define _restore_interrupts(state)      ((void)(state))
+#define _set_interrupt_priority(pri)    ((void)(pri), 0)
+#define _delay_cycles(cycles)           ((void)(cycles))
+
+#endif
@@ -0,0 +1,129 @@
+// GPIO APB vs AHB toggle and SPI0 transfer benchmarks
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    16 MHz (PIOSC, reset default)
+
+// Hardware configuration:
+// Green LED:
+//   PF3 drives an NPN transistor that powers the green LED
+// SPI0 Interface:
+//   MOSI on PA5 (SSI0Tx), MISO on PA4 (SSI0Rx), ~CS on PA3 (SSI0Fss), SCLK on PA2 (SSI0Clk)
+//   Runs at 4 MHz, so a frame takes at least 8 bits x 4 = 32 cycles
+// Timer 1 is used as a free running 32-bit up counter at the system clock
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "spi0.h"
+
+#define GREEN_LED_MASK 8
+#define TOGGLE_COUNT 1000
+#define SPI_SIZE_COUNT 8
+#define SPI_MAX_SIZE 128
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Results, read with the debugger
+// Both loops run the same code, so the difference is the extra bus cost of the APB aperture
+uint32_t apbCycles = 0;
+uint32_t ahbCycles = 0;
+uint32_t apbCyclesPerToggle = 0;
+uint32_t ahbCyclesPerToggle = 0;
+
+// Cycles per transfer size, one frame at a time with writeSpi0Data() vs FIFO streaming
+const uint32_t spiSizes[SPI_SIZE_COUNT] = {1, 2, 4, 8, 16, 32, 64, 128};
+uint32_t spiFrameCycles[SPI_SIZE_COUNT];
+uint32_t spiBurstCycles[SPI_SIZE_COUNT];
+uint8_t spiBuffer[SPI_MAX_SIZE];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize Hardware
+void initHw(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;
+    _delay_cycles(3);
+
+    // Configure Timer 1 as a free running counter
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;                    // turn-off timer before reconfiguring
+    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;              // configure as 32-bit timer (A+B)
+    TIMER1_TAMR_R = TIMER_TAMR_TACDIR | TIMER_TAMR_TAMR_PERIOD;
+                                                        // count up timer
+    TIMER1_TAV_R = 0;
+    TIMER1_CTL_R |= TIMER_CTL_TAEN;                     // turn-on timer
+}
+
+// Toggles PF3 through the data register given and returns the elapsed cycles
+uint32_t measureToggle(volatile uint32_t *data)
+{
+    uint32_t start, i;
+    start = TIMER1_TAV_R;
+    for (i = 0; i < TOGGLE_COUNT; i++)
+        *data ^= GREEN_LED_MASK;
+    return TIMER1_TAV_R - start;
+}
+
+// Times each transfer size with both SPI0 write methods
+void measureSpi(void)
+{
+    uint32_t start, i, j;
+    for (i = 0; i < SPI_SIZE_COUNT; i++)
+    {
+        start = TIMER1_TAV_R;
+        for (j = 0; j < spiSizes[i]; j++)
+        {
+            writeSpi0Data(spiBuffer[j]);
+            readSpi0Data();
+        }
+        spiFrameCycles[i] = TIMER1_TAV_R - start;
+
+        start = TIMER1_TAV_R;
+        transferSpi0Data(spiBuffer, spiBuffer, spiSizes[i]);
+        spiBurstCycles[i] = TIMER1_TAV_R - start;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+    // Initialize hardware
+    initHw();
+
+    // Port F on the APB aperture
+    enablePort(PORTF);
+    selectPinPushPullOutput(PORTF, 3);
+    apbCycles = measureToggle(&GPIO_PORTF_DATA_R);
+    apbCyclesPerToggle = apbCycles / TOGGLE_COUNT;
+
+    // Same port moved to the AHB aperture (pin configuration is kept)
+    enablePort(PORTF_AHB);
+    selectPinPushPullOutput(PORTF_AHB, 3);
+    ahbCycles = measureToggle(&GPIO_PORTF_AHB_DATA_R);
+    ahbCyclesPerToggle = ahbCycles / TOGGLE_COUNT;
+
+    // SPI0 at 4 MHz, mode 0
+    initSpi0(USE_SSI_FSS | USE_SSI_RX);
+    setSpi0BaudRate(4000000, 16000000);
+    setSpi0Mode(0, 0);
+    measureSpi();
+
+    while(true);
+}
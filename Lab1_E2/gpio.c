@@ -9,7 +9,7 @@
 // System Clock:    40 MHz
 
 // Hardware configuration:
-// GPIO APB ports A-F
+// GPIO APB and AHB ports A-F
 
 //-----------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
@@ -27,14 +27,27 @@
 #define OFS_DATA_TO_IBE    3*4*8
 #define OFS_DATA_TO_IEV    4*4*8
 #define OFS_DATA_TO_IM     5*4*8
+#define OFS_DATA_TO_MIS    7*4*8
 #define OFS_DATA_TO_IC     8*4*8
 #define OFS_DATA_TO_AFSEL  9*4*8
 #define OFS_DATA_TO_ODR   68*4*8
 #define OFS_DATA_TO_PUR   69*4*8
 #define OFS_DATA_TO_PDR   70*4*8
 #define OFS_DATA_TO_DEN   72*4*8
+#define OFS_DATA_TO_LOCK  73*4*8
 #define OFS_DATA_TO_CR    74*4*8
 #define OFS_DATA_TO_AMSEL 75*4*8
+#define OFS_DATA_TO_PCTL  76*4*8
+
+// Address of a port register from the bitband address of bit 0 of DATA_R
+// (32 bitband words per register byte address, so bit offsets above / 8 give byte offsets)
+#define PORT_REG(port, ofs) ((volatile uint32_t *)(0x40000000 + ((uint32_t)(port) - 0x42000000)/32 + (ofs)/8))
+
+// Address of the DATA register alias that only reads and writes the pins in mask
+// (address bits 9:2 of the GPIODATA access are used as a bit mask by the hardware)
+#define PORT_DATA_MASKED(port, mask) ((volatile uint32_t *)(0x40000000 + ((uint32_t)(port) - 0x42000000)/32 - 0x3FC + ((mask) << 2)))
+
+#define PORT_COUNT 6
 
 //-----------------------------------------------------------------------------
 // Global variables
@@ -44,6 +57,61 @@
 // Subroutines
 //-----------------------------------------------------------------------------
 
+// Read-modify-write of a whole port register with interrupts masked,
+// so an ISR changing other pins of the same register is never lost
+static void modifyPortRegister(volatile uint32_t *reg, uint32_t clearMask, uint32_t setMask)
+{
+    uint32_t primask = _disable_interrupts();
+    *reg = (*reg & ~clearMask) | setMask;
+    _restore_interrupts(primask);
+}
+
+// Index 0-5 of the port on either aperture, matching the SYSCTL_RCGCGPIO_R and SYSCTL_GPIOHBCTL_R bits
+uint8_t getPortIndex(PORT port)
+{
+    uint8_t index = 0;
+    switch(port)
+    {
+        case PORTA:
+        case PORTA_AHB:
+            index = 0;
+            break;
+        case PORTB:
+        case PORTB_AHB:
+            index = 1;
+            break;
+        case PORTC:
+        case PORTC_AHB:
+            index = 2;
+            break;
+        case PORTD:
+        case PORTD_AHB:
+            index = 3;
+            break;
+        case PORTE:
+        case PORTE_AHB:
+            index = 4;
+            break;
+        case PORTF:
+        case PORTF_AHB:
+            index = 5;
+    }
+    return index;
+}
+
+// PCTL nibbles used by the pins in mask
+static uint32_t getPctlMask(uint8_t mask)
+{
+    uint32_t pctlMask = 0;
+    uint8_t pin;
+    for (pin = 0; pin < 8; pin++)
+    {
+        if (mask & (1 << pin))
+            pctlMask |= 0x0000000F << (pin*4);
+    }
+    return pctlMask;
+}
+
 void enablePort(PORT port)
 {
     switch(port)
@@ -52,25 +120,49 @@ void enablePort(PORT port)
             SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
             SYSCTL_GPIOHBCTL_R &= ~1;
             break;
+        case PORTA_AHB:
+            SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
+            SYSCTL_GPIOHBCTL_R |= 1;
+            break;
         case PORTB:
             SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
             SYSCTL_GPIOHBCTL_R &= ~2;
             break;
+        case PORTB_AHB:
+            SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R1;
+            SYSCTL_GPIOHBCTL_R |= 2;
+            break;
         case PORTC:
             SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R2;
             SYSCTL_GPIOHBCTL_R &= ~4;
             break;
+        case PORTC_AHB:
+            SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R2;
+            SYSCTL_GPIOHBCTL_R |= 4;
+            break;
         case PORTD:
             SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R3;
             SYSCTL_GPIOHBCTL_R &= ~8;
             break;
+        case PORTD_AHB:
+            SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R3;
+            SYSCTL_GPIOHBCTL_R |= 8;
+            break;
         case PORTE:
             SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R4;
             SYSCTL_GPIOHBCTL_R &= ~16;
             break;
+        case PORTE_AHB:
+            SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R4;
+            SYSCTL_GPIOHBCTL_R |= 16;
+            break;
         case PORTF:
             SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R5;
             SYSCTL_GPIOHBCTL_R &= ~32;
+            break;
+        case PORTF_AHB:
+            SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R5;
+            SYSCTL_GPIOHBCTL_R |= 32;
     }
     _delay_cycles(3);
 }
@@ -80,21 +172,27 @@ void disablePort(PORT port)
     switch(port)
     {
         case PORTA:
+        case PORTA_AHB:
             SYSCTL_RCGCGPIO_R &= ~SYSCTL_RCGCGPIO_R0;
             break;
         case PORTB:
+        case PORTB_AHB:
             SYSCTL_RCGCGPIO_R &= ~SYSCTL_RCGCGPIO_R1;
             break;
         case PORTC:
+        case PORTC_AHB:
             SYSCTL_RCGCGPIO_R &= ~SYSCTL_RCGCGPIO_R2;
             break;
         case PORTD:
+        case PORTD_AHB:
             SYSCTL_RCGCGPIO_R &= ~SYSCTL_RCGCGPIO_R3;
             break;
         case PORTE:
+        case PORTE_AHB:
             SYSCTL_RCGCGPIO_R &= ~SYSCTL_RCGCGPIO_R4;
             break;
         case PORTF:
+        case PORTF_AHB:
             SYSCTL_RCGCGPIO_R &= ~SYSCTL_RCGCGPIO_R5;
     }
     _delay_cycles(3);
@@ -151,20 +249,38 @@ void setPinCommitControl(PORT port, uint8_t pin)
         case PORTA:
             GPIO_PORTA_LOCK_R = GPIO_LOCK_KEY;
             break;
+        case PORTA_AHB:
+            GPIO_PORTA_AHB_LOCK_R = GPIO_LOCK_KEY;
+            break;
         case PORTB:
             GPIO_PORTB_LOCK_R = GPIO_LOCK_KEY;
             break;
+        case PORTB_AHB:
+            GPIO_PORTB_AHB_LOCK_R = GPIO_LOCK_KEY;
+            break;
         case PORTC:
             GPIO_PORTC_LOCK_R = GPIO_LOCK_KEY;
             break;
+        case PORTC_AHB:
+            GPIO_PORTC_AHB_LOCK_R = GPIO_LOCK_KEY;
+            break;
         case PORTD:
             GPIO_PORTD_LOCK_R = GPIO_LOCK_KEY;
             break;
+        case PORTD_AHB:
+            GPIO_PORTD_AHB_LOCK_R = GPIO_LOCK_KEY;
+            break;
         case PORTE:
             GPIO_PORTE_LOCK_R = GPIO_LOCK_KEY;
             break;
+        case PORTE_AHB:
+            GPIO_PORTE_AHB_LOCK_R = GPIO_LOCK_KEY;
+            break;
         case PORTF:
             GPIO_PORTF_LOCK_R = GPIO_LOCK_KEY;
+            break;
+        case PORTF_AHB:
+            GPIO_PORTF_AHB_LOCK_R = GPIO_LOCK_KEY;
     }
     uint32_t *p;
     p = (uint32_t *)port + pin + OFS_DATA_TO_CR;
@@ -211,20 +327,38 @@ void setPinAuxFunction(PORT port, uint8_t pin, uint32_t fn)
         case PORTA:
             GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
             break;
+        case PORTA_AHB:
+            GPIO_PORTA_AHB_PCTL_R = (GPIO_PORTA_AHB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
+            break;
         case PORTB:
             GPIO_PORTB_PCTL_R = (GPIO_PORTB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
             break;
+        case PORTB_AHB:
+            GPIO_PORTB_AHB_PCTL_R = (GPIO_PORTB_AHB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
+            break;
         case PORTC:
             GPIO_PORTC_PCTL_R = (GPIO_PORTC_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
             break;
+        case PORTC_AHB:
+            GPIO_PORTC_AHB_PCTL_R = (GPIO_PORTC_AHB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
+            break;
         case PORTD:
             GPIO_PORTD_PCTL_R = (GPIO_PORTD_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
             break;
+        case PORTD_AHB:
+            GPIO_PORTD_AHB_PCTL_R = (GPIO_PORTD_AHB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
+            break;
         case PORTE:
             GPIO_PORTE_PCTL_R = (GPIO_PORTE_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
             break;
+        case PORTE_AHB:
+            GPIO_PORTE_AHB_PCTL_R = (GPIO_PORTE_AHB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
+            break;
         case PORTF:
             GPIO_PORTF_PCTL_R = (GPIO_PORTF_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
+            break;
+        case PORTF_AHB:
+            GPIO_PORTF_AHB_PCTL_R = (GPIO_PORTF_AHB_PCTL_R & ~(0x0000000F << (pin*4))) | fn;
     }
     // set AFSEL bit only if using aux function, otherwise clear bit
     uint32_t *p;
@@ -330,45 +464,263 @@ void setPortValue(PORT port, uint8_t value)
         case PORTA:
             GPIO_PORTA_DATA_R = value;
             break;
+        case PORTA_AHB:
+            GPIO_PORTA_AHB_DATA_R = value;
+            break;
         case PORTB:
             GPIO_PORTB_DATA_R = value;
             break;
+        case PORTB_AHB:
+            GPIO_PORTB_AHB_DATA_R = value;
+            break;
         case PORTC:
             GPIO_PORTC_DATA_R = value;
             break;
+        case PORTC_AHB:
+            GPIO_PORTC_AHB_DATA_R = value;
+            break;
         case PORTD:
             GPIO_PORTD_DATA_R = value;
             break;
+        case PORTD_AHB:
+            GPIO_PORTD_AHB_DATA_R = value;
+            break;
         case PORTE:
             GPIO_PORTE_DATA_R = value;
             break;
+        case PORTE_AHB:
+            GPIO_PORTE_AHB_DATA_R = value;
+            break;
         case PORTF:
             GPIO_PORTF_DATA_R = value;
+            break;
+        case PORTF_AHB:
+            GPIO_PORTF_AHB_DATA_R = value;
     }
 }
 
 uint8_t getPortValue(PORT port)
 {
-    uint8_t value;
+    uint8_t value = 0;                              // an unknown port reads as 0
     switch(port)
     {
         case PORTA:
             value = GPIO_PORTA_DATA_R;
             break;
+        case PORTA_AHB:
+            value = GPIO_PORTA_AHB_DATA_R;
+            break;
         case PORTB:
             value = GPIO_PORTB_DATA_R;
             break;
+        case PORTB_AHB:
+            value = GPIO_PORTB_AHB_DATA_R;
+            break;
         case PORTC:
             value = GPIO_PORTC_DATA_R;
             break;
+        case PORTC_AHB:
+            value = GPIO_PORTC_AHB_DATA_R;
+            break;
         case PORTD:
             value = GPIO_PORTD_DATA_R;
             break;
+        case PORTD_AHB:
+            value = GPIO_PORTD_AHB_DATA_R;
+            break;
         case PORTE:
             value = GPIO_PORTE_DATA_R;
             break;
+        case PORTE_AHB:
+            value = GPIO_PORTE_AHB_DATA_R;
+            break;
         case PORTF:
             value = GPIO_PORTF_DATA_R;
+            break;
+        case PORTF_AHB:
+            value = GPIO_PORTF_AHB_DATA_R;
     }
     return value;
 }
+
+// Writes only the pins in mask with one store, other pins are left untouched
+// No read-modify-write, so it is safe against an ISR writing other pins of the port
+void setPortValueMasked(PORT port, uint8_t mask, uint8_t value)
+{
+    *PORT_DATA_MASKED(port, mask) = value;
+}
+
+// Reads the pins in mask, other pins read as 0
+uint8_t getPortValueMasked(PORT port, uint8_t mask)
+{
+    return *PORT_DATA_MASKED(port, mask);
+}
+
+void selectPortPushPullOutput(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_ODR), mask, 0);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DIR), 0, mask);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DEN), 0, mask);
+}
+
+void selectPortOpenDrainOutput(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_ODR), 0, mask);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DIR), 0, mask);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DEN), 0, mask);
+}
+
+void selectPortDigitalInput(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DIR), mask, 0);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DEN), 0, mask);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_AMSEL), mask, 0);
+}
+
+void selectPortAnalogInput(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_DEN), mask, 0);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_AMSEL), 0, mask);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_AFSEL), 0, mask);
+}
+
+void setPortCommitControl(PORT port, uint8_t mask)
+{
+    *PORT_REG(port, OFS_DATA_TO_LOCK) = GPIO_LOCK_KEY;
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_CR), 0, mask);
+}
+
+void enablePortPullup(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_PUR), 0, mask);
+}
+
+void disablePortPullup(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_PUR), mask, 0);
+}
+
+void enablePortPulldown(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_PDR), 0, mask);
+}
+
+void disablePortPulldown(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_PDR), mask, 0);
+}
+
+void setPortAuxFunction(PORT port, uint8_t mask, uint32_t fn)
+{
+    // call with header file shifted values, or'ed together for several pins
+    uint32_t pctlMask = getPctlMask(mask);
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_PCTL), pctlMask, fn & pctlMask);
+    // set AFSEL bits only if using aux function, otherwise clear bits
+    if (fn & pctlMask)
+        modifyPortRegister(PORT_REG(port, OFS_DATA_TO_AFSEL), 0, mask);
+    else
+        modifyPortRegister(PORT_REG(port, OFS_DATA_TO_AFSEL), mask, 0);
+}
+
+void enablePortInterrupt(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_IM), 0, mask);
+}
+
+void disablePortInterrupt(PORT port, uint8_t mask)
+{
+    modifyPortRegister(PORT_REG(port, OFS_DATA_TO_IM), mask, 0);
+}
+
+void clearPortInterrupt(PORT port, uint8_t mask)
+{
+    // write-1-to-clear, so no read-modify-write needed
+    *PORT_REG(port, OFS_DATA_TO_IC) = mask;
+}
+
+uint8_t getPortInterruptStatus(PORT port)
+{
+    // masked status, only pins with the interrupt enabled
+    return *PORT_REG(port, OFS_DATA_TO_MIS);
+}
+
+// Configures every pin in a board pin table
+// Entries are merged per port first, so each register of each port is written once
+void applyPinConfig(const PIN_CONFIG config[], uint8_t count)
+{
+    PORT ports[PORT_COUNT];
+    uint8_t mask[PORT_COUNT] = {0};
+    uint8_t dir[PORT_COUNT] = {0};
+    uint8_t odr[PORT_COUNT] = {0};
+    uint8_t den[PORT_COUNT] = {0};
+    uint8_t amsel[PORT_COUNT] = {0};
+    uint8_t afsel[PORT_COUNT] = {0};
+    uint8_t pur[PORT_COUNT] = {0};
+    uint8_t pdr[PORT_COUNT] = {0};
+    uint32_t pctlMask[PORT_COUNT] = {0};
+    uint32_t pctl[PORT_COUNT] = {0};
+    uint32_t clocks = 0;
+    uint32_t ahb = 0;
+    uint8_t i, n;
+
+    // Merge entries
+    for (i = 0; i < count; i++)
+    {
+        uint8_t m = config[i].mask;
+        n = getPortIndex(config[i].port);
+        ports[n] = config[i].port;
+        clocks |= 1 << n;
+        if (config[i].port >= PORTA_AHB)
+            ahb |= 1 << n;
+        mask[n] |= m;
+        switch(config[i].mode)
+        {
+            case PIN_PUSH_PULL_OUTPUT:
+                dir[n] |= m;
+                den[n] |= m;
+                break;
+            case PIN_OPEN_DRAIN_OUTPUT:
+                dir[n] |= m;
+                odr[n] |= m;
+                den[n] |= m;
+                break;
+            case PIN_DIGITAL_INPUT:
+                den[n] |= m;
+                break;
+            case PIN_ANALOG_INPUT:
+                amsel[n] |= m;
+                afsel[n] |= m;
+        }
+        if (config[i].pull == PIN_PULLUP)
+            pur[n] |= m;
+        else if (config[i].pull == PIN_PULLDOWN)
+            pdr[n] |= m;
+        pctlMask[n] |= getPctlMask(m);
+        if (config[i].fn & getPctlMask(m))
+        {
+            pctl[n] |= config[i].fn & getPctlMask(m);
+            afsel[n] |= m;
+        }
+    }
+
+    // Enable all port clocks and select the APB or AHB aperture of each port in one write
+    SYSCTL_RCGCGPIO_R |= clocks;
+    SYSCTL_GPIOHBCTL_R = (SYSCTL_GPIOHBCTL_R & ~clocks) | ahb;
+    _delay_cycles(3);
+
+    // Write each register of each used port once
+    for (n = 0; n < PORT_COUNT; n++)
+    {
+        if (clocks & (1 << n))
+        {
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_PCTL), pctlMask[n], pctl[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_AFSEL), mask[n], afsel[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_AMSEL), mask[n], amsel[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_ODR), mask[n], odr[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_PUR), mask[n], pur[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_PDR), mask[n], pdr[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_DIR), mask[n], dir[n]);
+            modifyPortRegister(PORT_REG(ports[n], OFS_DATA_TO_DEN), mask[n], den[n]);
+        }
+    }
+}
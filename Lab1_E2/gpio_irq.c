@@ -0,0 +1,227 @@
+// GPIO Interrupt Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// GPIO APB and AHB ports A-F
+// Timer 5A is a free running counter whose match interrupt ends debounce windows
+
+// The port ISRs and gpioDebounceIsr share the pin table, so they must run at
+// the same NVIC priority (the default)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "gpio_irq.h"
+#include "nvic.h"
+
+#define PORT_COUNT 6
+#define TICKS_PER_US 40
+#define MIN_DEADLINE_TICKS 100                      // never arm a match the counter has already passed
+
+typedef struct _GPIO_IRQ_PIN
+{
+    GPIO_CALLBACK callback;
+    uint32_t debounceTicks;
+    uint32_t deadline;
+    bool value;                                     // last value reported to the callback
+} GPIO_IRQ_PIN;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const uint8_t portVectors[PORT_COUNT] = {INT_GPIOA, INT_GPIOB, INT_GPIOC, INT_GPIOD, INT_GPIOE, INT_GPIOF};
+
+static PORT irqPorts[PORT_COUNT];
+static GPIO_IRQ_PIN irqPins[PORT_COUNT][8];
+static uint8_t pendingMask[PORT_COUNT];             // pins waiting for their debounce deadline
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Index of the lowest set bit (CLZ of the isolated bit), mask must be non-zero
+static uint8_t findFirstSet(uint32_t mask)
+{
+    return 31 - _norm(mask & -mask);
+}
+
+// Arms the timer 5 match for the earliest pending deadline
+static void scheduleDebounce(void)
+{
+    uint32_t now = TIMER5_TAV_R;
+    uint32_t earliest = 0xFFFFFFFF;
+    uint8_t n, pin, pending;
+    for (n = 0; n < PORT_COUNT; n++)
+    {
+        pending = pendingMask[n];
+        while (pending)
+        {
+            int32_t remaining;
+            pin = findFirstSet(pending);
+            pending &= pending - 1;
+            remaining = irqPins[n][pin].deadline - now;
+            if (remaining < MIN_DEADLINE_TICKS)
+                remaining = MIN_DEADLINE_TICKS;
+            if ((uint32_t)remaining < earliest)
+                earliest = remaining;
+        }
+    }
+    if (earliest != 0xFFFFFFFF)
+    {
+        TIMER5_TAMATCHR_R = now + earliest;
+        TIMER5_IMR_R |= TIMER_IMR_TAMIM;
+    }
+    else
+        TIMER5_IMR_R &= ~TIMER_IMR_TAMIM;
+}
+
+// Dispatches every pin of a port flagged in GPIO_MIS
+static void dispatchPort(PORT port)
+{
+    uint8_t n = getPortIndex(port);
+    uint8_t status = getPortInterruptStatus(port);
+    uint8_t pin;
+    clearPortInterrupt(port, status);
+    while (status)
+    {
+        GPIO_IRQ_PIN *p;
+        pin = findFirstSet(status);
+        status &= status - 1;
+        p = &irqPins[n][pin];
+        if (p->debounceTicks)
+        {
+            // ignore bounces until the deadline, then sample the settled value
+            disablePinInterrupt(port, pin);
+            p->deadline = TIMER5_TAV_R + p->debounceTicks;
+            pendingMask[n] |= 1 << pin;
+        }
+        else
+        {
+            p->value = getPinValue(port, pin);
+            if (p->callback)
+                p->callback(port, pin, p->value);
+        }
+    }
+    if (pendingMask[n])
+        scheduleDebounce();
+}
+
+// Initialize the debounce timer
+void initGpioIrq(void)
+{
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R5;
+    _delay_cycles(3);
+
+    // Configure Timer 5 as a free running up counter with a match interrupt
+    TIMER5_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off timer before reconfiguring
+    TIMER5_CFG_R = TIMER_CFG_32_BIT_TIMER;          // configure as 32-bit timer (A+B)
+    TIMER5_TAMR_R = TIMER_TAMR_TACDIR | TIMER_TAMR_TAMR_PERIOD | TIMER_TAMR_TAMIE;
+                                                    // count up, match interrupt
+    TIMER5_TAILR_R = 0xFFFFFFFF;                    // full 32-bit range
+    TIMER5_IMR_R = 0;                               // match interrupt armed only while a deadline is pending
+    TIMER5_CTL_R |= TIMER_CTL_TAEN;                 // turn-on timer
+    enableNvicInterrupt(INT_TIMER5A);
+}
+
+// Calls callback on both edges of a pin
+// debounceUs = 0 reports every edge, otherwise the pin is sampled once debounceUs after the first edge
+void attachPinInterrupt(PORT port, uint8_t pin, GPIO_CALLBACK callback, uint32_t debounceUs)
+{
+    uint8_t n = getPortIndex(port);
+    GPIO_IRQ_PIN *p = &irqPins[n][pin];
+    disablePinInterrupt(port, pin);                 // mask while changing the sense configuration
+    pendingMask[n] &= ~(1 << pin);
+    irqPorts[n] = port;
+    p->callback = callback;
+    p->debounceTicks = debounceUs * TICKS_PER_US;
+    p->value = getPinValue(port, pin);
+    selectPinInterruptBothEdges(port, pin);
+    clearPinInterrupt(port, pin);
+    enablePinInterrupt(port, pin);
+    enableNvicInterrupt(portVectors[n]);
+}
+
+void detachPinInterrupt(PORT port, uint8_t pin)
+{
+    uint8_t n = getPortIndex(port);
+    disablePinInterrupt(port, pin);
+    pendingMask[n] &= ~(1 << pin);
+    irqPins[n][pin].callback = 0;
+}
+
+void gpioPortAIsr(void)
+{
+    dispatchPort(irqPorts[0]);
+}
+
+void gpioPortBIsr(void)
+{
+    dispatchPort(irqPorts[1]);
+}
+
+void gpioPortCIsr(void)
+{
+    dispatchPort(irqPorts[2]);
+}
+
+void gpioPortDIsr(void)
+{
+    dispatchPort(irqPorts[3]);
+}
+
+void gpioPortEIsr(void)
+{
+    dispatchPort(irqPorts[4]);
+}
+
+void gpioPortFIsr(void)
+{
+    dispatchPort(irqPorts[5]);
+}
+
+// Ends the debounce window of every pin whose deadline has passed
+void gpioDebounceIsr(void)
+{
+    uint32_t now = TIMER5_TAV_R;
+    uint8_t n, pin, pending;
+    TIMER5_ICR_R = TIMER_ICR_TAMCINT;               // clear interrupt flag
+    for (n = 0; n < PORT_COUNT; n++)
+    {
+        pending = pendingMask[n];
+        while (pending)
+        {
+            GPIO_IRQ_PIN *p;
+            bool value;
+            pin = findFirstSet(pending);
+            pending &= pending - 1;
+            p = &irqPins[n][pin];
+            if ((int32_t)(now - p->deadline) >= 0)
+            {
+                pendingMask[n] &= ~(1 << pin);
+                clearPinInterrupt(irqPorts[n], pin);    // drop edges latched during the window,
+                value = getPinValue(irqPorts[n], pin);  // then sample, so a later edge still interrupts
+                enablePinInterrupt(irqPorts[n], pin);
+                if (value != p->value)
+                {
+                    p->value = value;
+                    if (p->callback)
+                        p->callback(irqPorts[n], pin, value);
+                }
+            }
+        }
+    }
+    scheduleDebounce();
+}
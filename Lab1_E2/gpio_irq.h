@@ -0,0 +1,49 @@
+// GPIO Interrupt Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// GPIO APB and AHB ports A-F
+// Timer 5A is a free running counter whose match interrupt ends debounce windows
+
+// Vector table entries to add in tm4c123gh6pm_startup_ccs.c:
+//   gpioPortAIsr ... gpioPortFIsr on GPIO Port A ... GPIO Port F
+//   gpioDebounceIsr on Timer 5 subtimer A
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef GPIO_IRQ_H_
+#define GPIO_IRQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+// Called from interrupt context with the new (debounced) pin value
+typedef void (*GPIO_CALLBACK)(PORT port, uint8_t pin, bool value);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initGpioIrq(void);
+void attachPinInterrupt(PORT port, uint8_t pin, GPIO_CALLBACK callback, uint32_t debounceUs);
+void detachPinInterrupt(PORT port, uint8_t pin);
+
+void gpioPortAIsr(void);
+void gpioPortBIsr(void);
+void gpioPortCIsr(void);
+void gpioPortDIsr(void);
+void gpioPortEIsr(void);
+void gpioPortFIsr(void);
+void gpioDebounceIsr(void);
+
+#endif
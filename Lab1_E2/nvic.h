@@ -19,6 +19,12 @@
 #define NVIC_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// Number of entries in the vector table (stack pointer, 15 exceptions, 139 interrupts)
+#define NVIC_VECTOR_COUNT 155
+
+typedef void (*NVIC_ISR)(void);
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -27,5 +33,8 @@
 void enableNvicInterrupt(uint8_t vectorNumber);
 void disableNvicInterrupt(uint8_t vectorNumber);
 void setNvicInterruptPriority(uint8_t vectorNumber, uint8_t priority);
+bool nvicRegisterIsr(uint8_t vectorNumber, NVIC_ISR isr);
+uint32_t enterNvicCritical(uint8_t priority);
+void leaveNvicCritical(uint32_t state);
 
 #endif
@@ -0,0 +1,111 @@
+// Compile-time Pin Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// GPIO APB and AHB ports A-F
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+// Header-only access to a single pin through its bit-band alias
+// When port and pin are constants the address folds at compile time, so each
+// access is one load or store to a constant address with no call and no
+// pointer arithmetic. The runtime functions in gpio.h remain for pins that
+// are only known at run time.
+//
+// C usage:
+//   #define RED_LED PIN(PORTF, 1)
+//   RED_LED = 1;
+//   #define SSI0FSS PORTA,3          (same descriptors as used with gpio.h)
+//   writePin(SSI0FSS, 0);
+//
+// C++ usage:
+//   typedef Pin<PORTF, 1> RedLed;
+//   RedLed::set(true);
+
+#ifndef PIN_H_
+#define PIN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "gpio.h"
+#ifdef __cplusplus
+}
+#endif
+
+// Bit-band alias of the DATA bit of a pin (PORT enum values are the alias of bit 0)
+#define PIN_BITBAND(port, pin) (*((volatile uint32_t *)((uint32_t)(port) + (pin)*4)))
+
+// Accepts either PIN(PORTF, 1) or a PORTF,1 descriptor macro
+#define PIN(...) PIN_BITBAND(__VA_ARGS__)
+
+// Masked DATA register alias of a port, a store only changes the pins in mask
+//   PORT_MASKED(PORTF, RED_LED_MASK | GREEN_LED_MASK) = GREEN_LED_MASK;
+#define PORT_MASKED(port, mask) (*((volatile uint32_t *)(0x40000000 + ((uint32_t)(port) - 0x42000000)/32 - 0x3FC + ((mask) << 2))))
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static inline void writePin(PORT port, uint8_t pin, bool value)
+{
+    PIN_BITBAND(port, pin) = value;
+}
+
+static inline bool readPin(PORT port, uint8_t pin)
+{
+    return PIN_BITBAND(port, pin);
+}
+
+static inline void togglePin(PORT port, uint8_t pin)
+{
+    PIN_BITBAND(port, pin) ^= 1;
+}
+
+#ifdef __cplusplus
+
+// Pin fixed at compile time, all members resolve to constant-address accesses
+template <PORT port, uint8_t pin>
+struct Pin
+{
+    static_assert(pin < 8, "GPIO ports have 8 pins");
+
+    static constexpr uint32_t address = (uint32_t)port + pin*4;
+    static constexpr uint8_t mask = 1 << pin;
+
+    static inline volatile uint32_t& bitband()
+    {
+        return *reinterpret_cast<volatile uint32_t*>(address);
+    }
+
+    static inline void set(bool value)
+    {
+        bitband() = value;
+    }
+
+    static inline bool get()
+    {
+        return bitband();
+    }
+
+    static inline void toggle()
+    {
+        bitband() ^= 1;
+    }
+};
+
+#endif
+
+#endif
@@ -15,6 +15,13 @@
 //   MISO on PA4 (SSI0Rx)
 //   ~CS  on PA3 (SSI0Fss)
 //   SCLK on PA2 (SSI0Clk)
+// uDMA:
+//   SSI0Rx on channel 10, SSI0Tx on channel 11 (encoding 0)
+//   DMA transactions drive ~CS on PA3 (or the pin from setSpi0DmaChipSelect()) as a GPIO,
+//   so call initSpi0() without USE_SSI_FSS
+//   spi0Isr must be on the SSI0 vector
+
+// SPI0 is the SSI0 instance of the ssi library
 
 //-----------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
@@ -24,17 +31,7 @@
 #include <stdbool.h>
 #include "tm4c123gh6pm.h"
 #include "spi0.h"
-#include "gpio.h"
-
-// Pins
-#define SSI0TX PORTA,5
-#define SSI0RX PORTA,4
-#define SSI0FSS PORTA,3
-#define SSI0CLK PORTA,2
-
-//-----------------------------------------------------------------------------
-// Global variables
-//-----------------------------------------------------------------------------
+#include "ssi.h"
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -43,69 +40,96 @@
 // Initialize SPI0
 void initSpi0(uint32_t pinMask)
 {
-    // Enable clocks
-    SYSCTL_RCGCSSI_R |= SYSCTL_RCGCSSI_R1;
-    _delay_cycles(3);
-    enablePort(PORTA);
-
-    // Configure SSI0 pins for SPI configuration
-    selectPinPushPullOutput(SSI0TX);
-    setPinAuxFunction(SSI0TX, GPIO_PCTL_PA5_SSI0TX);
-    selectPinPushPullOutput(SSI0CLK);
-    setPinAuxFunction(SSI0CLK, GPIO_PCTL_PA2_SSI0CLK);
-    selectPinPushPullOutput(SSI0FSS);
-    if (pinMask & USE_SSI_FSS)
-    {
-        setPinAuxFunction(SSI0FSS, GPIO_PCTL_PA3_SSI0FSS);
-    }
-    if (pinMask & USE_SSI_RX)
-    {
-        selectPinDigitalInput(SSI0RX);
-        setPinAuxFunction(SSI0RX, GPIO_PCTL_PA4_SSI0RX);
-    }
-
-    // Configure the SSI0 as a SPI master, mode 3, 8bit operation
-    SSI0_CR1_R &= ~SSI_CR1_SSE;                        // turn off SSI0 to allow re-configuration
-    SSI0_CR1_R = 0;                                    // select master mode
-    SSI0_CC_R = 0;                                     // select system clock as the clock source
-    SSI0_CR0_R = SSI_CR0_FRF_MOTO | SSI_CR0_DSS_8;     // set SR=0, 8-bit
+    initSsi(SSI0, pinMask);
 }
 
 // Set baud rate as function of instruction cycle frequency
 void setSpi0BaudRate(uint32_t baudRate, uint32_t fcyc)
 {
-    uint32_t divisorTimes2 = (fcyc * 2) / baudRate;    // calculate divisor (r) times 2
-    SSI0_CR1_R &= ~SSI_CR1_SSE;                        // turn off SSI0 to allow re-configuration
-    SSI0_CPSR_R = (divisorTimes2 + 1) >> 1;            // round divisor to nearest integer
-    SSI0_CR1_R |= SSI_CR1_SSE;                         // turn on SSI0
+    setSsiBaudRate(SSI0, baudRate, fcyc);
 }
 
 // Set mode
 void setSpi0Mode(uint8_t polarity, uint8_t phase)
 {
-    SSI0_CR1_R &= ~SSI_CR1_SSE;                        // turn off SSI0 to allow re-configuration
-    SSI0_CR0_R &= ~(SSI_CR0_SPH | SSI_CR0_SPO);        // set SPO and SPH as appropriate
-    if (polarity)
-    {
-        SSI0_CR0_R |= SSI_CR0_SPO;
-        enablePinPullup(SSI0CLK);
-    }
-    else
-        disablePinPullup(SSI0CLK);
-    if (phase)
-        SSI0_CR0_R |= SSI_CR0_SPH;
-    SSI0_CR1_R |= SSI_CR1_SSE;                         // turn on SSI0
+    setSsiMode(SSI0, polarity, phase);
+}
+
+// Set mode and baud rate with a single disable/enable of SSI0
+void configureSpi0(uint8_t polarity, uint8_t phase, uint32_t baudRate, uint32_t fcyc)
+{
+    configureSsi(SSI0, polarity, phase, baudRate, fcyc);
 }
 
 // Blocking function that writes data and waits until the tx buffer is empty
 void writeSpi0Data(uint32_t data)
 {
-    SSI0_DR_R = data;
-    while (SSI0_SR_R & SSI_SR_BSY);
+    writeSsiData(SSI0, data);
 }
 
 // Reads data from the rx buffer after a write
 uint32_t readSpi0Data()
 {
-    return SSI0_DR_R;
+    return readSsiData(SSI0);
+}
+
+// Full-duplex block transfer of 8-bit frames
+// tx = 0 sends 0xFF fill frames, rx = 0 discards received frames
+void transferSpi0Data(const uint8_t tx[], uint8_t rx[], uint32_t length)
+{
+    transferSsiData(SSI0, tx, rx, length);
+}
+
+// Blocking function that writes a block and returns when the last frame has been shifted out
+void writeSpi0Buffer(const uint8_t tx[], uint32_t length)
+{
+    transferSsiData(SSI0, tx, 0, length);
+}
+
+// Blocking function that reads a block while sending 0xFF fill frames
+void readSpi0Buffer(uint8_t rx[], uint32_t length)
+{
+    transferSsiData(SSI0, 0, rx, length);
+}
+
+// Initialize uDMA channels for SSI0
+void initSpi0Dma(void)
+{
+    initSsiDma(SSI0);
+}
+
+// Selects the GPIO pin used as ~CS by the next DMA transactions
+void setSpi0DmaChipSelect(PORT port, uint8_t pin)
+{
+    setSsiDmaChipSelect(SSI0, port, pin);
+}
+
+// Starts an asynchronous full-duplex transfer of 1-1024 frames
+// Buffers must stay valid until the callback runs or isSpi0DmaBusy() returns false
+bool startSpi0Dma(const uint8_t tx[], uint8_t rx[], uint16_t length, SPI0_DMA_CALLBACK callback)
+{
+    return startSsiDma(SSI0, tx, rx, length, callback);
+}
+
+// Starts a continuous write stream from two buffers of 1-1024 bytes each
+bool startSpi0DmaStream(uint8_t ping[], uint8_t pong[], uint16_t length, SPI0_STREAM_CALLBACK callback)
+{
+    return startSsiDmaStream(SSI0, ping, pong, length, callback);
+}
+
+// Stream ends after the buffer in flight
+void stopSpi0DmaStream(void)
+{
+    stopSsiDmaStream(SSI0);
+}
+
+bool isSpi0DmaBusy(void)
+{
+    return isSsiDmaBusy(SSI0);
+}
+
+// SSI0 vector, uDMA completion of the SSI0 channels
+void spi0Isr(void)
+{
+    ssi0Isr();
 }
@@ -23,8 +23,16 @@
 #ifndef SPI0_H_
 #define SPI0_H_
 
-#define USE_SSI_FSS 3
-#define USE_SSI_RX  4
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+#include "ssi.h"
+
+// Called from spi0Isr when a DMA transaction has completed
+typedef SSI_DMA_CALLBACK SPI0_DMA_CALLBACK;
+// Called from spi0Isr with the stream buffer that was just sent
+// Refill it and return true to keep streaming, or return false to stop
+typedef SSI_STREAM_CALLBACK SPI0_STREAM_CALLBACK;
 
 //-----------------------------------------------------------------------------
 // Subroutines
@@ -33,7 +41,19 @@
 void initSpi0(uint32_t pinMask);
 void setSpi0BaudRate(uint32_t clockRate, uint32_t fcyc);
 void setSpi0Mode(uint8_t polarity, uint8_t phase);
+void configureSpi0(uint8_t polarity, uint8_t phase, uint32_t baudRate, uint32_t fcyc);
 void writeSpi0Data(uint32_t data);
 uint32_t readSpi0Data();
+void transferSpi0Data(const uint8_t tx[], uint8_t rx[], uint32_t length);
+void writeSpi0Buffer(const uint8_t tx[], uint32_t length);
+void readSpi0Buffer(uint8_t rx[], uint32_t length);
+
+void initSpi0Dma(void);
+void setSpi0DmaChipSelect(PORT port, uint8_t pin);
+bool startSpi0Dma(const uint8_t tx[], uint8_t rx[], uint16_t length, SPI0_DMA_CALLBACK callback);
+bool startSpi0DmaStream(uint8_t ping[], uint8_t pong[], uint16_t length, SPI0_STREAM_CALLBACK callback);
+void stopSpi0DmaStream(void);
+bool isSpi0DmaBusy(void);
+void spi0Isr(void);
 
 #endif
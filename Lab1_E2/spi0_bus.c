@@ -0,0 +1,130 @@
+// SPI0 Bus Manager
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// SPI0 Interface with uDMA, see spi0.h
+// One GPIO ~CS per device
+
+// Transactions run back-to-back from the uDMA completion interrupt. SSI0 is
+// only reconfigured when a transaction is for a different device than the
+// previous one.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+#include "spi0.h"
+#include "spi0_bus.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static SPI0_TRANSACTION *queue[SPI0_QUEUE_SIZE];
+static uint8_t queueRead = 0;
+static uint8_t queueWrite = 0;
+static SPI0_TRANSACTION *active = 0;
+static SPI0_DEVICE *configured = 0;                     // device SSI0 is currently set up for
+static uint32_t busFcyc;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void transactionDone(void);
+
+static void completeTransaction(SPI0_TRANSACTION *t, bool failed)
+{
+    t->failed = failed;
+    t->done = true;
+    if (t->callback)
+        t->callback(t);
+}
+
+// Starts the next queued transaction, called with interrupts masked or from spi0Isr
+// A transaction the uDMA refuses completes as failed and the one after it is tried
+static void startNext(void)
+{
+    SPI0_TRANSACTION *t;
+    while (queueRead != queueWrite)
+    {
+        t = queue[queueRead];
+        queueRead = (queueRead + 1) % SPI0_QUEUE_SIZE;
+        active = t;
+        if (t->device != configured)
+        {
+            configureSpi0(t->device->polarity, t->device->phase, t->device->baudRate, busFcyc);
+            setSpi0DmaChipSelect(t->device->csPort, t->device->csPin);
+            configured = t->device;
+        }
+        if (startSpi0Dma(t->tx, t->rx, t->length, transactionDone))
+            return;
+        completeTransaction(t, true);
+    }
+    active = 0;
+}
+
+// uDMA completion, runs in spi0Isr
+static void transactionDone(void)
+{
+    completeTransaction(active, false);
+    startNext();
+}
+
+// Initialize SSI0 and its uDMA channels for shared use (~CS pins are per device)
+void initSpi0Bus(uint32_t fcyc)
+{
+    busFcyc = fcyc;
+    initSpi0(USE_SSI_RX);
+    initSpi0Dma();
+    configured = 0;
+}
+
+// Configures the ~CS pin of a device as a deasserted output
+void registerSpi0Device(SPI0_DEVICE *device)
+{
+    enablePort(device->csPort);
+    setPinValue(device->csPort, device->csPin, 1);
+    selectPinPushPullOutput(device->csPort, device->csPin);
+}
+
+// Adds a transaction to the queue, returns false if the queue is full or the
+// length is not 1-SPI0_MAX_LENGTH bytes
+bool queueSpi0Transaction(SPI0_TRANSACTION *transaction)
+{
+    uint32_t primask;
+    uint8_t next;
+    if (transaction->length == 0 || transaction->length > SPI0_MAX_LENGTH)
+        return false;
+    transaction->done = false;
+    transaction->failed = false;
+    primask = _disable_interrupts();
+    next = (queueWrite + 1) % SPI0_QUEUE_SIZE;
+    if (next == queueRead)
+    {
+        _restore_interrupts(primask);
+        return false;
+    }
+    queue[queueWrite] = transaction;
+    queueWrite = next;
+    if (!active)
+        startNext();
+    _restore_interrupts(primask);
+    return true;
+}
+
+bool isSpi0BusIdle(void)
+{
+    return active == 0;
+}
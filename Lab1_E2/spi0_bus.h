@@ -0,0 +1,65 @@
+// SPI0 Bus Manager
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// SPI0 Interface with uDMA, see spi0.h
+// One GPIO ~CS per device
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SPI0_BUS_H_
+#define SPI0_BUS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gpio.h"
+
+#define SPI0_QUEUE_SIZE 8
+#define SPI0_MAX_LENGTH 1024                            // bytes, a single uDMA transfer
+
+// A device sharing SSI0, owned by the caller
+typedef struct _SPI0_DEVICE
+{
+    PORT csPort;
+    uint8_t csPin;
+    uint8_t polarity;
+    uint8_t phase;
+    uint32_t baudRate;
+} SPI0_DEVICE;
+
+struct _SPI0_TRANSACTION;
+typedef void (*SPI0_TRANSACTION_CALLBACK)(struct _SPI0_TRANSACTION *transaction);
+
+// A queued transfer, owned by the caller until done is set
+// tx = 0 sends 0xFF fill frames, rx = 0 discards received frames
+// failed is set with done when the uDMA could not start it (SSI0 in use)
+typedef struct _SPI0_TRANSACTION
+{
+    SPI0_DEVICE *device;
+    const uint8_t *tx;
+    uint8_t *rx;
+    uint16_t length;
+    SPI0_TRANSACTION_CALLBACK callback;                 // optional, runs in interrupt context
+    volatile bool done;
+    volatile bool failed;
+} SPI0_TRANSACTION;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initSpi0Bus(uint32_t fcyc);
+void registerSpi0Device(SPI0_DEVICE *device);
+bool queueSpi0Transaction(SPI0_TRANSACTION *transaction);
+bool isSpi0BusIdle(void);
+
+#endif
@@ -0,0 +1,379 @@
+// SSI Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// SSI0: CLK PA2, FSS PA3, RX PA4, TX PA5, uDMA RX ch 10, TX ch 11 (encoding 0)
+// SSI1: CLK PF2, FSS PF3, RX PF0, TX PF1, uDMA RX ch 24, TX ch 25 (encoding 0)
+// SSI2: CLK PB4, FSS PB5, RX PB6, TX PB7, uDMA RX ch 12, TX ch 13 (encoding 2)
+// SSI3: CLK PD0, FSS PD1, RX PD2, TX PD3, uDMA RX ch 14, TX ch 15 (encoding 2)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "ssi.h"
+#include "gpio.h"
+#include "nvic.h"
+#include "udma.h"
+
+#define SSI_COUNT 4
+
+#define DMA_TX_CONTROL (UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_ARBSIZE_4)
+#define DMA_RX_CONTROL (UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_ARBSIZE_4)
+
+// Pins, uDMA channels and vector of a module
+typedef struct _SSI_MAP
+{
+    PORT port;
+    uint8_t clkPin;
+    uint8_t fssPin;
+    uint8_t rxPin;
+    uint8_t txPin;
+    uint32_t clkFn;
+    uint32_t fssFn;
+    uint32_t rxFn;
+    uint32_t txFn;
+    uint8_t rxChannel;
+    uint8_t txChannel;
+    uint8_t encoding;
+    uint8_t vector;
+} SSI_MAP;
+
+// DMA state of a module
+typedef struct _SSI_STATE
+{
+    volatile bool dmaBusy;
+    SSI_DMA_CALLBACK dmaCallback;
+    bool streaming;
+    volatile bool streamStop;
+    SSI_STREAM_CALLBACK streamCallback;
+    uint8_t *streamBuffer[2];
+    uint16_t streamLength;
+    PORT csPort;
+    uint8_t csPin;
+} SSI_STATE;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static const SSI_MAP ssiMap[SSI_COUNT] =
+{
+    {PORTA, 2, 3, 4, 5, GPIO_PCTL_PA2_SSI0CLK, GPIO_PCTL_PA3_SSI0FSS, GPIO_PCTL_PA4_SSI0RX, GPIO_PCTL_PA5_SSI0TX, 10, 11, 0, INT_SSI0},
+    {PORTF, 2, 3, 0, 1, GPIO_PCTL_PF2_SSI1CLK, GPIO_PCTL_PF3_SSI1FSS, GPIO_PCTL_PF0_SSI1RX, GPIO_PCTL_PF1_SSI1TX, 24, 25, 0, INT_SSI1},
+    {PORTB, 4, 5, 6, 7, GPIO_PCTL_PB4_SSI2CLK, GPIO_PCTL_PB5_SSI2FSS, GPIO_PCTL_PB6_SSI2RX, GPIO_PCTL_PB7_SSI2TX, 12, 13, 2, INT_SSI2},
+    {PORTD, 0, 1, 2, 3, GPIO_PCTL_PD0_SSI3CLK, GPIO_PCTL_PD1_SSI3FSS, GPIO_PCTL_PD2_SSI3RX, GPIO_PCTL_PD3_SSI3TX, 14, 15, 2, INT_SSI3}
+};
+
+static SSI_STATE ssiState[SSI_COUNT];
+
+static const uint8_t dmaFill = 0xFF;                    // tx source for read-only transactions
+static uint8_t dmaDiscard;                              // rx sink for write-only transactions
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Module number 0-3
+static uint8_t getSsiIndex(SSI ssi)
+{
+    return ((uint32_t)ssi - SSI0) >> 12;
+}
+
+// Initialize an SSI module as a SPI master, 8-bit frames
+void initSsi(SSI ssi, uint32_t pinMask)
+{
+    uint8_t n = getSsiIndex(ssi);
+    const SSI_MAP *map = &ssiMap[n];
+
+    // Enable clocks
+    SYSCTL_RCGCSSI_R |= 1 << n;
+    _delay_cycles(3);
+    enablePort(map->port);
+
+    // Configure pins for SPI configuration
+    selectPinPushPullOutput(map->port, map->txPin);
+    setPinAuxFunction(map->port, map->txPin, map->txFn);
+    selectPinPushPullOutput(map->port, map->clkPin);
+    setPinAuxFunction(map->port, map->clkPin, map->clkFn);
+    selectPinPushPullOutput(map->port, map->fssPin);
+    if (pinMask & USE_SSI_FSS)
+    {
+        setPinAuxFunction(map->port, map->fssPin, map->fssFn);
+    }
+    if (pinMask & USE_SSI_RX)
+    {
+        if (map->port == PORTF && map->rxPin == 0)
+            setPinCommitControl(PORTF, 0);              // PF0 is locked after reset
+        selectPinDigitalInput(map->port, map->rxPin);
+        setPinAuxFunction(map->port, map->rxPin, map->rxFn);
+    }
+
+    // Configure as a SPI master, mode 0, 8bit operation
+    SSI_REG(ssi, SSI_CR1) &= ~SSI_CR1_SSE;              // turn off SSI to allow re-configuration
+    SSI_REG(ssi, SSI_CR1) = 0;                          // select master mode
+    SSI_REG(ssi, SSI_CC) = 0;                           // select system clock as the clock source
+    SSI_REG(ssi, SSI_CR0) = SSI_CR0_FRF_MOTO | SSI_CR0_DSS_8;
+                                                        // set SR=0, 8-bit
+}
+
+// Set baud rate as function of instruction cycle frequency
+void setSsiBaudRate(SSI ssi, uint32_t baudRate, uint32_t fcyc)
+{
+    uint32_t divisorTimes2 = (fcyc * 2) / baudRate;    // calculate divisor (r) times 2
+    SSI_REG(ssi, SSI_CR1) &= ~SSI_CR1_SSE;              // turn off SSI to allow re-configuration
+    SSI_REG(ssi, SSI_CPSR) = (divisorTimes2 + 1) >> 1;  // round divisor to nearest integer
+    SSI_REG(ssi, SSI_CR1) |= SSI_CR1_SSE;               // turn on SSI
+}
+
+// Set mode
+void setSsiMode(SSI ssi, uint8_t polarity, uint8_t phase)
+{
+    const SSI_MAP *map = &ssiMap[getSsiIndex(ssi)];
+    SSI_REG(ssi, SSI_CR1) &= ~SSI_CR1_SSE;              // turn off SSI to allow re-configuration
+    SSI_REG(ssi, SSI_CR0) &= ~(SSI_CR0_SPH | SSI_CR0_SPO);
+                                                        // set SPO and SPH as appropriate
+    if (polarity)
+    {
+        SSI_REG(ssi, SSI_CR0) |= SSI_CR0_SPO;
+        enablePinPullup(map->port, map->clkPin);
+    }
+    else
+        disablePinPullup(map->port, map->clkPin);
+    if (phase)
+        SSI_REG(ssi, SSI_CR0) |= SSI_CR0_SPH;
+    SSI_REG(ssi, SSI_CR1) |= SSI_CR1_SSE;               // turn on SSI
+}
+
+// Set mode and baud rate with a single disable/enable of the module
+void configureSsi(SSI ssi, uint8_t polarity, uint8_t phase, uint32_t baudRate, uint32_t fcyc)
+{
+    const SSI_MAP *map = &ssiMap[getSsiIndex(ssi)];
+    uint32_t divisorTimes2 = (fcyc * 2) / baudRate;    // calculate divisor (r) times 2
+    uint32_t cr0 = SSI_REG(ssi, SSI_CR0) & ~(SSI_CR0_SPH | SSI_CR0_SPO);
+    if (polarity)
+    {
+        cr0 |= SSI_CR0_SPO;
+        enablePinPullup(map->port, map->clkPin);
+    }
+    else
+        disablePinPullup(map->port, map->clkPin);
+    if (phase)
+        cr0 |= SSI_CR0_SPH;
+    SSI_REG(ssi, SSI_CR1) &= ~SSI_CR1_SSE;              // turn off SSI to allow re-configuration
+    SSI_REG(ssi, SSI_CR0) = cr0;
+    SSI_REG(ssi, SSI_CPSR) = (divisorTimes2 + 1) >> 1;  // round divisor to nearest integer
+    SSI_REG(ssi, SSI_CR1) |= SSI_CR1_SSE;               // turn on SSI
+}
+
+// Full-duplex block transfer of 8-bit frames
+// The TX FIFO is kept topped up while RX is drained, so the clock runs back-to-back
+// tx = 0 sends 0xFF fill frames, rx = 0 discards received frames
+// The data and status register addresses are computed once, so the per-frame
+// loop is the same as with the fixed SSIx_DR_R / SSIx_SR_R macros
+void transferSsiData(SSI ssi, const uint8_t tx[], uint8_t rx[], uint32_t length)
+{
+    volatile uint32_t *dr = &SSI_REG(ssi, SSI_DR);
+    volatile uint32_t *sr = &SSI_REG(ssi, SSI_SR);
+    uint32_t sent = 0;
+    uint32_t received = 0;
+    uint8_t data;
+    while (*sr & SSI_SR_RNE)                            // discard stale rx frames
+        data = *dr;
+    while (received < length)
+    {
+        // at most 8 frames in flight, so the 8-deep RX FIFO can never overrun
+        while ((sent < length) && (sent - received < 8) && (*sr & SSI_SR_TNF))
+        {
+            *dr = tx ? tx[sent] : 0xFF;
+            sent++;
+        }
+        while (*sr & SSI_SR_RNE)
+        {
+            data = *dr;
+            if (rx)
+                rx[received] = data;
+            received++;
+        }
+    }
+}
+
+// Initialize the uDMA channels of a module
+void initSsiDma(SSI ssi)
+{
+    uint8_t n = getSsiIndex(ssi);
+    const SSI_MAP *map = &ssiMap[n];
+    SSI_STATE *state = &ssiState[n];
+    initUdma();
+    assignUdmaChannel(map->rxChannel, map->encoding);
+    assignUdmaChannel(map->txChannel, map->encoding);
+    SSI_REG(ssi, SSI_DMACTL) = 0;
+    state->csPort = map->port;                          // FSS pin as ~CS unless changed
+    state->csPin = map->fssPin;
+    setPinValue(state->csPort, state->csPin, 1);        // deassert ~CS
+    enableNvicInterrupt(map->vector);
+}
+
+// Selects the GPIO pin used as ~CS by the next DMA transactions
+void setSsiDmaChipSelect(SSI ssi, PORT port, uint8_t pin)
+{
+    SSI_STATE *state = &ssiState[getSsiIndex(ssi)];
+    state->csPort = port;
+    state->csPin = pin;
+}
+
+// Starts an asynchronous full-duplex transfer of 1-1024 frames
+// tx = 0 sends 0xFF fill frames, rx = 0 discards received frames
+// Buffers must stay valid until the callback runs or isSsiDmaBusy() returns false
+bool startSsiDma(SSI ssi, const uint8_t tx[], uint8_t rx[], uint16_t length, SSI_DMA_CALLBACK callback)
+{
+    uint8_t n = getSsiIndex(ssi);
+    const SSI_MAP *map = &ssiMap[n];
+    SSI_STATE *state = &ssiState[n];
+    if (state->dmaBusy || length == 0 || length > 1024)
+        return false;
+    state->dmaBusy = true;
+    state->dmaCallback = callback;
+    while (SSI_REG(ssi, SSI_SR) & SSI_SR_RNE)           // discard stale rx frames
+        dmaDiscard = SSI_REG(ssi, SSI_DR);
+
+    // rx channel completes last, so its interrupt ends the transaction
+    if (rx)
+        setUdmaTransfer(map->rxChannel, false, &SSI_REG(ssi, SSI_DR), rx, DMA_RX_CONTROL | UDMA_CHCTL_XFERMODE_BASIC, length);
+    else
+        setUdmaTransfer(map->rxChannel, false, &SSI_REG(ssi, SSI_DR), &dmaDiscard,
+                        (DMA_RX_CONTROL & ~UDMA_CHCTL_DSTINC_M) | UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_XFERMODE_BASIC, length);
+    if (tx)
+        setUdmaTransfer(map->txChannel, false, tx, &SSI_REG(ssi, SSI_DR), DMA_TX_CONTROL | UDMA_CHCTL_XFERMODE_BASIC, length);
+    else
+        setUdmaTransfer(map->txChannel, false, &dmaFill, &SSI_REG(ssi, SSI_DR),
+                        (DMA_TX_CONTROL & ~UDMA_CHCTL_SRCINC_M) | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_XFERMODE_BASIC, length);
+
+    setPinValue(state->csPort, state->csPin, 0);        // assert ~CS
+    enableUdmaChannel(map->rxChannel);
+    enableUdmaChannel(map->txChannel);
+    SSI_REG(ssi, SSI_DMACTL) = SSI_DMACTL_RXDMAE | SSI_DMACTL_TXDMAE;
+    return true;
+}
+
+// Starts a continuous write stream from two buffers of 1-1024 bytes each
+// While one buffer is sent the callback refills the other, received frames are discarded
+bool startSsiDmaStream(SSI ssi, uint8_t ping[], uint8_t pong[], uint16_t length, SSI_STREAM_CALLBACK callback)
+{
+    uint8_t n = getSsiIndex(ssi);
+    const SSI_MAP *map = &ssiMap[n];
+    SSI_STATE *state = &ssiState[n];
+    if (state->dmaBusy || length == 0 || length > 1024)
+        return false;
+    state->dmaBusy = true;
+    state->streaming = true;
+    state->streamStop = false;
+    state->streamCallback = callback;
+    state->streamBuffer[0] = ping;
+    state->streamBuffer[1] = pong;
+    state->streamLength = length;
+
+    setUdmaTransfer(map->txChannel, false, ping, &SSI_REG(ssi, SSI_DR), DMA_TX_CONTROL | UDMA_CHCTL_XFERMODE_PINGPONG, length);
+    setUdmaTransfer(map->txChannel, true, pong, &SSI_REG(ssi, SSI_DR), DMA_TX_CONTROL | UDMA_CHCTL_XFERMODE_PINGPONG, length);
+
+    setPinValue(state->csPort, state->csPin, 0);        // assert ~CS
+    enableUdmaChannel(map->txChannel);
+    SSI_REG(ssi, SSI_DMACTL) = SSI_DMACTL_TXDMAE;
+    return true;
+}
+
+// Stream ends after the buffer in flight
+void stopSsiDmaStream(SSI ssi)
+{
+    ssiState[getSsiIndex(ssi)].streamStop = true;
+}
+
+bool isSsiDmaBusy(SSI ssi)
+{
+    return ssiState[getSsiIndex(ssi)].dmaBusy;
+}
+
+// Ends a DMA transaction once the last frame has been shifted out
+static void finishSsiDma(SSI ssi, SSI_STATE *state)
+{
+    SSI_REG(ssi, SSI_DMACTL) = 0;
+    while (SSI_REG(ssi, SSI_SR) & SSI_SR_BSY);
+    setPinValue(state->csPort, state->csPin, 1);        // deassert ~CS
+    state->dmaBusy = false;
+}
+
+// uDMA completion of the channels of a module
+static void handleSsiInterrupt(SSI ssi)
+{
+    uint8_t n = getSsiIndex(ssi);
+    const SSI_MAP *map = &ssiMap[n];
+    SSI_STATE *state = &ssiState[n];
+    uint8_t i;
+    if (getUdmaChannelInterrupt(map->txChannel))
+    {
+        clearUdmaChannelInterrupt(map->txChannel);
+        if (!state->streaming)
+            SSI_REG(ssi, SSI_DMACTL) &= ~SSI_DMACTL_TXDMAE; // no more tx requests, rx finishes the transaction
+        else
+        {
+            // re-arm each finished half unless the stream is ending
+            for (i = 0; i < 2; i++)
+            {
+                if (isUdmaControlDone(map->txChannel, i) && !state->streamStop)
+                {
+                    if (state->streamCallback && state->streamCallback(state->streamBuffer[i]))
+                        setUdmaTransfer(map->txChannel, i, state->streamBuffer[i], &SSI_REG(ssi, SSI_DR),
+                                        DMA_TX_CONTROL | UDMA_CHCTL_XFERMODE_PINGPONG, state->streamLength);
+                    else
+                        state->streamStop = true;
+                }
+            }
+            // channel disables itself when it reaches a structure left stopped
+            if (!isUdmaChannelEnabled(map->txChannel))
+            {
+                finishSsiDma(ssi, state);
+                while (SSI_REG(ssi, SSI_SR) & SSI_SR_RNE)   // discard frames received while streaming
+                    dmaDiscard = SSI_REG(ssi, SSI_DR);
+                SSI_REG(ssi, SSI_ICR) = SSI_ICR_RORIC;
+                state->streaming = false;
+            }
+        }
+    }
+    if (getUdmaChannelInterrupt(map->rxChannel))
+    {
+        clearUdmaChannelInterrupt(map->rxChannel);
+        finishSsiDma(ssi, state);
+        if (state->dmaCallback)
+            state->dmaCallback();
+    }
+}
+
+void ssi0Isr(void)
+{
+    handleSsiInterrupt(SSI0);
+}
+
+void ssi1Isr(void)
+{
+    handleSsiInterrupt(SSI1);
+}
+
+void ssi2Isr(void)
+{
+    handleSsiInterrupt(SSI2);
+}
+
+void ssi3Isr(void)
+{
+    handleSsiInterrupt(SSI3);
+}
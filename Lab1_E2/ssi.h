@@ -0,0 +1,101 @@
+// SSI Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// SSI0: CLK PA2, FSS PA3, RX PA4, TX PA5, uDMA RX ch 10, TX ch 11 (encoding 0)
+// SSI1: CLK PF2, FSS PF3, RX PF0, TX PF1, uDMA RX ch 24, TX ch 25 (encoding 0)
+// SSI2: CLK PB4, FSS PB5, RX PB6, TX PB7, uDMA RX ch 12, TX ch 13 (encoding 2)
+// SSI3: CLK PD0, FSS PD1, RX PD2, TX PD3, uDMA RX ch 14, TX ch 15 (encoding 2)
+// ssi0Isr ... ssi3Isr must be on the SSI0 ... SSI3 vectors when DMA is used
+// DMA transactions drive ~CS as a GPIO, so call initSsi() without USE_SSI_FSS
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SSI_H_
+#define SSI_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "gpio.h"
+
+#define USE_SSI_FSS 3
+#define USE_SSI_RX  4
+
+// Enum values set to the base address of the SSI module
+typedef enum _SSI
+{
+    SSI0 = 0x40008000,
+    SSI1 = 0x40009000,
+    SSI2 = 0x4000A000,
+    SSI3 = 0x4000B000
+} SSI;
+
+// Register offsets from the base address
+#define SSI_CR0     0x000
+#define SSI_CR1     0x004
+#define SSI_DR      0x008
+#define SSI_SR      0x00C
+#define SSI_CPSR    0x010
+#define SSI_IM      0x014
+#define SSI_ICR     0x020
+#define SSI_DMACTL  0x024
+#define SSI_CC      0xFC8
+
+// Register of an SSI module, a constant address when ssi is a constant
+#define SSI_REG(ssi, ofs) (*((volatile uint32_t *)((uint32_t)(ssi) + (ofs))))
+
+// Called from the SSI ISR when a DMA transaction has completed
+typedef void (*SSI_DMA_CALLBACK)(void);
+// Called from the SSI ISR with the stream buffer that was just sent
+// Refill it and return true to keep streaming, or return false to stop
+typedef bool (*SSI_STREAM_CALLBACK)(uint8_t buffer[]);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initSsi(SSI ssi, uint32_t pinMask);
+void setSsiBaudRate(SSI ssi, uint32_t baudRate, uint32_t fcyc);
+void setSsiMode(SSI ssi, uint8_t polarity, uint8_t phase);
+void configureSsi(SSI ssi, uint8_t polarity, uint8_t phase, uint32_t baudRate, uint32_t fcyc);
+void transferSsiData(SSI ssi, const uint8_t tx[], uint8_t rx[], uint32_t length);
+
+void initSsiDma(SSI ssi);
+void setSsiDmaChipSelect(SSI ssi, PORT port, uint8_t pin);
+bool startSsiDma(SSI ssi, const uint8_t tx[], uint8_t rx[], uint16_t length, SSI_DMA_CALLBACK callback);
+bool startSsiDmaStream(SSI ssi, uint8_t ping[], uint8_t pong[], uint16_t length, SSI_STREAM_CALLBACK callback);
+void stopSsiDmaStream(SSI ssi);
+bool isSsiDmaBusy(SSI ssi);
+
+void ssi0Isr(void);
+void ssi1Isr(void);
+void ssi2Isr(void);
+void ssi3Isr(void);
+
+// Per-frame access is inline, so with a constant ssi it costs the same as
+// the SSIx_DR_R / SSIx_SR_R macros
+
+// Blocking function that writes data and waits until the tx buffer is empty
+static inline void writeSsiData(SSI ssi, uint32_t data)
+{
+    SSI_REG(ssi, SSI_DR) = data;
+    while (SSI_REG(ssi, SSI_SR) & SSI_SR_BSY);
+}
+
+// Reads data from the rx buffer after a write
+static inline uint32_t readSsiData(SSI ssi)
+{
+    return SSI_REG(ssi, SSI_DR);
+}
+
+#endif
@@ -0,0 +1,110 @@
+// uDMA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// uDMA controller, channels 0-31
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "udma.h"
+
+#define UDMA_CHANNELS 32
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Primary structures in 0-31, alternate structures in 32-63
+// The controller requires the table to be aligned to its size
+// volatile, the controller rewrites the control words as it runs
+#pragma DATA_ALIGN(udmaTable, 1024)
+volatile UDMA_CONTROL udmaTable[UDMA_CHANNELS * 2];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize uDMA controller
+void initUdma(void)
+{
+    SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;
+    _delay_cycles(3);
+    UDMA_CFG_R = UDMA_CFG_MASTEN;                       // enable controller
+    UDMA_CTLBASE_R = (uint32_t)udmaTable;               // channel control table
+}
+
+// Selects the peripheral (encoding 0-4 from the channel assignment table) of a channel
+void assignUdmaChannel(uint8_t channel, uint8_t encoding)
+{
+    volatile uint32_t* p = (uint32_t*) &UDMA_CHMAP0_R;
+    uint32_t shift = (channel & 7) * 4;
+    p += channel >> 3;
+    *p = (*p & ~(0xF << shift)) | (encoding << shift);
+    UDMA_ALTCLR_R = 1 << channel;                       // start on the primary structure
+    UDMA_USEBURSTCLR_R = 1 << channel;                  // accept single and burst requests
+    UDMA_REQMASKCLR_R = 1 << channel;                   // allow peripheral requests
+}
+
+// Fills the primary or alternate control structure of a channel
+// control holds the size, increment, arbitration and mode fields, count is 1-1024 items
+void setUdmaTransfer(uint8_t channel, bool alternate, const volatile void *src, volatile void *dst,
+                     uint32_t control, uint16_t count)
+{
+    volatile UDMA_CONTROL *entry = &udmaTable[channel + (alternate ? UDMA_CHANNELS : 0)];
+    uint32_t srcInc = (control & UDMA_CHCTL_SRCINC_M) >> 26;    // 0=8, 1=16, 2=32, 3=none
+    uint32_t dstInc = (control & UDMA_CHCTL_DSTINC_M) >> 30;
+    // end pointers address the last item
+    entry->srcEnd = (uint32_t)src + ((srcInc == 3) ? 0 : (uint32_t)(count - 1) << srcInc);
+    entry->dstEnd = (uint32_t)dst + ((dstInc == 3) ? 0 : (uint32_t)(count - 1) << dstInc);
+    entry->control = (control & ~UDMA_CHCTL_XFERSIZE_M) | ((uint32_t)(count - 1) << UDMA_CHCTL_XFERSIZE_S);
+}
+
+void enableUdmaChannel(uint8_t channel)
+{
+    UDMA_ENASET_R = 1 << channel;
+}
+
+void disableUdmaChannel(uint8_t channel)
+{
+    UDMA_ENACLR_R = 1 << channel;
+}
+
+bool isUdmaChannelEnabled(uint8_t channel)
+{
+    return (UDMA_ENASET_R >> channel) & 1;
+}
+
+bool isUdmaAlternateActive(uint8_t channel)
+{
+    return (UDMA_ALTSET_R >> channel) & 1;
+}
+
+// A finished structure has its mode set back to stop by the controller
+bool isUdmaControlDone(uint8_t channel, bool alternate)
+{
+    volatile UDMA_CONTROL *entry = &udmaTable[channel + (alternate ? UDMA_CHANNELS : 0)];
+    return (entry->control & UDMA_CHCTL_XFERMODE_M) == UDMA_CHCTL_XFERMODE_STOP;
+}
+
+// Completion status, raised on the vector of the peripheral that owns the channel
+bool getUdmaChannelInterrupt(uint8_t channel)
+{
+    return (UDMA_CHIS_R >> channel) & 1;
+}
+
+void clearUdmaChannelInterrupt(uint8_t channel)
+{
+    UDMA_CHIS_R = 1 << channel;
+}
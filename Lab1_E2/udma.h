@@ -0,0 +1,49 @@
+// uDMA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// uDMA controller, channels 0-31
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef UDMA_H_
+#define UDMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Channel control structure (SRCENDP, DSTENDP, CHCTL)
+typedef struct _UDMA_CONTROL
+{
+    uint32_t srcEnd;
+    uint32_t dstEnd;
+    uint32_t control;
+    uint32_t unused;
+} UDMA_CONTROL;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initUdma(void);
+void assignUdmaChannel(uint8_t channel, uint8_t encoding);
+void setUdmaTransfer(uint8_t channel, bool alternate, const volatile void *src, volatile void *dst,
+                     uint32_t control, uint16_t count);
+void enableUdmaChannel(uint8_t channel);
+void disableUdmaChannel(uint8_t channel);
+bool isUdmaChannelEnabled(uint8_t channel);
+bool isUdmaAlternateActive(uint8_t channel);
+bool isUdmaControlDone(uint8_t channel, bool alternate);
+bool getUdmaChannelInterrupt(uint8_t channel);
+void clearUdmaChannelInterrupt(uint8_t channel);
+
+#endif
@@ -9,6 +9,7 @@
 // Mask
 #define GREEN_LED_MASK 8
 
+#ifdef __TI_COMPILER_VERSION__
 void wait3seconds(void) {
 
     __asm("N .field 17142857                              ");   // N = 17,142,857
@@ -22,6 +23,9 @@ void wait3seconds(void) {
     __asm("END:    BX LR           ; ------               ");
     __asm("                        ; 7N-2 = 120,000,000   ");
 }
+#else
+extern void wait3seconds(void);                             // Gcc/wait3.S, the GNU syntax copy
+#endif
 
 void initHw() {
     // Initialize system clock to 40 MHz
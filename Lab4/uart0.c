@@ -51,11 +51,11 @@ void initUart0()
     GPIO_PORTA_PCTL_R |= GPIO_PCTL_PA1_U0TX | GPIO_PCTL_PA0_U0RX;
                                                         // select UART0 to drive pins PA0 and PA1: default, added for clarity
 
-    // Configure UART0 to 115200 baud (assuming fcyc = 40 MHz), 8N1 format
+    // Configure UART0 to 19200 baud (assuming fcyc = 40 MHz), 8N1 format
     UART0_CTL_R = 0;                                    // turn-off UART0 to allow safe programming
     UART0_CC_R = UART_CC_CS_SYSCLK;                     // use system clock (40 MHz)
-    UART0_IBRD_R = 130;                                  // r = 40 MHz / (Nx115.2kHz), set floor(r)=21, where N=16
-    UART0_FBRD_R = 13;                                  // round(fract(r)*64)=45
+    UART0_IBRD_R = 130;                                 // r = 40 MHz / (Nx19.2kHz), set floor(r)=130, where N=16
+    UART0_FBRD_R = 13;                                  // round(fract(r)*64)=13
     UART0_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;    // configure for 8N1 w/ 16-level FIFO
     UART0_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
                                                         // enable TX, RX, and module
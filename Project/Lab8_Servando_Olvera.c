@@ -12,13 +12,24 @@
 // Hardware configuration:
 // Green LED:
 //   PF3 drives an NPN transistor that powers the green LED
+// Timer 5 (free running, see gpio_irq.c) also timestamps the feeding timer deadlines
+// Linked at 0x4000 behind the Bootloader project, which must be flashed first
+
+// Interrupt priorities (0 highest):
+//   0 level capture   WTIMER1A starts the tick count, COMP0 captures it
+//   1 feeding         HIB alarm starts an event, TIMER2A/TIMER3A stop food/water,
+//                     PWM0 generator 3 ramps the food motor
+//   2 UART            UART0 transmit queue (telemetry and text output)
+//   3 housekeeping    GPIOF motion sensor and its TIMER5A debounce, the level
+//                     control step (COMP0 pends the unused COMP1 vector for it)
+// Settings used from interrupts are cached in RAM, so only main and the
+// feeding ISRs access the EEPROM, and main masks the feeding ISRs while it does
 
 //-----------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
 //-----------------------------------------------------------------------------
 
 #include <stdint.h>
-#include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
 #include "clock.h"
@@ -27,6 +38,15 @@
 #include "uart0.h"
 #include "string.h"
 #include "eeprom.h"
+#include "gpio.h"
+#include "gpio_irq.h"
+#include "nvic.h"
+#include "motor.h"
+#include "eventlog.h"
+#include "history.h"
+#include "telemetry.h"
+#include "format.h"
+#include "macro.h"
 
 // Pin bit-bands
 #define RED_LED     (*((volatile uint32_t *)(0x42000000 + (0x400253FC-0x40000000)*32 + 1*4)))   // PF1
@@ -54,10 +74,52 @@
 #define DISH_MASK 2         // 2^1
 #define BUZZER_MASK 1       // 2^0
 
+#define FOOD_RAMP_MS 500    // soft start and stop of the food motor
+
+#define UART_BAUD 19200                                         // at reset, the baud command changes it
+#define BAUD_SYNC_TIMEOUT_MS 10000
+#define LEVEL_PERIOD_MS 10000                                   // level control, log and history period
+#define TELEMETRY_MIN_PERIOD_MS(baud) ((TELEMETRY_PACKET_SIZE * 10 * 1000) / (baud) + 1)
+                                                                // a packet per period fits the UART
+#define COMMAND_LINE_SIZE 255                                   // characters, commands separated by ;
+#define BATCH_SIZE 64                                           // staged EEPROM words, 10 events and 3 settings fit
+
+// Interrupt priorities
+#define PRIORITY_LEVEL          0
+#define PRIORITY_FEED           1
+#define PRIORITY_UART           2
+#define PRIORITY_HOUSEKEEPING   3
+
+typedef struct _IRQ_PRIORITY
+{
+    uint8_t vector;
+    uint8_t priority;
+} IRQ_PRIORITY;
+
+// EEPROM words changed by the commands of a line, written once the line has run
+typedef struct _SETTINGS_BATCH
+{
+    uint8_t count;
+    bool alarm;                                 // an event changed, the alarm is reseeded
+    uint16_t address[BATCH_SIZE];
+    uint32_t data[BATCH_SIZE];
+} SETTINGS_BATCH;
+
+// Worst-case latency slots, in system clocks from the event to the ISR
+typedef enum _LATENCY
+{
+    LATENCY_LEVEL,
+    LATENCY_FEED_START,
+    LATENCY_FEED_STOP,
+    LATENCY_WATER_STOP,
+    LATENCY_COUNT
+} LATENCY;
+
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
-char str[100];
+
+extern void (* const g_pfnVectors[])(void);         // tm4c123gh6pm_startup_ccs.c
 
 uint32_t EVENT_TO_RUN = 0;
 //uint32_t Wide_Timer_Runs = 0;
@@ -72,23 +134,87 @@ uint32_t NUM_EVENTS = 0;
 #define FILL_MODE       11
 #define ALERT_ON_OFF    12
 
+// Copies of the EEPROM settings for the ISRs
+uint32_t desiredLevel = 0;
+uint32_t autoMode = 0;
+uint32_t alertOn = 0;
+
+static const IRQ_PRIORITY irqPriorities[] =
+{
+    {INT_WTIMER1A,  PRIORITY_LEVEL},
+    {INT_COMP0,     PRIORITY_LEVEL},
+    {INT_HIBERNATE, PRIORITY_FEED},
+    {INT_TIMER2A,   PRIORITY_FEED},
+    {INT_TIMER3A,   PRIORITY_FEED},
+    {INT_PWM0_3,    PRIORITY_FEED},
+    {INT_UART0,     PRIORITY_UART},
+    {INT_GPIOF,     PRIORITY_HOUSEKEEPING},
+    {INT_TIMER5A,   PRIORITY_HOUSEKEEPING},     // must match INT_GPIOF
+    {INT_COMP1,     PRIORITY_HOUSEKEEPING}      // level control, DispenseWater() like GPIOF
+};
+
+uint32_t uartBaud = UART_BAUD;
+
+char commandLine[COMMAND_LINE_SIZE+1];
+char macroName[MACRO_NAME_SIZE+1];
+char macroBody[MACRO_BODY_SIZE+1];
+bool runningMacro = false;
+SETTINGS_BATCH batch;
+
+// Telemetry raises the level sample rate, control still runs every LEVEL_PERIOD_MS
+bool telemetryOn = false;
+uint32_t samplesPerControl = 1;
+uint32_t levelSamples = 0;
+
+// Sample handed from comprt0Isr() to levelControlIsr()
+uint32_t controlTicks = 0;
+int controlLevel = 0;
+
+uint32_t maxLatency[LATENCY_COUNT];
+uint32_t feedDeadline = 0;                      // Timer 5 value when the food and water timers expire
+uint32_t waterDeadline = 0;
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
+void recordLatency(LATENCY n, uint32_t cycles) {
+    if(cycles > maxLatency[n]) {
+        maxLatency[n] = cycles;
+    }
+}
+
+// Apply the priority table before any interrupt is enabled
+void initPriorities() {
+    uint8_t i;
+    for(i = 0; i < sizeof(irqPriorities)/sizeof(irqPriorities[0]); i++) {
+        setNvicInterruptPriority(irqPriorities[i].vector, irqPriorities[i].priority);
+    }
+}
+
+void loadSettings() {
+    desiredLevel = readEeprom(VOLUME_LEVEL * 16);
+    autoMode = readEeprom(FILL_MODE * 16);
+    alertOn = readEeprom(ALERT_ON_OFF * 16);
+}
+
 // Initialize Hardware
 void initHw()
 {
     // Initialize system clock to 40 MHz
     initSystemClockTo40Mhz();
 
-    // Enable clocks
-    SYSCTL_RCGCPWM_R |= SYSCTL_RCGCPWM_R0;          // PWM
+    // Take interrupts through this image's vector table (0x4000), the bootloader
+    // sets it before starting the image but a debugger load starts it directly.
+    // A reset still goes through the bootloader at 0x0, flash it first
+    NVIC_VTABLE_R = (uint32_t)g_pfnVectors;
 
+    initPriorities();
+
+    // Enable clocks
     SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;      // Regular timer 1 clock
     SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;      // Regulat timer 2 clock
     SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R3;      // Regulat timer 3 clock
-    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R4;      // Regulat timer 4 clock
 
     SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R1;    // Wide timer 1 clock
 
@@ -136,32 +262,10 @@ void initHw()
     GPIO_PORTC_DEN_R |= WATER_MASK;
 
     // PWM
-    // PC4 M0PWM6  Gen3a
+    // PC4 M0PWM6  Gen3a (water pump stays a GPIO output)
     // PC5 M0PWM7  Gen3b
-    // ----------------------------------------------------------------------------------------
-    GPIO_PORTC_DEN_R |= FOOD_MASK;                                      // Dig Enable on motors
-    GPIO_PORTC_AFSEL_R |= FOOD_MASK;                                    // Alternative function
-    GPIO_PORTC_PCTL_R &= ~(GPIO_PCTL_PC5_M);
-    GPIO_PORTC_PCTL_R |= GPIO_PCTL_PC5_M0PWM7;                          // PWM functionality
-
-    SYSCTL_SRPWM_R = SYSCTL_SRPWM_R0;                                   // reset PWM0 module
-    SYSCTL_SRPWM_R = 0;                                                 // leave reset state
-
-    PWM0_3_CTL_R = 0;                                                   // turn-off PWM0 generator 3 (drives outs 6 and 7)
-
-    //PWM0_3_GENA_R |= PWM_0_GENA_ACTCMPAD_ONE | PWM_0_GENA_ACTLOAD_ZERO;  // output 6 on PWM0, gen 3a, cmpb
-    PWM0_3_GENB_R |= PWM_0_GENB_ACTCMPBD_ONE | PWM_0_GENB_ACTLOAD_ZERO; // output 7 on PWM0, gen 3b, cmpb
-
-    PWM0_3_LOAD_R = 1024;
-
-    //PWM0_3_CMPA_R = 0;                                                // PC4 off (0=always low, 1023=always high)
-    PWM0_3_CMPB_R = 0;                                                  // PC5 off (0=always low, 1023=always high)
-
-    PWM0_3_CTL_R = PWM_0_CTL_ENABLE;                                    // turn-on PWM0 generator 2
-
-    PWM0_ENABLE_R |= PWM_ENABLE_PWM7EN;
-
-    // ---------------------------------------------------------------------------------------
+    initMotors();
+    enableMotor(MOTOR_FOOD);
 
 
     // Analog Comp
@@ -185,10 +289,11 @@ void initHw()
     // Configure Wide Timer
     WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;               // turn-off counter before reconfiguring
     WTIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;        // configure for periodic counter
-    WTIMER1_TAILR_R = 400000000;                    // 10 seconds interrupt
+    WTIMER1_TAILR_R = LEVEL_PERIOD_MS * 40000;      // 10 seconds interrupt
     WTIMER1_IMR_R = TIMER_IMR_TATOIM;               // turn-on interrupts
     WTIMER1_CTL_R |= TIMER_CTL_TAEN;                // turn-on counter
     NVIC_EN3_R = 1 << (INT_WTIMER1A-16-96);         // turn-on interrupt 112 (WTIMER1A)
+    NVIC_EN0_R = 1 << (INT_COMP1-16);               // turn-on interrupt 42, pended by software only
 
     // Timer 2 PWM FOOD
     TIMER2_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off timer before reconfiguring
@@ -201,17 +306,11 @@ void initHw()
     TIMER3_TAMR_R |= TIMER_TAMR_TAMR_1_SHOT;        // count down
     TIMER3_IMR_R = TIMER_IMR_TATOIM;                // turn-on interrupts
     NVIC_EN1_R = 1 << (INT_TIMER3A-16-32);          // turn-on interrupt 35
-
-    // Timer 4 check for pet every 2 secs
-    TIMER4_CTL_R &= ~TIMER_CTL_TAEN;                // turn-off timer before reconfiguring
-    TIMER4_TAMR_R |= TIMER_TAMR_TAMR_PERIOD;        // Peridic
-    TIMER4_TAILR_R = 2 * (40000000);                // Motion -> check for pet evry 2 secs
-    TIMER4_IMR_R = TIMER_IMR_TATOIM;                // turn-on interrupts
-    TIMER4_CTL_R |= TIMER_CTL_TAEN;                 // turn-on timer
-    NVIC_EN2_R = 1 << (INT_TIMER4A-16-64);          // turn-on interrupt 70
 }
 
 void wideTimer1Isr() {
+    recordLatency(LATENCY_LEVEL, WTIMER1_TAILR_R - WTIMER1_TAV_R);  // counter reloaded at the timeout
+
     DISH = 1;
     waitMicrosecond(10);
     DISH = 0;
@@ -230,29 +329,32 @@ void DispenseWater(uint32_t disp_time) {
     WATER = 1;
 
     TIMER3_TAILR_R = disp_time * (40000000);
+    waterDeadline = TIMER5_TAV_R + TIMER3_TAILR_R;
     TIMER3_CTL_R |= TIMER_CTL_TAEN;                 // turn-on timer
+
+    logEvent(LOG_PUMP_ON, disp_time);
 }
 
 void timer3Isr() {
+    recordLatency(LATENCY_WATER_STOP, TIMER5_TAV_R - waterDeadline);
+
     WATER = 0;
+    logEvent(LOG_PUMP_OFF, 0);
 
     TIMER3_ICR_R = TIMER_ICR_TATOCINT;              // Clear flag
 }
 
-void timer4Isr() {
-    uint32_t auto_mode = readEeprom(FILL_MODE * 16);
-
-    GREEN_LED = SENSOR;
+void motionIsr(PORT port, uint8_t pin, bool value) {
+    GREEN_LED = value;
+    logEvent(LOG_MOTION, value);
 
-    if(!auto_mode && SENSOR) {                          // If in motion mode
+    if(!autoMode && value) {                           // If in motion mode
         if(level < 400) {                               // If not alredy full
             if(WATER != 1) {                            // If not already running
                 DispenseWater(5);                       // Dispense water for 7 secs
             }
         }
     }
-
-    TIMER4_ICR_R = TIMER_ICR_TATOCINT;              // Clear flag
 }
 
 // 1/2 cycle --> 183 us
@@ -282,19 +384,38 @@ void comprt0Isr() {
     level = 50 * (int)(((float)free_timer-2370)/(48));          // Equation to get mL based on number of ticks
     if(level < 0) { level = 0;}                                 // Negative, make it 0
 
-    uint32_t desired_level = readEeprom(VOLUME_LEVEL * 16);
-    uint32_t auto_mode = readEeprom(FILL_MODE * 16);
-    uint32_t alarm_on_off = readEeprom(ALERT_ON_OFF * 16);
+    if(telemetryOn) {
+        uint16_t motor = getMotorSpeed(MOTOR_FOOD);
+        uint8_t flags = (WATER ? TELEMETRY_PUMP : 0) | (motor ? TELEMETRY_MOTOR : 0)
+                      | (isMotorRamping(MOTOR_FOOD) ? TELEMETRY_RAMPING : 0) | (SENSOR ? TELEMETRY_MOTION : 0);
+        sendTelemetry(free_timer, level, motor, flags);
+    }
+
+    if(++levelSamples >= samplesPerControl) {                   // Extra telemetry samples get no control
+        levelSamples = 0;
+        controlTicks = free_timer;
+        controlLevel = level;
+        NVIC_SW_TRIG_R = INT_COMP1-16;                          // Control step at housekeeping priority
+    }
+
+    COMP_ACMIS_R = COMP_ACMIS_IN0;                                  // Clear interrupt flag
+}
+
+// Level control, every LEVEL_PERIOD_MS
+// Pended by comprt0Isr() so the waits of the alert don't hold off the capture and feeding ISRs
+void levelControlIsr() {
+    logEvent(LOG_LEVEL, controlLevel);
+    updateHistory();                                            // May program a batch into flash
 
-    //snprintf(str, sizeof(str), "Water lever: ~%dmL   Desired Level: %d   Ticks: %d\n", level , desired_level, free_timer);
+    //snprintf(str, sizeof(str), "Water lever: ~%dmL   Desired Level: %d   Ticks: %d\n", level , desiredLevel, free_timer);
     //putsUart0(str);
 
-    if(level < desired_level && auto_mode && free_timer > 100) {
+    if(controlLevel < desiredLevel && autoMode && controlTicks > 100) {
         if(WATER != 1) {
             DispenseWater(15);              // Dispense Water for 15 secs
         }
 
-        if(alarm_on_off ) {
+        if(alertOn) {
             RED_LED = 1;
             buzzer();
             RED_LED = 0;
@@ -308,10 +429,41 @@ void comprt0Isr() {
             RED_LED = 0;
         }
     }
+}
 
-    COMP_ACMIS_R = COMP_ACMIS_IN0;                                  // Clear interrupt flag
+
+// The divisor of LEVEL_PERIOD_MS nearest to ms and not below minimum, so the
+// control, log and history steps stay exactly LEVEL_PERIOD_MS apart
+uint32_t getLevelPeriod(uint32_t ms, uint32_t minimum) {
+    uint32_t best = LEVEL_PERIOD_MS;
+    uint32_t bestError = LEVEL_PERIOD_MS - ms;
+    uint32_t n, divisor, error;
+
+    for(n = 2; n <= LEVEL_PERIOD_MS; n++) {
+        if(LEVEL_PERIOD_MS % n != 0) {
+            continue;
+        }
+        divisor = LEVEL_PERIOD_MS / n;
+        if(divisor < minimum) {
+            break;
+        }
+        error = divisor > ms ? divisor - ms : ms - divisor;
+        if(error < bestError) {
+            best = divisor;
+            bestError = error;
+        }
+    }
+    return best;
 }
 
+// Level sample period, a divisor of LEVEL_PERIOD_MS
+void setLevelPeriod(uint32_t ms) {
+    WTIMER1_CTL_R &= ~TIMER_CTL_TAEN;               // turn-off counter before reconfiguring
+    samplesPerControl = LEVEL_PERIOD_MS / ms;
+    levelSamples = 0;
+    WTIMER1_TAILR_R = ms * 40000;
+    WTIMER1_CTL_R |= TIMER_CTL_TAEN;                // turn-on counter
+}
 
 int checkRTCC() {
     uint32_t time1 = HIB_RTCC_R;
@@ -319,6 +471,7 @@ int checkRTCC() {
     uint32_t time2 = HIB_RTCC_R;                                    // Obtain a valid read from RTCC
 
     if(time1 != time2) {
+        logEvent(LOG_ERROR, LOG_ERROR_RTC_READ);
         putsUart0("ERROR: Invalid Read from RTC\n");
         return -1;
     }
@@ -379,7 +532,7 @@ void setAlarm() {
         HIB_RTCM0_R = 0xFFFFFFFF;                                                       // No events --> MATCH = Biggest Possible value;
     }
     else if(num_events > 0 && event_today == 0) {
-        HIB_RTCM0_R = real_time + event_times[next_event] + (86400 - real_time % 8600); // No event today. Calculate time till next day
+        HIB_RTCM0_R = real_time + event_times[next_event] + (86400 - real_time % 86400);    // No event today. Calculate time till next day
     }
     else if(num_events > 0 && event_today == 1) {
         HIB_RTCM0_R = real_time + event_times[next_event] - (real_time % 86400);        // Event today. Calculate time till match time
@@ -392,228 +545,582 @@ void setAlarm() {
     NUM_EVENTS = num_events;
 }
 
+// Streams the event log, oldest record first
+void printLog() {
+    const char *names[] = {"feed start", "feed stop", "pump on", "pump off", "level", "motion", "error"};
+    uint32_t head = getLogHead();
+    uint32_t i = head > LOG_SIZE ? head - LOG_SIZE : 0;
+    LOG_RECORD record;
+
+    for(; i < head; i++) {
+        if(readLogRecord(i, &record) != LOG_READ_OK) {              // Overwritten while printing
+            continue;
+        }
+        uint32_t secs = record.seconds % 86400;
+        uint32_t ms = (LOG_RECORD_SUBSECONDS(&record) * 1000) >> 15;
+        putfUart0("%02d:%02d:%02d.%03d %s %d\n", secs / 3600, (secs / 60) % 60, secs % 60, ms,
+                  names[LOG_RECORD_TYPE(&record)], record.payload);
+    }
+}
+
+void printHistoryRecord(HISTORY_TYPE type, uint32_t seconds, uint16_t value) {
+    const char *names[] = {"level", "feed start", "feed stop", "pump on"};
+    uint32_t secs = seconds % 86400;
+
+    putfUart0("Day %d %02d:%02d:%02d %s %d\n", seconds / 86400, secs / 3600, (secs / 60) % 60, secs % 60,
+              names[type], value);
+}
+
+// Reads the events with the feeding ISRs masked, then prints them with the
+// UART interrupt free to drain the queue (the table is larger than the queue)
 void printInfoEvents() {
     int32_t data[10][5];
+    uint32_t num_events, event_today, event_to_run;
     uint32_t i;
+
+    uint32_t state = enterNvicCritical(PRIORITY_FEED);
     for(i = 0; i < 10; i++) {
         int j;
         for(j = 0; j < 5; j++) {
             data[i][j] = readEeprom( i * 16 + j);
         }
     }
+    num_events = NUM_EVENTS;
+    event_today = EVENT_TODAY;
+    event_to_run = EVENT_TO_RUN;
+    leaveNvicCritical(state);
 
     for(i = 0; i < 10; i++) {
-        snprintf(str, sizeof(str), "Event[%d] --> Dur:%d   PWM:%d   Hr:%d   Min:%d\n", i, data[i][1], data[i][2], data[i][3], data[i][4]);
-        putsUart0(str);
+        putfUart0("Event[%d] --> Dur:%d   PWM:%d   Hr:%d   Min:%d\n", i, data[i][1], data[i][2], data[i][3], data[i][4]);
     }
 
-    if(NUM_EVENTS == 0) {
+    if(num_events == 0) {
         putsUart0("No events scheduled yet\n");
     }
-    else if(NUM_EVENTS > 0 && EVENT_TODAY == 0) {
+    else if(num_events > 0 && event_today == 0) {
         putsUart0("No events today\n");
     }
-    else if(NUM_EVENTS > 0 && EVENT_TODAY == 1) {
-        snprintf(str, sizeof(str), "Event %d scheduled later today\n", EVENT_TO_RUN);
-        putsUart0(str);
+    else if(num_events > 0 && event_today == 1) {
+        putfUart0("Event %d scheduled later today\n", event_to_run);
     }
 
-    snprintf(str, sizeof(str), "Current Water level ~ %d mL\n", level);
-    putsUart0(str);
+    putfUart0("Current Water level ~ %d mL\n", level);
 
 }
 
 void timer2Isr() {
-    PWM0_3_CMPB_R = 0;
+    recordLatency(LATENCY_FEED_STOP, TIMER5_TAV_R - feedDeadline);
+
+    setMotorSpeed(MOTOR_FOOD, 0, RAMP_S_CURVE, FOOD_RAMP_MS);     // Soft stop
+    logEvent(LOG_FEED_STOP, EVENT_TO_RUN);
 
-    snprintf(str, sizeof(str), "Event %d Completed. Reseeding...\n", EVENT_TO_RUN);
-    putsUart0(str);
+    putfUart0("Event %d Completed. Reseeding...\n", EVENT_TO_RUN);
     setAlarm();
-    snprintf(str, sizeof(str), "Event %d Scheduled\n", EVENT_TO_RUN);
-    putsUart0(str);
+    putfUart0("Event %d Scheduled\n", EVENT_TO_RUN);
 
     TIMER2_ICR_R = TIMER_ICR_TATOCINT;              // Clear Flag
 }
 
 void hib0Isr() {
+    // alarm matches at subsecond 0, one 32.768 kHz tick is 1220 system clocks
+    recordLatency(LATENCY_FEED_START, (HIB_RTCSS_R & HIB_RTCSS_RTCSSC_M) * (40000000 / 32768));
 
     uint32_t pwm_raw = readEeprom( EVENT_TO_RUN * 16 + 2);
 
     uint32_t dur = readEeprom( EVENT_TO_RUN * 16 + 1) * 40000000;       // Turn secs into ticks. Valid Load
-    uint32_t pwm = (((float)pwm_raw)/100) * 1023;                       // Duty cycle
+    if(pwm_raw > 100) { pwm_raw = 100; }                                // stored before feed checked it
+    uint32_t pwm = pwm_raw * 100;                                       // Duty cycle, percent to parts per 10000
 
-    PWM0_3_CMPB_R = pwm;
+    setMotorSpeed(MOTOR_FOOD, pwm, RAMP_S_CURVE, FOOD_RAMP_MS);   // Soft start
+    logEvent(LOG_FEED_START, EVENT_TO_RUN);
 
     // One shot timer
     TIMER2_TAILR_R = dur;                           // Load value
+    feedDeadline = TIMER5_TAV_R + dur;
     TIMER2_CTL_R |= TIMER_CTL_TAEN;                 // turn-on timer
 
     HIB_IC_R = HIB_IC_RTCALT0;                      // Clear intr flag
 }
 
-//-----------------------------------------------------------------------------
-// Main
-//-----------------------------------------------------------------------------
+// Writes the staged words that differ from the EEPROM and reseeds the alarm
+// once, all with the feeding ISRs masked like a single feed command
+void commitSettings() {
+    uint8_t i;
 
-int main(void)
-{
-    USER_DATA data;
+    if(batch.count == 0 && !batch.alarm) {
+        return;
+    }
+
+    uint32_t state = enterNvicCritical(PRIORITY_FEED);
+    for(i = 0; i < batch.count; i++) {
+        if(readEeprom(batch.address[i]) != batch.data[i]) {     // unchanged words cost no write
+            writeEeprom(batch.address[i], batch.data[i]);
+        }
+    }
+    if(batch.alarm) {
+        setAlarm();
+    }
+    leaveNvicCritical(state);
+
+    batch.count = 0;
+    batch.alarm = false;
+}
+
+// Stages an EEPROM word for commitSettings(), a later write to the address replaces it
+void stageSetting(uint16_t add, uint32_t data) {
+    uint8_t i = 0;
+
+    while(i < batch.count && batch.address[i] != add) {
+        i++;
+    }
+    if(i == BATCH_SIZE) {                                       // full, commit what is staged so far
+        commitSettings();
+        i = 0;
+    }
+    batch.address[i] = add;
+    batch.data[i] = data;
+    if(i == batch.count) {
+        batch.count++;
+    }
+}
+
+bool isLetter(char c) {
+    return (c>=65 && c<=90) || (c>=97 && c<=122);
+}
+
+// macro                    list the macros
+// macro NAME               print one
+// macro NAME delete        delete it
+// macro NAME CMD;CMD...    store the rest of the line as NAME
+bool macroCommand(char text[]) {
+    char name[MACRO_NAME_SIZE+1];
+    uint8_t count = 0;
+    uint8_t slot;
+    uint32_t state;
+    bool found;
+
+    text += 5;                                                  // past "macro"
+    while(*text == ' ') { text++; }
+    while(isLetter(*text) && count < MACRO_NAME_SIZE) {
+        name[count++] = *text++;
+    }
+    name[count] = 0;
+    if(*text != 0 && *text != ' ') {
+        putfUart0("Error: Macro names are 1 to %d letters\n", MACRO_NAME_SIZE);
+        return false;
+    }
+    while(*text == ' ') { text++; }
+
+    if(count == 0) {
+        for(slot = 0; slot < MACRO_COUNT; slot++) {
+            state = enterNvicCritical(PRIORITY_FEED);
+            found = readMacro(slot, macroName, macroBody);
+            leaveNvicCritical(state);
+            if(found) {
+                putfUart0("%s: %s\n", macroName, macroBody);
+            }
+        }
+        return true;
+    }
+
+    int8_t stored;
+    if(*text == 0) {
+        state = enterNvicCritical(PRIORITY_FEED);
+        stored = findMacro(name);
+        found = stored >= 0 && readMacro(stored, macroName, macroBody);
+        leaveNvicCritical(state);
+        if(!found) {
+            putfUart0("Error: No macro [%s]\n", name);
+            return false;
+        }
+        putfUart0("%s: %s\n", macroName, macroBody);
+    }
+    else if(strgcmp(text, "delete") && text[6] == 0) {
+        state = enterNvicCritical(PRIORITY_FEED);
+        stored = findMacro(name);
+        if(stored >= 0) {
+            deleteMacro(stored);
+        }
+        leaveNvicCritical(state);
+        if(stored < 0) {
+            putfUart0("Error: No macro [%s]\n", name);
+            return false;
+        }
+        putfUart0("MACRO --> [%s] deleted\n", name);
+    }
+    else {
+        state = enterNvicCritical(PRIORITY_FEED);
+        found = writeMacro(name, text);
+        leaveNvicCritical(state);
+        if(!found) {
+            putfUart0("Error: Up to %d macros of %d characters\n", MACRO_COUNT, MACRO_BODY_SIZE);
+            return false;
+        }
+        putfUart0("MACRO --> [%s]\n", name);
+    }
+    return true;
+}
+
+bool runCommandLine(char line[]);
+
+// Runs one command, false when it is invalid or fails
+bool executeCommand(USER_DATA *data) {
     uint32_t event_data[5];
+    uint32_t state;
+    bool valid = false;
 
-    // Initialize hardware
-    initHw();
-    initUart0();
-    initEeprom();
+    // Set time HH:MM command
+    if (isCommand(data, "time", 2)) {
+        uint32_t hrs = getFieldInteger(data, 1);
+        uint32_t mins = getFieldInteger(data, 2);
+        int now = checkRTCC();
 
-    // Setup UART0 baud rate
-    setUart0BaudRate(19200, 40e6);
+        if(now < 0) {
+            return false;
+        }
 
-    setAlarm();
+        uint32_t days_in_secs = (now / 86400) * 86400;      // keep the day, history counts days from 0
+        uint32_t hrs_in_secs  = hrs*3600;
+        uint32_t mins_in_secs = mins*60;
 
-    // Endless loop
-    while(1) {
+        commitSettings();                                   // the alarm sees the events staged before
+        state = enterNvicCritical(PRIORITY_FEED);           // also masks updateHistory()
 
-        bool valid = false;
+        // Close the history batch on the old clock, its samples are timed from
+        // the batch start. Setting the clock back still leaves earlier records
+        // stamped later, history replays them in the order they were stored
+        updateHistory();
+        flushHistory();
 
-        getsUart0(&data);
-        parseFields(&data);
+        while (~HIB_CTL_R & HIB_CTL_WRC);   // Poll WRC bit
 
-        // Set time HH:MM command
-        if (isCommand(&data, "time", 2)) {
-            uint32_t hrs = getFieldInteger(&data, 1);
-            uint32_t mins = getFieldInteger(&data, 2);
+        HIB_RTCLD_R = days_in_secs + hrs_in_secs + mins_in_secs;
 
-            uint32_t hrs_in_secs  = hrs*3600;
-            uint32_t mins_in_secs = mins*60;
+        setAlarm();
+        leaveNvicCritical(state);
 
-            while (~HIB_CTL_R & HIB_CTL_WRC);   // Poll WRC bit
+        valid = true;
+    }
 
-            HIB_RTCLD_R = hrs_in_secs + mins_in_secs;
+    // Check time command
+    if (isCommand(data, "time", 0)) {
+        commitSettings();                                   // the events printed include those staged before
 
-            setAlarm();
+        uint32_t secs = checkRTCC();
+        //snprintf(str, sizeof(str), "%d\n", secs);
+        //putsUart0(str);
 
-            valid = true;
+        uint32_t hrs = secs/3600;   // 3600 seconds = 1 hour
+        if(hrs % 24 > 0) {
+            hrs %= 24;
         }
+        secs %= 3600;               // Remainder is minutes in seconds
+        uint32_t mins = secs/60;    // 60 seconds = 1 minute
 
-        // Check time command
-        if (isCommand(&data, "time", 0)) {
+        putfUart0("TIME IS -> %02d:%02d\n", hrs , mins);
 
-            uint32_t secs = checkRTCC();
-            //snprintf(str, sizeof(str), "%d\n", secs);
-            //putsUart0(str);
+        printInfoEvents();
 
-            uint32_t hrs = secs/3600;   // 3600 seconds = 1 hour
-            if(hrs % 24 > 0) {
-                hrs %= 24;
-            }
-            secs %= 3600;               // Remainder is minutes in seconds
-            uint32_t mins = secs/60;    // 60 seconds = 1 minute
+        valid = true;
+    }
 
-            snprintf(str, sizeof(str), "TIME IS -> %02d:%02d\n", hrs , mins);
-            putsUart0(str);
+    // feed FEEDING DURATION PWM HH:MM
+    if (isCommand(data, "feed", 5)) {
+        event_data[0] = getFieldInteger(data, 1);  // Feeding Event
+        event_data[1] = getFieldInteger(data, 2);  // Duration
+        event_data[2] = getFieldInteger(data, 3);  // PWM Speed
+        event_data[3] = getFieldInteger(data, 4);  // Hour
+        event_data[4] = getFieldInteger(data, 5);  // Minute
+
+        if(event_data[0] > 9) {
+            putsUart0("Error: Up to 10 events can be stored. [0-9]\n");
+            return false;
+        }
+        if(event_data[2] > 100) {
+            putsUart0("Error: PWM is a duty cycle. [0-100]\n");
+            return false;
+        }
 
-            printInfoEvents();
+        uint32_t i;
+        for(i = 0; i < 5; i++) {
+            stageSetting((event_data[0] * 16 + i), event_data[i]);
+        }
+        batch.alarm = true;
+
+        valid = true;
+    }
 
-            valid = true;
+    // feeding FEED delete
+    if(isCommand(data, "feed", 2) && (strgcmp(getFieldString(data, 2), "delete"))) {
+        uint32_t event = getFieldInteger(data, 1);
+
+        if(event > 9) {
+            putsUart0("Error: Up to 10 events can be stored. [0-9]\n");
+            return false;
         }
 
-        // feed FEEDING DURATION PWM HH:MM
-        if (isCommand(&data, "feed", 5)) {
-            event_data[0] = getFieldInteger(&data, 1);  // Feeding Event
-            event_data[1] = getFieldInteger(&data, 2);  // Duration
-            event_data[2] = getFieldInteger(&data, 3);  // PWM Speed
-            event_data[3] = getFieldInteger(&data, 4);  // Hour
-            event_data[4] = getFieldInteger(&data, 5);  // Minute
+        uint32_t i;
+        for(i = 0; i < 5; i++) {
+            stageSetting((event * 16 + i), 0xFFFFFFFF);
+        }
+        batch.alarm = true;
 
-            if(event_data[0] > 9) {
-                putsUart0("Error: Up to 10 events can be stored. [0-9]\n");
-                continue;
-            }
+        valid = true;
+    }
 
-            uint32_t i;
-            for(i = 0; i < 5; i++) {
-                writeEeprom((event_data[0] * 16 + i), event_data[i]);
-            }
+    // water VOLUME
+    if(isCommand(data, "water", 1)) {
+        uint32_t desired_level = getFieldInteger(data, 1);
 
-            setAlarm();
+        stageSetting((VOLUME_LEVEL * 16), desired_level);
+        desiredLevel = desired_level;
 
-            valid = true;
-        }
+        valid = true;
+    }
 
-        // feeding FEED delete
-        if(isCommand(&data, "feed", 2) && (strgcmp(getFieldString(&data, 2), "delete"))) {
-            uint32_t event = getFieldInteger(&data, 1);
+    // fill auto/motion
+    if(isCommand(data, "fill", 1)) {
+        char *str1 = getFieldString(data, 1);
 
-            uint32_t i;
-            for(i = 0; i < 5; i++) {
-                writeEeprom((event * 16 + i), 0xFFFFFFFF);
-            }
+        // auto = 1
+        // motion = 0
+        if(strgcmp(str1, "auto")) {
+            stageSetting((FILL_MODE * 16), 1);
+            autoMode = 1;
+            putfUart0("MODE --> [%s]\n", str1);
+        }
+        else if(strgcmp(str1, "motion")) {
+            stageSetting((FILL_MODE * 16), 0);
+            autoMode = 0;
+            putfUart0("MODE --> [%s]\n", str1);
+        }
+        else {
+            putsUart0("Error: Invalid Argument for [fill]\n");
+            return false;
+        }
 
-            setAlarm();
+        valid = true;
+    }
 
-            valid = true;
+    // alert ON/OFF
+    if(isCommand(data, "alert", 1)) {
+        char *str1 = getFieldString(data, 1);
+
+        // ON = 1
+        // OFF = 0
+        if(strgcmp(str1, "ON")) {
+            putfUart0("ALERT --> [%s]\n", str1);
+            stageSetting((ALERT_ON_OFF * 16), 1);
+            alertOn = 1;
+        }
+        else if(strgcmp(str1, "OFF")) {
+            putfUart0("ALERT --> [%s]\n", str1);
+            stageSetting((ALERT_ON_OFF * 16), 0);
+            alertOn = 0;
+        }
+        else {
+            putsUart0("Error: Invalid Argument for [alert]\n");
+            return false;
         }
 
-        // water VOLUME
-        if(isCommand(&data, "water", 1)) {
-            uint32_t desired_level = getFieldInteger(&data, 1);
+        valid = true;
+    }
+
+    // log: stream the event log
+    if(isCommand(data, "log", 0)) {
+        printLog();
 
-            writeEeprom((VOLUME_LEVEL * 16), desired_level);
+        valid = true;
+    }
+
+    // history DAYS: replay the stored feedings and level changes
+    if(isCommand(data, "history", 1)) {
+        uint32_t days = getFieldInteger(data, 1);
+        int now = checkRTCC();
 
-            valid = true;
+        if(now < 0) {
+            return false;
         }
 
-        // fill auto/motion
-        if(isCommand(&data, "fill", 1)) {
-            char *str1 = getFieldString(&data, 1);
+        uint32_t since = (days * 86400 < (uint32_t)now) ? now - days * 86400 : 0;
 
-            // auto = 1
-            // motion = 0
-            if(strgcmp(str1, "auto")) {
-                writeEeprom((FILL_MODE * 16), 1);
-                snprintf(str, sizeof(str), "MODE --> [%s]\n", str1);
-                putsUart0(str);
-            }
-            else if(strgcmp(str1, "motion")) {
-                writeEeprom((FILL_MODE * 16), 0);
-                snprintf(str, sizeof(str), "MODE --> [%s]\n", str1);
-                putsUart0(str);
-            }
-            else {
-                putsUart0("Error: Invalid Argument for [fill]\n");
-                continue;
+        replayHistory(since, printHistoryRecord);
+
+        valid = true;
+    }
+
+    // telemetry on [PERIOD_MS] / telemetry off
+    if(isCommand(data, "telemetry", 1) || isCommand(data, "telemetry", 2)) {
+        char *str1 = getFieldString(data, 1);
+
+        if(strgcmp(str1, "on")) {
+            uint32_t period = 100;
+            if(data->fieldCount > 2) {
+                period = getFieldInteger(data, 2);
             }
+            if(period > LEVEL_PERIOD_MS) { period = LEVEL_PERIOD_MS; }
+            period = getLevelPeriod(period, TELEMETRY_MIN_PERIOD_MS(uartBaud));
+            setLevelPeriod(period);
+            telemetryOn = true;
+        }
+        else if(strgcmp(str1, "off")) {
+            telemetryOn = false;
+            setLevelPeriod(LEVEL_PERIOD_MS);
+        }
+        else {
+            putsUart0("Error: Invalid Argument for [telemetry]\n");
+            return false;
+        }
+
+        valid = true;
+    }
 
-            valid = true;
+    // latency: print worst-case interrupt latencies and start a new measurement
+    if(isCommand(data, "latency", 0)) {
+        const char *names[LATENCY_COUNT] = {"level", "feed start", "feed stop", "water stop"};
+        uint32_t i;
+        for(i = 0; i < LATENCY_COUNT; i++) {
+            putfUart0("%s: %d cycles (%.1q us)\n", names[i], maxLatency[i], maxLatency[i] / 4);
+            maxLatency[i] = 0;
         }
 
-        // alert ON/OFF
-        if(isCommand(&data, "alert", 1)) {
-            char *str1 = getFieldString(&data, 1);
+        valid = true;
+    }
 
-            // ON = 1
-            // OFF = 0
-            if(strgcmp(str1, "ON")) {
-                snprintf(str, sizeof(str), "ALERT --> [%s]\n", str1);
-                putsUart0(str);
-                writeEeprom((ALERT_ON_OFF * 16), 1);
+    // baud RATE / baud auto: the reply comes at the new rate
+    if(isCommand(data, "baud", 1)) {
+        char *str1 = getFieldString(data, 1);
+        uint32_t rate;
+
+        if(strgcmp(str1, "auto")) {
+            putsUart0("Send U at the new rate\n");
+            rate = detectUart0BaudRate(40e6, BAUD_SYNC_TIMEOUT_MS);
+            if(rate == 0) {
+                putsUart0("Error: No sync character\n");
+                return false;
             }
-            else if(strgcmp(str1, "OFF")) {
-                snprintf(str, sizeof(str), "ALERT --> [%s]\n", str1);
-                putsUart0(str);
-                writeEeprom((ALERT_ON_OFF * 16), 0);
-            }
-            else {
-                putsUart0("Error: Invalid Argument for [alert]\n");
-                continue;
+        }
+        else {
+            rate = getFieldInteger(data, 1);
+        }
+
+        int32_t error = getUart0BaudError(rate, 40e6);
+        if(!setUart0BaudRate(rate, 40e6)) {
+            putfUart0("Error: %u baud cannot be set\n", rate);
+            return false;
+        }
+        uartBaud = rate;
+        putfUart0("BAUD --> [%u] (%.2q%% error)\n", rate, error / 100);
+
+        if(telemetryOn) {                               // a slower rate may not fit a packet per period
+            uint32_t period = LEVEL_PERIOD_MS / samplesPerControl;
+            uint32_t fitted = getLevelPeriod(period, TELEMETRY_MIN_PERIOD_MS(rate));
+            if(fitted != period) {
+                setLevelPeriod(fitted);
+                putfUart0("TELEMETRY --> [%u ms]\n", fitted);
             }
+        }
+
+        valid = true;
+    }
+
+    // run NAME: the macro's commands join the batch of this line
+    if(isCommand(data, "run", 1)) {
+        char *name = getFieldString(data, 1);
+
+        if(runningMacro) {
+            putsUart0("Error: [run] inside a macro\n");
+            return false;
+        }
+        state = enterNvicCritical(PRIORITY_FEED);
+        int8_t slot = findMacro(name);
+        bool found = slot >= 0 && readMacro(slot, macroName, macroBody);
+        leaveNvicCritical(state);
+        if(!found) {
+            putfUart0("Error: No macro [%s]\n", name);
+            return false;
+        }
 
-            valid = true;
+        runningMacro = true;
+        bool done = runCommandLine(macroBody);
+        runningMacro = false;
+        if(!done) {
+            return false;
         }
 
+        valid = true;
+    }
+
+    if (!valid) {
+        putsUart0("Invalid command\n");
+    }
+
+    return valid;
+}
+
+// Runs the ;-separated commands of a line in order and stops at the first
+// one that fails. Settings are staged, main commits them after the line, so
+// a line of feed commands costs one EEPROM pass and one alarm update.
+bool runCommandLine(char line[]) {
+    USER_DATA data;
+
+    while(*line != 0) {
+        while(*line == ' ') { line++; }
+
+        if(strgcmp(line, "macro") && (line[5] == ' ' || line[5] == 0)) {  // takes the rest of the line
+            if(runningMacro) {
+                putsUart0("Error: [macro] inside a macro\n");
+                return false;
+            }
+            return macroCommand(line);
+        }
 
-        if (!valid) {
-            putsUart0("Invalid command\n");
+        if(!getCommand(&line, &data)) {
+            putfUart0("Error: Commands are up to %d characters\n", MAX_CHARS);
+            return false;
         }
+        parseFields(&data);
+        if(data.fieldCount == 0) {                              // empty, as in "water 300;;"
+            continue;
+        }
+        if(!executeCommand(&data)) {
+            if(*line != 0) {
+                putfUart0("Skipped: %s\n", line);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+
+    // Initialize hardware
+    initHw();
+    initUart0();
+    initEeprom();
+    loadSettings();
+    initHistory();
+
+    // Setup UART0 baud rate
+    setUart0BaudRate(uartBaud, 40e6);
+    enableUart0TxInterrupt();
+
+    setAlarm();
+
+    // Motion sensor interrupts on both edges, debounced by Timer 5
+    initGpioIrq();
+    attachPinInterrupt(PORTF, 4, motionIsr, 20000);     // 20 ms debounce
+
+    // Endless loop
+    while(1) {
+        getsUart0Line(commandLine, COMMAND_LINE_SIZE);
+        runCommandLine(commandLine);
+        commitSettings();
     }
 }
@@ -0,0 +1,38 @@
+; Atomic Library
+
+;-----------------------------------------------------------------------------
+; Hardware Target
+;-----------------------------------------------------------------------------
+
+; Target Platform: EK-TM4C123GXL
+; Target uC:       TM4C123GH6PM
+; System Clock:    -
+
+; Hardware configuration: -
+
+; Exception entry and return clear the exclusive monitor, so a STREX fails
+; when an ISR ran between the LDREX and the STREX, and the loop retries
+
+;-----------------------------------------------------------------------------
+; Device includes, defines, and assembler directives
+;-----------------------------------------------------------------------------
+
+   .def atomicFetchAdd
+
+;-----------------------------------------------------------------------------
+; Subroutines
+;-----------------------------------------------------------------------------
+
+.thumb
+.text
+
+; uint32_t atomicFetchAdd(volatile uint32_t *p, uint32_t value)
+; Adds value to *p and returns the old value
+atomicFetchAdd:
+AFA_RETRY:   LDREX R2, [R0]
+             ADD   R3, R2, R1
+             STREX R12, R3, [R0]
+             CMP   R12, #0
+             BNE   AFA_RETRY
+             MOV   R0, R2
+             BX    LR
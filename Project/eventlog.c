@@ -0,0 +1,80 @@
+// Event Log Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Hibernation module RTC running from the 32.768 kHz oscillator
+
+// Writers claim a slot with an atomic increment of the head index, so any
+// ISR or main can log without masking interrupts. A claimed record is only
+// readable once its writer stores the commit word, written last, so a reader
+// that preempts the writer between the claim and the stores sees the record
+// as pending rather than reading it half written. The oldest records are
+// overwritten when the buffer is full. The reader copies a record and then
+// checks the commit word again, to know it was not overwritten meanwhile.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "eventlog.h"
+#include "atomic.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static volatile LOG_RECORD logRecords[LOG_SIZE];
+static volatile uint32_t logCommit[LOG_SIZE];       // index + 1 of the record in the slot, once written
+static volatile uint32_t logHead = 0;               // records ever claimed
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Appends a record stamped with the RTC time
+void logEvent(LOG_TYPE type, uint16_t payload)
+{
+    uint32_t index = atomicFetchAdd(&logHead, 1);
+    volatile LOG_RECORD *r = &logRecords[index & (LOG_SIZE - 1)];
+    uint32_t seconds, subseconds;
+    logCommit[index & (LOG_SIZE - 1)] = 0;          // the slot's previous record is gone
+    do
+    {
+        seconds = HIB_RTCC_R;
+        subseconds = HIB_RTCSS_R & HIB_RTCSS_RTCSSC_M;
+    } while (seconds != HIB_RTCC_R);                // seconds rolled over during the read
+    r->seconds = seconds;
+    r->stamp = (type << 12) | (subseconds >> 3);
+    r->payload = payload;
+    logCommit[index & (LOG_SIZE - 1)] = index + 1;
+}
+
+// Index of the next record to be claimed, records head - LOG_SIZE to head - 1 are available
+uint32_t getLogHead(void)
+{
+    return logHead;
+}
+
+// Copies a record, LOG_READ_PENDING while its writer has not finished it
+LOG_READ readLogRecord(uint32_t index, LOG_RECORD *record)
+{
+    volatile LOG_RECORD *r = &logRecords[index & (LOG_SIZE - 1)];
+    volatile uint32_t *commit = &logCommit[index & (LOG_SIZE - 1)];
+
+    if (*commit != index + 1)
+        return logHead - index > LOG_SIZE ? LOG_READ_LOST : LOG_READ_PENDING;
+    record->seconds = r->seconds;
+    record->stamp = r->stamp;
+    record->payload = r->payload;
+    return *commit == index + 1 ? LOG_READ_OK : LOG_READ_LOST;
+}
@@ -0,0 +1,66 @@
+// Event Log Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Hibernation module RTC running from the 32.768 kHz oscillator
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef EVENTLOG_H_
+#define EVENTLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LOG_SIZE 256                                // records, power of 2
+
+typedef enum _LOG_TYPE
+{
+    LOG_FEED_START,                                 // payload: event number
+    LOG_FEED_STOP,                                  // payload: event number
+    LOG_PUMP_ON,                                    // payload: seconds
+    LOG_PUMP_OFF,
+    LOG_LEVEL,                                      // payload: mL
+    LOG_MOTION,                                     // payload: sensor value
+    LOG_ERROR                                       // payload: LOG_ERROR_x code
+} LOG_TYPE;
+
+#define LOG_ERROR_RTC_READ 1
+
+// 8-byte record, stamp holds the type in bits 15-12 and the RTC subseconds / 8
+// in bits 11-0 (1/4096 s)
+typedef struct _LOG_RECORD
+{
+    uint32_t seconds;
+    uint16_t stamp;
+    uint16_t payload;
+} LOG_RECORD;
+
+typedef enum _LOG_READ
+{
+    LOG_READ_OK,
+    LOG_READ_PENDING,                               // claimed, its writer was preempted before finishing it
+    LOG_READ_LOST                                   // overwritten by newer records
+} LOG_READ;
+
+#define LOG_RECORD_TYPE(r) ((r)->stamp >> 12)
+#define LOG_RECORD_SUBSECONDS(r) (((r)->stamp & 0xFFF) << 3)
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void logEvent(LOG_TYPE type, uint16_t payload);
+uint32_t getLogHead(void);
+LOG_READ readLogRecord(uint32_t index, LOG_RECORD *record);
+
+#endif
@@ -0,0 +1,187 @@
+// Formatted Output Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include "format.h"
+#include "uart0.h"
+
+// Where the characters go, UART0 or a buffer of size bytes
+typedef struct _FORMAT_OUTPUT
+{
+    bool uart;
+    char *buffer;
+    uint32_t size;
+    uint32_t length;                                // characters produced, stored or not
+} FORMAT_OUTPUT;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void emit(FORMAT_OUTPUT *out, char c)
+{
+    if (out->uart)
+        putcUart0(c);
+    else if (out->length + 1 < out->size)
+        out->buffer[out->length] = c;
+    out->length++;
+}
+
+static void emitRepeated(FORMAT_OUTPUT *out, char c, int32_t count)
+{
+    while (count-- > 0)
+        emit(out, c);
+}
+
+// Writes sign, then value in base with at least decimals digits after a
+// decimal point, padded to width
+static void emitNumber(FORMAT_OUTPUT *out, uint32_t value, bool negative, uint32_t base,
+                       uint32_t decimals, int32_t width, bool zeroPad, bool left)
+{
+    char digits[FORMAT_MAX_DECIMALS + 1];
+    int32_t count = 0;
+    int32_t length;
+
+    do
+    {
+        digits[count++] = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value != 0 || count <= (int32_t)decimals);     // 0.05 needs its leading zero
+
+    length = count + (decimals ? 1 : 0) + (negative ? 1 : 0);
+    if (!left && !zeroPad)
+        emitRepeated(out, ' ', width - length);
+    if (negative)
+        emit(out, '-');
+    if (!left && zeroPad)
+        emitRepeated(out, '0', width - length);
+    while (count--)
+    {
+        if (decimals && count == (int32_t)decimals - 1)
+            emit(out, '.');
+        emit(out, digits[count]);
+    }
+    if (left)
+        emitRepeated(out, ' ', width - length);
+}
+
+static void formatOutput(FORMAT_OUTPUT *out, const char *format, va_list args)
+{
+    while (*format != 0)
+    {
+        bool zeroPad = false, left = false;
+        int32_t width = 0;
+        uint32_t precision = 0;
+        int32_t number;
+        const char *text;
+
+        if (*format != '%')
+        {
+            emit(out, *format++);
+            continue;
+        }
+        format++;
+
+        for (; *format == '0' || *format == '-'; format++)
+        {
+            if (*format == '0')
+                zeroPad = true;
+            else
+                left = true;
+        }
+        for (; *format >= '0' && *format <= '9'; format++)
+            width = width * 10 + (*format - '0');
+        if (*format == '.')
+            for (format++; *format >= '0' && *format <= '9'; format++)
+                precision = precision * 10 + (*format - '0');
+        if (*format == 'l')
+            format++;
+
+        switch (*format)
+        {
+        case 'd':
+        case 'q':
+            if (precision > FORMAT_MAX_DECIMALS)
+                precision = FORMAT_MAX_DECIMALS;
+            number = va_arg(args, int32_t);
+            emitNumber(out, number < 0 ? 0 - (uint32_t)number : (uint32_t)number, number < 0, 10,
+                       *format == 'q' ? precision : 0, width, zeroPad, left);
+            break;
+        case 'u':
+            emitNumber(out, va_arg(args, uint32_t), false, 10, 0, width, zeroPad, left);
+            break;
+        case 'x':
+            emitNumber(out, va_arg(args, uint32_t), false, 16, 0, width, zeroPad, left);
+            break;
+        case 'c':
+            emitRepeated(out, ' ', left ? 0 : width - 1);
+            emit(out, (char)va_arg(args, int));
+            emitRepeated(out, ' ', left ? width - 1 : 0);
+            break;
+        case 's':
+            text = va_arg(args, const char *);
+            for (number = 0; text[number] != 0; number++);
+            emitRepeated(out, ' ', left ? 0 : width - number);
+            while (*text != 0)
+                emit(out, *text++);
+            emitRepeated(out, ' ', left ? width - number : 0);
+            break;
+        case '%':
+            emit(out, '%');
+            break;
+        case 0:
+            return;
+        default:                                    // unsupported conversion, shown as is
+            emit(out, '%');
+            emit(out, *format);
+            break;
+        }
+        format++;
+    }
+}
+
+// Formats into buffer, always terminated when size > 0, and returns the length
+// the whole text needs (not counting the terminator), like snprintf()
+uint32_t formatStringList(char buffer[], uint32_t size, const char format[], va_list args)
+{
+    FORMAT_OUTPUT out = {false, buffer, size, 0};
+    formatOutput(&out, format, args);
+    if (size > 0)
+        buffer[out.length < size ? out.length : size - 1] = 0;
+    return out.length;
+}
+
+uint32_t formatString(char buffer[], uint32_t size, const char format[], ...)
+{
+    uint32_t length;
+    va_list args;
+    va_start(args, format);
+    length = formatStringList(buffer, size, format, args);
+    va_end(args);
+    return length;
+}
+
+// Formats straight into the UART0 transmit path
+void putfUart0(const char format[], ...)
+{
+    FORMAT_OUTPUT out = {true, 0, 0, 0};
+    va_list args;
+    va_start(args, format);
+    formatOutput(&out, format, args);
+    va_end(args);
+}
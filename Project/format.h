@@ -0,0 +1,41 @@
+// Formatted Output Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+// A printf subset for the status lines, without the C library's formatter:
+//   %d %u %x %c %s %%     32-bit arguments, the l modifier is accepted
+//   %5d %05d %-8s         width, zero padding and left justification
+//   %.Nq                  fixed point, an int32_t counting 10^-N units
+//                         (%.1q of 1234 is 123.4), N above 10 prints 10
+// Conversions are written as they are made, so there is no shared buffer and
+// formatString() can be called from main and the ISRs at the same time
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#define FORMAT_MAX_DECIMALS 10                      // an int32_t has at most 10 digits
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint32_t formatString(char buffer[], uint32_t size, const char format[], ...);
+uint32_t formatStringList(char buffer[], uint32_t size, const char format[], va_list args);
+void putfUart0(const char format[], ...);
+
+#endif
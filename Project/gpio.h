@@ -0,0 +1,126 @@
+// GPIO Library
+// Jason Losh
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// GPIO APB and AHB ports A-F
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Enum values set to bitband address of bit 0 of the GPIO_PORTx_DATA_R register
+// PORTx uses the APB aperture, PORTx_AHB the AHB aperture of the same port
+// enablePort() selects the aperture, so use one of the two names consistently for a port
+typedef enum _PORT
+{
+    PORTA = 0x42000000 + (0x400043FC-0x40000000)*32,
+    PORTB = 0x42000000 + (0x400053FC-0x40000000)*32,
+    PORTC = 0x42000000 + (0x400063FC-0x40000000)*32,
+    PORTD = 0x42000000 + (0x400073FC-0x40000000)*32,
+    PORTE = 0x42000000 + (0x400243FC-0x40000000)*32,
+    PORTF = 0x42000000 + (0x400253FC-0x40000000)*32,
+    PORTA_AHB = 0x42000000 + (0x400583FC-0x40000000)*32,
+    PORTB_AHB = 0x42000000 + (0x400593FC-0x40000000)*32,
+    PORTC_AHB = 0x42000000 + (0x4005A3FC-0x40000000)*32,
+    PORTD_AHB = 0x42000000 + (0x4005B3FC-0x40000000)*32,
+    PORTE_AHB = 0x42000000 + (0x4005C3FC-0x40000000)*32,
+    PORTF_AHB = 0x42000000 + (0x4005D3FC-0x40000000)*32
+} PORT;
+
+// Pin attributes used in a pin configuration table
+typedef enum _PIN_MODE
+{
+    PIN_PUSH_PULL_OUTPUT,
+    PIN_OPEN_DRAIN_OUTPUT,
+    PIN_DIGITAL_INPUT,
+    PIN_ANALOG_INPUT
+} PIN_MODE;
+
+#define PIN_PULL_NONE 0
+#define PIN_PULLUP    1
+#define PIN_PULLDOWN  2
+
+// One entry of a board pin table
+// mask selects any set of pins on the port, fn holds header-shifted PCTL values (0 = GPIO)
+typedef struct _PIN_CONFIG
+{
+    PORT port;
+    uint8_t mask;
+    uint8_t mode;
+    uint8_t pull;
+    uint32_t fn;
+} PIN_CONFIG;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void enablePort(PORT port);
+void disablePort(PORT port);
+uint8_t getPortIndex(PORT port);
+
+void selectPinPushPullOutput(PORT port, uint8_t pin);
+void selectPinOpenDrainOutput(PORT port, uint8_t pin);
+void selectPinDigitalInput(PORT port, uint8_t pin);
+void selectPinAnalogInput(PORT port, uint8_t pin);
+void setPinCommitControl(PORT port, uint8_t pin);
+
+void enablePinPullup(PORT port, uint8_t pin);
+void disablePinPullup(PORT port, uint8_t pin);
+void enablePinPulldown(PORT port, uint8_t pin);
+void disablePinPulldown(PORT port, uint8_t pin);
+
+void setPinAuxFunction(PORT port, uint8_t pin, uint32_t fn);
+
+void selectPinInterruptRisingEdge(PORT port, uint8_t pin);
+void selectPinInterruptFallingEdge(PORT port, uint8_t pin);
+void selectPinInterruptBothEdges(PORT port, uint8_t pin);
+void selectPinInterruptHighLevel(PORT port, uint8_t pin);
+void selectPinInterruptLowLevel(PORT port, uint8_t pin);
+void enablePinInterrupt(PORT port, uint8_t pin);
+void disablePinInterrupt(PORT port, uint8_t pin);
+void clearPinInterrupt(PORT port, uint8_t pin);
+
+void setPinValue(PORT port, uint8_t pin, bool value);
+void togglePinValue(PORT port, uint8_t pin);
+bool getPinValue(PORT port, uint8_t pin);
+void setPortValue(PORT port, uint8_t value);
+uint8_t getPortValue(PORT port);
+void setPortValueMasked(PORT port, uint8_t mask, uint8_t value);
+uint8_t getPortValueMasked(PORT port, uint8_t mask);
+
+void selectPortPushPullOutput(PORT port, uint8_t mask);
+void selectPortOpenDrainOutput(PORT port, uint8_t mask);
+void selectPortDigitalInput(PORT port, uint8_t mask);
+void selectPortAnalogInput(PORT port, uint8_t mask);
+void setPortCommitControl(PORT port, uint8_t mask);
+
+void enablePortPullup(PORT port, uint8_t mask);
+void disablePortPullup(PORT port, uint8_t mask);
+void enablePortPulldown(PORT port, uint8_t mask);
+void disablePortPulldown(PORT port, uint8_t mask);
+
+void setPortAuxFunction(PORT port, uint8_t mask, uint32_t fn);
+
+void enablePortInterrupt(PORT port, uint8_t mask);
+void disablePortInterrupt(PORT port, uint8_t mask);
+void clearPortInterrupt(PORT port, uint8_t mask);
+uint8_t getPortInterruptStatus(PORT port);
+
+void applyPinConfig(const PIN_CONFIG config[], uint8_t count);
+
+#endif
@@ -0,0 +1,348 @@
+// History Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Flash 0x38000-0x3FFFF (32 pages) reserved for history in tm4c123gh6pm.cmd
+
+// updateHistory() drains the event log into a RAM batch of tokens:
+//   0x00-0x7F  1-128 samples with the level unchanged
+//   0x80-0xBF  one sample, level changed by -32..31 units of 10 mL
+//   0xF0       seconds(4) level(2): first sample of a batch
+//   0xF1       level(2): one sample
+//   0xF2/0xF3  seconds(4) event(1): feed start/stop
+//   0xF4       seconds(4) duration(1): pump on
+// Samples are 10 s apart, so a steady level costs a byte per 21 minutes.
+// A batch is programmed hourly or when full, as a length word and the tokens.
+// Pages start with a sequence number. When a batch does not fit, the next
+// (oldest) page is erased, so each page is erased once per pass of the ring.
+// updateHistory() and flushHistory() must not preempt each other, call them from
+// one priority level or with that level masked.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "history.h"
+#include "eventlog.h"
+#include "flash.h"
+
+#define HISTORY_BASE    0x38000
+#define HISTORY_PAGES   32
+#define HISTORY_BATCH   252                         // bytes of tokens per batch
+#define MAX_TOKEN       7
+#define BATCH_SAMPLES   360                         // flush at least every hour
+#define SAMPLE_SECONDS  10
+#define LEVEL_UNIT      10                          // mL
+
+#define TOKEN_RUN           0x00
+#define TOKEN_DELTA         0x80
+#define TOKEN_START         0xF0
+#define TOKEN_LEVEL         0xF1
+#define TOKEN_FEED_START    0xF2
+#define TOKEN_FEED_STOP     0xF3
+#define TOKEN_PUMP_ON       0xF4
+
+#define ERASED 0xFFFFFFFF
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static uint8_t batch[HISTORY_BATCH];
+static uint16_t batchLength = 0;
+static uint16_t batchSamples = 0;
+static uint16_t lastLevel = 0;                      // level units
+static uint8_t run = 0;
+
+static uint8_t page = 0;
+static uint32_t pageSequence = 0;
+static uint32_t writeAddress = 0;
+static uint32_t logIndex = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static uint32_t getPageAddress(uint8_t n)
+{
+    return HISTORY_BASE + n * FLASH_PAGE_SIZE;
+}
+
+static uint32_t readWord(uint32_t address)
+{
+    return *((const uint32_t *)address);
+}
+
+static void put8(uint8_t value)
+{
+    batch[batchLength++] = value;
+}
+
+static void put16(uint16_t value)
+{
+    put8(value);
+    put8(value >> 8);
+}
+
+static void put32(uint32_t value)
+{
+    put16(value);
+    put16(value >> 16);
+}
+
+static uint16_t get16(const uint8_t data[])
+{
+    return data[0] | (data[1] << 8);
+}
+
+static uint32_t get32(const uint8_t data[])
+{
+    return get16(data) | ((uint32_t)get16(data + 2) << 16);
+}
+
+static void putRun(void)
+{
+    if (run)
+    {
+        put8(TOKEN_RUN + run - 1);
+        run = 0;
+    }
+}
+
+// Erases the oldest page and makes it the current one
+static void startPage(void)
+{
+    page = (page + 1) % HISTORY_PAGES;
+    pageSequence++;
+    eraseFlashPage(getPageAddress(page));
+    writeFlashWord(getPageAddress(page), pageSequence);
+    writeAddress = getPageAddress(page) + 4;
+}
+
+static void addSample(uint32_t seconds, uint16_t level)
+{
+    uint16_t units = level / LEVEL_UNIT;
+    int32_t delta = (int32_t)units - lastLevel;
+    if (batchLength > HISTORY_BATCH - MAX_TOKEN)
+        flushHistory();
+    if (batchSamples == 0)
+    {
+        put8(TOKEN_START);
+        put32(seconds);
+        put16(units);
+    }
+    else if (delta == 0)
+    {
+        if (++run == 128)
+            putRun();
+    }
+    else
+    {
+        putRun();
+        if (delta >= -32 && delta <= 31)
+            put8(TOKEN_DELTA + delta + 32);
+        else
+        {
+            put8(TOKEN_LEVEL);
+            put16(units);
+        }
+    }
+    lastLevel = units;
+    batchSamples++;
+}
+
+static void addRecord(uint8_t token, uint32_t seconds, uint8_t value)
+{
+    if (batchLength > HISTORY_BATCH - MAX_TOKEN)
+        flushHistory();
+    putRun();
+    put8(token);
+    put32(seconds);
+    put8(value);
+}
+
+// Finds the newest page and the end of its data
+void initHistory(void)
+{
+    bool found = false;
+    uint32_t address, end, length;
+    uint8_t n;
+    for (n = 0; n < HISTORY_PAGES; n++)
+    {
+        uint32_t sequence = readWord(getPageAddress(n));
+        if (sequence != ERASED && (!found || sequence > pageSequence))
+        {
+            found = true;
+            page = n;
+            pageSequence = sequence;
+        }
+    }
+    if (!found)
+    {
+        page = HISTORY_PAGES - 1;                   // first batch starts page 0 with sequence 0
+        pageSequence = ERASED;
+        writeAddress = getPageAddress(HISTORY_PAGES);
+    }
+    else
+    {
+        address = getPageAddress(page) + 4;
+        end = getPageAddress(page) + FLASH_PAGE_SIZE;
+        while (address < end && (length = readWord(address)) != ERASED)
+        {
+            if (length > HISTORY_BATCH)             // damaged, leave the rest of the page alone
+            {
+                address = end;
+                break;
+            }
+            address += 4 + ((length + 3) & ~3);
+        }
+        writeAddress = address;
+    }
+    logIndex = getLogHead();
+}
+
+// Appends the level samples and feeding records logged since the last call
+void updateHistory(void)
+{
+    uint32_t head = getLogHead();
+    LOG_RECORD record;
+    LOG_READ status;
+    if (head - logIndex > LOG_SIZE)                 // records lost to the log wrapping
+        logIndex = head - LOG_SIZE;
+    for (; logIndex != head; logIndex++)
+    {
+        status = readLogRecord(logIndex, &record);
+        if (status == LOG_READ_PENDING)             // the writer this call preempted, taken next call
+            break;
+        if (status == LOG_READ_LOST)
+            continue;
+        switch (LOG_RECORD_TYPE(&record))
+        {
+            case LOG_LEVEL:
+                addSample(record.seconds, record.payload);
+                break;
+            case LOG_FEED_START:
+                addRecord(TOKEN_FEED_START, record.seconds, record.payload);
+                break;
+            case LOG_FEED_STOP:
+                addRecord(TOKEN_FEED_STOP, record.seconds, record.payload);
+                break;
+            case LOG_PUMP_ON:
+                addRecord(TOKEN_PUMP_ON, record.seconds, record.payload);
+                break;
+        }
+    }
+    if (batchSamples >= BATCH_SAMPLES)
+        flushHistory();
+}
+
+// Programs the RAM batch into flash
+void flushHistory(void)
+{
+    uint32_t words, i;
+    putRun();
+    if (batchLength == 0)
+        return;
+    words = (batchLength + 3) / 4;
+    while (batchLength & 3)                         // pad the last word
+        batch[batchLength++] = 0xFF;
+    if (writeAddress + 4 + words * 4 > getPageAddress(page) + FLASH_PAGE_SIZE)
+        startPage();
+    writeFlashWord(writeAddress, batchLength);
+    for (i = 0; i < words; i++)
+        writeFlashWord(writeAddress + 4 + i * 4, get32(&batch[i * 4]));
+    writeAddress += 4 + words * 4;
+    batchLength = 0;
+    batchSamples = 0;
+}
+
+// Decodes one batch, level changes are tracked across batches in *units
+static void replayBatch(const uint8_t data[], uint16_t length, uint32_t since, HISTORY_CALLBACK callback, uint16_t *units)
+{
+    uint32_t time = 0;
+    uint32_t seconds;
+    uint16_t value = *units;
+    uint16_t i = 0;
+    uint8_t token;
+    while (i < length)
+    {
+        token = data[i++];
+        if (token < TOKEN_DELTA)
+        {
+            time += (token - TOKEN_RUN + 1) * SAMPLE_SECONDS;
+            continue;
+        }
+        if (token < TOKEN_START)
+        {
+            time += SAMPLE_SECONDS;
+            value += (token - TOKEN_DELTA) - 32;
+        }
+        else if (token == TOKEN_START)
+        {
+            time = get32(&data[i]);
+            value = get16(&data[i + 4]);
+            i += 6;
+        }
+        else if (token == TOKEN_LEVEL)
+        {
+            time += SAMPLE_SECONDS;
+            value = get16(&data[i]);
+            i += 2;
+        }
+        else if (token >= TOKEN_FEED_START && token <= TOKEN_PUMP_ON)
+        {
+            seconds = get32(&data[i]);
+            if (seconds >= since)
+                callback((HISTORY_TYPE)(HISTORY_FEED_START + token - TOKEN_FEED_START), seconds, data[i + 4]);
+            i += 5;
+            continue;
+        }
+        else                                        // padding
+            break;
+        if (value != *units && time >= since)
+            callback(HISTORY_LEVEL, time, value * LEVEL_UNIT);
+        *units = value;
+    }
+}
+
+// Calls callback for the history since the given RTC time, oldest page first,
+// then for the batch not yet programmed
+void replayHistory(uint32_t since, HISTORY_CALLBACK callback)
+{
+    static uint8_t copy[HISTORY_BATCH];
+    uint16_t units = 0xFFFF;
+    uint16_t copyLength;
+    uint32_t address, end, length;
+    uint32_t state;
+    uint16_t i;
+    uint8_t n;
+    for (i = 1; i <= HISTORY_PAGES; i++)
+    {
+        n = (page + i) % HISTORY_PAGES;
+        if (readWord(getPageAddress(n)) == ERASED)
+            continue;
+        address = getPageAddress(n) + 4;
+        end = getPageAddress(n) + FLASH_PAGE_SIZE;
+        while (address < end && (length = readWord(address)) != ERASED && length <= HISTORY_BATCH)
+        {
+            replayBatch((const uint8_t *)(address + 4), length, since, callback, &units);
+            address += 4 + ((length + 3) & ~3);
+        }
+    }
+    state = _disable_interrupts();                  // updateHistory() may run in an ISR
+    copyLength = batchLength;
+    for (i = 0; i < copyLength; i++)
+        copy[i] = batch[i];
+    _restore_interrupts(state);
+    replayBatch(copy, copyLength, since, callback, &units);
+}
@@ -0,0 +1,44 @@
+// History Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// Flash 0x38000-0x3FFFF (32 pages) reserved for history in tm4c123gh6pm.cmd
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum _HISTORY_TYPE
+{
+    HISTORY_LEVEL,                                  // value: mL
+    HISTORY_FEED_START,                             // value: event number
+    HISTORY_FEED_STOP,                              // value: event number
+    HISTORY_PUMP_ON                                 // value: seconds
+} HISTORY_TYPE;
+
+// Called for every feeding record and every change of level, oldest first
+typedef void (*HISTORY_CALLBACK)(HISTORY_TYPE type, uint32_t seconds, uint16_t value);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initHistory(void);
+void updateHistory(void);
+void flushHistory(void);
+void replayHistory(uint32_t since, HISTORY_CALLBACK callback);
+
+#endif
@@ -0,0 +1,142 @@
+// Macro Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// EEPROM blocks 16-31, blocks 0-12 hold the feeder settings
+
+// Named command lines kept in the EEPROM, 4 blocks (64 words) a slot:
+//   word 0      body length, 0xFFFFFFFF when the slot is free
+//   words 1-2   name, padded with 0
+//   words 3-63  body, 4 characters a word
+// The length is written last, so a slot interrupted while it is written
+// reads as free. Words that already hold the data are not written again.
+// The caller masks the ISRs that use the EEPROM.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "eeprom.h"
+#include "macro.h"
+
+#define MACRO_BLOCK 16
+#define MACRO_WORDS 64
+#define MACRO_FREE  0xFFFFFFFF
+
+#define MACRO_ADDRESS(slot, word) ((MACRO_BLOCK * 16) + (slot) * MACRO_WORDS + (word))
+#define MACRO_NAME_WORD 1
+#define MACRO_BODY_WORD 3
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+static void updateEeprom(uint16_t add, uint32_t data)
+{
+    if (readEeprom(add) != data)
+        writeEeprom(add, data);
+}
+
+// Unpacks length characters from the words at add into str
+static void readString(uint16_t add, char str[], uint16_t length)
+{
+    uint32_t word = 0;
+    uint16_t i;
+    for (i = 0; i < length; i++)
+    {
+        if ((i & 3) == 0)
+            word = readEeprom(add + i / 4);
+        str[i] = word >> ((i & 3) * 8);
+    }
+    str[length] = 0;
+}
+
+// Packs length characters of str, padded with 0 to size characters, from add on
+static void writeString(uint16_t add, const char str[], uint16_t length, uint16_t size)
+{
+    uint32_t word = 0;
+    uint16_t i;
+    for (i = 0; i < ((size + 3) & ~3); i++)
+    {
+        if (i < length)
+            word |= (uint32_t)(uint8_t)str[i] << ((i & 3) * 8);
+        if ((i & 3) == 3)
+        {
+            updateEeprom(add + i / 4, word);
+            word = 0;
+        }
+    }
+}
+
+static uint16_t getLength(const char str[])
+{
+    uint16_t length = 0;
+    while (str[length] != 0)
+        length++;
+    return length;
+}
+
+// Returns the slot holding name, or -1
+int8_t findMacro(const char name[])
+{
+    char stored[MACRO_NAME_SIZE + 1];
+    uint8_t slot, i;
+    for (slot = 0; slot < MACRO_COUNT; slot++)
+    {
+        if (readEeprom(MACRO_ADDRESS(slot, 0)) == MACRO_FREE)
+            continue;
+        readString(MACRO_ADDRESS(slot, MACRO_NAME_WORD), stored, MACRO_NAME_SIZE);
+        for (i = 0; i < MACRO_NAME_SIZE && name[i] == stored[i] && name[i] != 0; i++);
+        if (i == MACRO_NAME_SIZE ? name[i] == 0 : name[i] == stored[i])
+            return slot;
+    }
+    return -1;
+}
+
+// Copies the macro in slot, name holds MACRO_NAME_SIZE+1 and body MACRO_BODY_SIZE+1
+// Returns false when the slot is free
+bool readMacro(uint8_t slot, char name[], char body[])
+{
+    uint32_t length = readEeprom(MACRO_ADDRESS(slot, 0));
+    if (length > MACRO_BODY_SIZE)
+        return false;
+    readString(MACRO_ADDRESS(slot, MACRO_NAME_WORD), name, MACRO_NAME_SIZE);
+    readString(MACRO_ADDRESS(slot, MACRO_BODY_WORD), body, length);
+    return true;
+}
+
+// Stores body under name, replacing a macro with the same name
+// Returns false when name or body are too long or every slot is taken
+bool writeMacro(const char name[], const char body[])
+{
+    uint16_t nameLength = getLength(name);
+    uint16_t length = getLength(body);
+    int8_t slot = findMacro(name);
+
+    if (nameLength == 0 || nameLength > MACRO_NAME_SIZE || length > MACRO_BODY_SIZE)
+        return false;
+    if (slot < 0)
+        for (slot = 0; slot < MACRO_COUNT && readEeprom(MACRO_ADDRESS(slot, 0)) != MACRO_FREE; slot++);
+    if (slot == MACRO_COUNT)
+        return false;
+
+    deleteMacro(slot);
+    writeString(MACRO_ADDRESS(slot, MACRO_NAME_WORD), name, nameLength, MACRO_NAME_SIZE);
+    writeString(MACRO_ADDRESS(slot, MACRO_BODY_WORD), body, length, length);
+    writeEeprom(MACRO_ADDRESS(slot, 0), length);
+    return true;
+}
+
+void deleteMacro(uint8_t slot)
+{
+    updateEeprom(MACRO_ADDRESS(slot, 0), MACRO_FREE);
+}
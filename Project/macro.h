@@ -0,0 +1,37 @@
+// Macro Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// EEPROM blocks 16-31, blocks 0-12 hold the feeder settings
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef MACRO_H_
+#define MACRO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MACRO_COUNT 4
+#define MACRO_NAME_SIZE 8                           // characters
+#define MACRO_BODY_SIZE 244                         // characters, the ;-separated commands
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int8_t findMacro(const char name[]);
+bool readMacro(uint8_t slot, char name[], char body[]);
+bool writeMacro(const char name[], const char body[]);
+void deleteMacro(uint8_t slot);
+
+#endif
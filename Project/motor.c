@@ -0,0 +1,166 @@
+// PWM Motor Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// PWM0 generator 3, 39 kHz
+//   Water on PC4 (M0PWM6, compare A)
+//   Food  on PC5 (M0PWM7, compare B)
+
+// Speeds are PWM duty cycles in parts per 10000
+// Ramps advance one step per PWM period from the generator 3 load interrupt,
+// which is only enabled while a ramp is running. Compare values written there
+// take effect at the next period, so the outputs never glitch.
+// setMotorSpeed() must be called at the priority of the PWM Generator 3 vector
+// (or with it masked), since it shares the ramp state with pwm0Gen3Isr
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "motor.h"
+#include "gpio.h"
+#include "nvic.h"
+#include "pwm.h"
+
+#define MOTOR_COUNT 2
+#define PWM_FREQUENCY 39000
+#define PWM_RESOLUTION 1000                         // at least 0.1% duty steps
+
+typedef struct _MOTOR_RAMP
+{
+    uint16_t start;
+    uint16_t target;
+    uint16_t speed;
+    RAMP_PROFILE profile;
+    uint32_t step;
+    uint32_t steps;
+    uint32_t progress;                              // Q31, 1 << 31 at the end of the ramp
+    uint32_t increment;
+} MOTOR_RAMP;
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static MOTOR_RAMP ramps[MOTOR_COUNT];
+static uint32_t periodsPerMs = PWM_FREQUENCY / 1000;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Output A drives the water motor, output B the food motor
+static void writeSpeed(MOTOR motor, uint16_t speed)
+{
+    setPwmDuty(PWM0_GEN3, (PWM_OUTPUT)motor, speed);
+    syncPwm(PWM0_GEN3);
+}
+
+// Speed at the current step of a ramp
+static uint16_t getRampSpeed(MOTOR_RAMP *r)
+{
+    int32_t delta = (int32_t)r->target - r->start;
+    uint32_t x = r->progress >> 16;                 // Q15
+    if (r->step == r->steps)
+        return r->target;
+    if (r->profile == RAMP_S_CURVE)
+        x = ((x * x) >> 15) * (3 * 32768 - 2 * x) >> 15;
+                                                    // smoothstep 3x^2 - 2x^3
+    return r->start + ((delta * (int32_t)x) >> 15);
+}
+
+// Initialize PWM0 generator 3 with both outputs off
+void initMotors(void)
+{
+    periodsPerMs = initPwmGenerator(PWM0_GEN3, PWM_FREQUENCY, PWM_RESOLUTION, 40000000) / 1000;
+    PWM0_3_INTEN_R = 0;                                                 // load interrupt armed while ramping
+    PWM0_INTEN_R |= PWM_INTEN_INTPWM3;
+    enableNvicInterrupt(INT_PWM0_3);
+}
+
+// Routes a motor output to its pin
+void enableMotor(MOTOR motor)
+{
+    enablePort(PORTC);
+    if (motor == MOTOR_WATER)
+    {
+        selectPinPushPullOutput(PORTC, 4);
+        setPinAuxFunction(PORTC, 4, GPIO_PCTL_PC4_M0PWM6);
+    }
+    else
+    {
+        selectPinPushPullOutput(PORTC, 5);
+        setPinAuxFunction(PORTC, 5, GPIO_PCTL_PC5_M0PWM7);
+    }
+    enablePwmOutput(PWM0_GEN3, (PWM_OUTPUT)motor);
+}
+
+// Moves a motor from its current speed to speed (parts per 10000) over rampMs
+void setMotorSpeed(MOTOR motor, uint16_t speed, RAMP_PROFILE profile, uint16_t rampMs)
+{
+    MOTOR_RAMP *r = &ramps[motor];
+    if (speed > MOTOR_FULL_SPEED)
+        speed = MOTOR_FULL_SPEED;
+    r->start = r->speed;
+    r->target = speed;
+    r->profile = profile;
+    r->step = 0;
+    r->steps = (uint32_t)rampMs * periodsPerMs;
+    r->progress = 0;
+    if (r->steps)
+        r->increment = 0x80000000 / r->steps;
+    if (profile == RAMP_STEP || r->steps == 0 || speed == r->speed)
+    {
+        r->steps = 0;
+        r->speed = speed;
+        writeSpeed(motor, speed);
+    }
+    else if (!PWM0_3_INTEN_R)
+    {
+        PWM0_3_ISC_R = PWM_3_ISC_INTCNTLOAD;        // drop a stale flag, first step at the next load
+        PWM0_3_INTEN_R = PWM_3_INTEN_INTCNTLOAD;
+    }
+}
+
+uint16_t getMotorSpeed(MOTOR motor)
+{
+    return ramps[motor].speed;
+}
+
+bool isMotorRamping(MOTOR motor)
+{
+    return ramps[motor].step < ramps[motor].steps;
+}
+
+// Advances both ramps by one PWM period
+void pwm0Gen3Isr(void)
+{
+    bool active = false;
+    uint8_t i;
+    PWM0_3_ISC_R = PWM_3_ISC_INTCNTLOAD;            // clear interrupt flag
+    for (i = 0; i < MOTOR_COUNT; i++)
+    {
+        MOTOR_RAMP *r = &ramps[i];
+        if (r->step < r->steps)
+        {
+            r->step++;
+            r->progress += r->increment;
+            r->speed = getRampSpeed(r);
+            writeSpeed((MOTOR)i, r->speed);
+            if (r->step < r->steps)
+                active = true;
+        }
+    }
+    if (!active)
+        PWM0_3_INTEN_R = 0;
+}
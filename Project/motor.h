@@ -0,0 +1,56 @@
+// PWM Motor Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// PWM0 generator 3, 39 kHz
+//   Water on PC4 (M0PWM6, compare A)
+//   Food  on PC5 (M0PWM7, compare B)
+
+// Vector table entry to add in tm4c123gh6pm_startup_ccs.c:
+//   pwm0Gen3Isr on PWM Generator 3
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef MOTOR_H_
+#define MOTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MOTOR_FULL_SPEED 10000                      // PWM_DUTY_MAX
+
+typedef enum _MOTOR
+{
+    MOTOR_WATER = 0,
+    MOTOR_FOOD = 1
+} MOTOR;
+
+typedef enum _RAMP_PROFILE
+{
+    RAMP_STEP,
+    RAMP_LINEAR,
+    RAMP_S_CURVE
+} RAMP_PROFILE;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initMotors(void);
+void enableMotor(MOTOR motor);
+void setMotorSpeed(MOTOR motor, uint16_t speed, RAMP_PROFILE profile, uint16_t rampMs);
+uint16_t getMotorSpeed(MOTOR motor);
+bool isMotorRamping(MOTOR motor);
+
+void pwm0Gen3Isr(void);
+
+#endif
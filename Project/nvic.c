@@ -0,0 +1,109 @@
+// NVIC Library
+// Jason Losh
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+// nvicRegisterIsr() moves the vector table to the .vtable section, which the
+// linker command file places at the start of SRAM (0x20000000)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include "nvic.h"
+#include "tm4c123gh6pm.h"
+
+#define NVIC_CRITICAL_PRIMASK 0x80000000             // state is the previous PRIMASK
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// VTOR needs the table aligned to its size rounded up to a power of 2 (1 KiB)
+#pragma DATA_SECTION(ramVectors, ".vtable")
+#pragma DATA_ALIGN(ramVectors, 1024)
+static NVIC_ISR ramVectors[NVIC_VECTOR_COUNT];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void enableNvicInterrupt(uint8_t vectorNumber)
+{
+    volatile uint32_t* p = (uint32_t*) &NVIC_EN0_R;
+    vectorNumber -= 16;
+    p += vectorNumber >> 5;
+    *p = 1 << (vectorNumber & 31);
+}
+
+void disableNvicInterrupt(uint8_t vectorNumber)
+{
+    volatile uint32_t* p = (uint32_t*) &NVIC_DIS0_R;
+    vectorNumber -= 16;
+    p += vectorNumber >> 5;
+    *p = 1 << (vectorNumber & 31);
+}
+
+void setNvicInterruptPriority(uint8_t vectorNumber, uint8_t priority)
+{
+    volatile uint32_t* p = (uint32_t*) &NVIC_PRI0_R;
+    vectorNumber -= 16;
+    uint32_t shift = 5 + (vectorNumber & 3) * 8;
+    p += vectorNumber >> 2;
+    *p &= ~(7 << shift);
+    *p |= priority << shift;
+}
+
+
+// Installs isr on a vector at run time, returns false if there is no such vector
+// The first call copies the active table (flash at reset) to SRAM and points VTOR at it
+bool nvicRegisterIsr(uint8_t vectorNumber, NVIC_ISR isr)
+{
+    uint32_t state;
+    if (vectorNumber >= NVIC_VECTOR_COUNT)
+        return false;
+    state = _disable_interrupts();
+    if (NVIC_VTABLE_R != (uint32_t)ramVectors)
+    {
+        const NVIC_ISR *vectors = (const NVIC_ISR *)NVIC_VTABLE_R;
+        uint8_t i;
+        for (i = 0; i < NVIC_VECTOR_COUNT; i++)
+            ramVectors[i] = vectors[i];
+        NVIC_VTABLE_R = (uint32_t)ramVectors;
+    }
+    ramVectors[vectorNumber] = isr;
+    _restore_interrupts(state);
+    return true;
+}
+
+// Masks interrupts whose priority value is priority (0-7) or more, so numerically
+// lower priorities still preempt. BASEPRI = 0 masks nothing, so priority 0
+// masks every interrupt with PRIMASK instead.
+// Returns the previous mask for leaveNvicCritical(), nested sections never weaken the mask
+uint32_t enterNvicCritical(uint8_t priority)
+{
+    uint32_t basepri = (priority & 7) << 5;
+    uint32_t state;
+    if (basepri == 0)
+        return NVIC_CRITICAL_PRIMASK | _disable_interrupts();
+    state = _set_interrupt_priority(basepri);
+    if (state != 0 && state < basepri)
+        _set_interrupt_priority(state);
+    return state;
+}
+
+void leaveNvicCritical(uint32_t state)
+{
+    if (state & NVIC_CRITICAL_PRIMASK)
+        _restore_interrupts(state & ~NVIC_CRITICAL_PRIMASK);
+    else
+        _set_interrupt_priority(state);
+}
@@ -0,0 +1,40 @@
+// NVIC Library
+// Jason Losh
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef NVIC_H_
+#define NVIC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of entries in the vector table (stack pointer, 15 exceptions, 139 interrupts)
+#define NVIC_VECTOR_COUNT 155
+
+typedef void (*NVIC_ISR)(void);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void enableNvicInterrupt(uint8_t vectorNumber);
+void disableNvicInterrupt(uint8_t vectorNumber);
+void setNvicInterruptPriority(uint8_t vectorNumber, uint8_t priority);
+bool nvicRegisterIsr(uint8_t vectorNumber, NVIC_ISR isr);
+uint32_t enterNvicCritical(uint8_t priority);
+void leaveNvicCritical(uint32_t state);
+
+#endif
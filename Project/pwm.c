@@ -0,0 +1,190 @@
+// PWM Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// PWM0 and PWM1 generators 0-3, outputs A (MnPWM 2n) and B (MnPWM 2n+1)
+// Pins are routed by the caller with setPinAuxFunction()
+
+// Generators count down. Load, compare, generator actions and dead-band are
+// globally synchronized, so staged values only take effect together at the
+// counter zero that follows syncPwm(), and a period is never cut short.
+// The PWM clock divider (SYSCTL_RCC) is shared by every generator. The first
+// initPwmGenerator() call picks it, later calls only pick a load value, so
+// configure the lowest frequency generator first.
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "pwm.h"
+
+// Generator register offsets from the generator base address
+#define PWM_GEN_CTL     0x00
+#define PWM_GEN_LOAD    0x10
+#define PWM_GEN_CMPA    0x18
+#define PWM_GEN_CMPB    0x1C
+#define PWM_GEN_GENA    0x20
+#define PWM_GEN_GENB    0x24
+#define PWM_GEN_DBCTL   0x28
+#define PWM_GEN_DBRISE  0x2C
+#define PWM_GEN_DBFALL  0x30
+
+// Module register offsets from the module base address
+#define PWM_CTL         0x000
+#define PWM_ENABLE      0x008
+
+#define PWM_REG(gen, ofs) (*((volatile uint32_t *)((uint32_t)(gen) + (ofs))))
+#define PWM_MODULE_REG(gen, ofs) (*((volatile uint32_t *)(((uint32_t)(gen) & ~0xFFF) + (ofs))))
+
+#define GEN_CTL_SYNC (PWM_0_CTL_LOADUPD | PWM_0_CTL_CMPAUPD | PWM_0_CTL_CMPBUPD | PWM_0_CTL_GENAUPD_GS \
+                      | PWM_0_CTL_GENBUPD_GS | PWM_0_CTL_DBCTLUPD_GS | PWM_0_CTL_DBRISEUPD_GS | PWM_0_CTL_DBFALLUPD_GS)
+
+// Output high from the compare match down to zero, low from load
+#define GEN_A_PWM (PWM_0_GENA_ACTCMPAD_ONE | PWM_0_GENA_ACTLOAD_ZERO)
+#define GEN_B_PWM (PWM_0_GENB_ACTCMPBD_ONE | PWM_0_GENB_ACTLOAD_ZERO)
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+static bool dividerSet = false;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Module number 0-1
+static uint8_t getPwmModule(PWM_GEN gen)
+{
+    return ((uint32_t)gen >> 12) & 1;
+}
+
+// Generator number 0-3
+static uint8_t getPwmGenerator(PWM_GEN gen)
+{
+    return (((uint32_t)gen & 0xFFF) - 0x40) >> 6;
+}
+
+// PWM clock divider selected in SYSCTL_RCC
+static uint32_t getPwmDivider(void)
+{
+    if (!(SYSCTL_RCC_R & SYSCTL_RCC_USEPWMDIV))
+        return 1;
+    return 2 << ((SYSCTL_RCC_R & SYSCTL_RCC_PWMDIV_M) >> 17);
+}
+
+// Sets up a generator with both outputs low
+// Picks the smallest PWM clock divider that fits the period in 16 bits, so
+// that a period has as many steps as possible, but at least resolution
+// Returns the actual frequency, or 0 if resolution cannot be met
+uint32_t initPwmGenerator(PWM_GEN gen, uint32_t frequency, uint32_t resolution, uint32_t fcyc)
+{
+    uint32_t divider, load;
+    uint8_t log2;
+
+    SYSCTL_RCGCPWM_R |= 1 << getPwmModule(gen);
+    _delay_cycles(3);
+
+    if (dividerSet)
+    {
+        divider = getPwmDivider();
+        load = fcyc / (divider * frequency);
+    }
+    else
+    {
+        for (log2 = 0; log2 <= 6; log2++)
+        {
+            divider = 1 << log2;
+            load = fcyc / (divider * frequency);
+            if (load <= 65536)
+                break;
+        }
+    }
+    if (load < resolution || load > 65536)          // checked first, a failed call leaves the divider free
+        return 0;
+    if (!dividerSet)
+    {
+        if (log2 == 0)
+            SYSCTL_RCC_R &= ~SYSCTL_RCC_USEPWMDIV;
+        else
+            SYSCTL_RCC_R = (SYSCTL_RCC_R & ~SYSCTL_RCC_PWMDIV_M) | SYSCTL_RCC_USEPWMDIV | ((log2 - 1) << 17);
+        dividerSet = true;
+    }
+
+    PWM_REG(gen, PWM_GEN_CTL) = 0;                  // turn-off generator, registers load immediately
+    PWM_REG(gen, PWM_GEN_LOAD) = load - 1;          // period of load clocks
+    PWM_REG(gen, PWM_GEN_CMPA) = 0;
+    PWM_REG(gen, PWM_GEN_CMPB) = 0;
+    PWM_REG(gen, PWM_GEN_GENA) = PWM_0_GENA_ACTLOAD_ZERO;
+    PWM_REG(gen, PWM_GEN_GENB) = PWM_0_GENB_ACTLOAD_ZERO;
+    PWM_REG(gen, PWM_GEN_DBCTL) = 0;
+    PWM_REG(gen, PWM_GEN_CTL) = GEN_CTL_SYNC | PWM_0_CTL_ENABLE;
+    return fcyc / (divider * load);
+}
+
+// Stages a duty cycle, 0-PWM_DUTY_MAX parts per 10000, applied by syncPwm()
+// 0 and PWM_DUTY_MAX hold the output low or high for the whole period
+void setPwmDuty(PWM_GEN gen, PWM_OUTPUT output, uint16_t duty)
+{
+    uint32_t period = PWM_REG(gen, PWM_GEN_LOAD) + 1;
+    uint32_t high = (period * duty) / PWM_DUTY_MAX; // clocks high per period
+    uint32_t action;
+    if (high == 0)
+        action = PWM_0_GENA_ACTLOAD_ZERO;
+    else if (high >= period)
+        action = PWM_0_GENA_ACTLOAD_ONE;
+    else
+        action = GEN_A_PWM;
+    if (output == PWM_A)
+    {
+        if (high && high < period)
+            PWM_REG(gen, PWM_GEN_CMPA) = high - 1;
+        PWM_REG(gen, PWM_GEN_GENA) = action;
+    }
+    else
+    {
+        if (high && high < period)
+            PWM_REG(gen, PWM_GEN_CMPB) = high - 1;
+        PWM_REG(gen, PWM_GEN_GENB) = action == GEN_A_PWM ? GEN_B_PWM : action;
+    }
+}
+
+// Stages complementary outputs with dead-band delays in PWM clocks, 0 turns it off
+// Output B becomes the inverse of output A
+void setPwmDeadBand(PWM_GEN gen, uint16_t rise, uint16_t fall)
+{
+    if (rise == 0 && fall == 0)
+        PWM_REG(gen, PWM_GEN_DBCTL) = 0;
+    else
+    {
+        PWM_REG(gen, PWM_GEN_DBRISE) = rise;
+        PWM_REG(gen, PWM_GEN_DBFALL) = fall;
+        PWM_REG(gen, PWM_GEN_DBCTL) = PWM_0_DBCTL_ENABLE;
+    }
+}
+
+// Applies the staged values of a generator at its next counter zero
+void syncPwm(PWM_GEN gen)
+{
+    PWM_MODULE_REG(gen, PWM_CTL) |= PWM_CTL_GLOBALSYNC0 << getPwmGenerator(gen);
+}
+
+void enablePwmOutput(PWM_GEN gen, PWM_OUTPUT output)
+{
+    PWM_MODULE_REG(gen, PWM_ENABLE) |= 1 << (getPwmGenerator(gen) * 2 + output);
+}
+
+void disablePwmOutput(PWM_GEN gen, PWM_OUTPUT output)
+{
+    PWM_MODULE_REG(gen, PWM_ENABLE) &= ~(1 << (getPwmGenerator(gen) * 2 + output));
+}
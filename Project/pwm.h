@@ -0,0 +1,57 @@
+// PWM Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// PWM0 and PWM1 generators 0-3, outputs A (MnPWM 2n) and B (MnPWM 2n+1)
+// Pins are routed by the caller with setPinAuxFunction()
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef PWM_H_
+#define PWM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PWM_DUTY_MAX 10000                          // duty in parts per 10000
+
+// Enum values set to the base address of the generator registers
+typedef enum _PWM_GEN
+{
+    PWM0_GEN0 = 0x40028040,
+    PWM0_GEN1 = 0x40028080,
+    PWM0_GEN2 = 0x400280C0,
+    PWM0_GEN3 = 0x40028100,
+    PWM1_GEN0 = 0x40029040,
+    PWM1_GEN1 = 0x40029080,
+    PWM1_GEN2 = 0x400290C0,
+    PWM1_GEN3 = 0x40029100
+} PWM_GEN;
+
+typedef enum _PWM_OUTPUT
+{
+    PWM_A = 0,
+    PWM_B = 1
+} PWM_OUTPUT;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint32_t initPwmGenerator(PWM_GEN gen, uint32_t frequency, uint32_t resolution, uint32_t fcyc);
+void setPwmDuty(PWM_GEN gen, PWM_OUTPUT output, uint16_t duty);
+void setPwmDeadBand(PWM_GEN gen, uint16_t rise, uint16_t fall);
+void syncPwm(PWM_GEN gen);
+void enablePwmOutput(PWM_GEN gen, PWM_OUTPUT output);
+void disablePwmOutput(PWM_GEN gen, PWM_OUTPUT output);
+
+#endif
@@ -0,0 +1,86 @@
+// Telemetry Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// UART0 with the interrupt driven transmit queue (enableUart0TxInterrupt())
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "telemetry.h"
+#include "uart0.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// CRC-16/CCITT-FALSE (poly 0x1021) of a nibble
+static const uint16_t crcTable[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static uint16_t sequence = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint16_t crc16(const uint8_t data[], uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+    uint16_t i;
+    for (i = 0; i < length; i++)
+    {
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ crcTable[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+static void put16(uint8_t *p, uint16_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t value)
+{
+    put16(p, value);
+    put16(p + 2, value >> 16);
+}
+
+// Queues a packet, false if the UART could not keep up and it was dropped
+bool sendTelemetry(uint32_t ticks, uint16_t level, uint16_t motor, uint8_t flags)
+{
+    uint8_t packet[TELEMETRY_PACKET_SIZE];
+    uint32_t seconds, subseconds;
+    do
+    {
+        seconds = HIB_RTCC_R;
+        subseconds = HIB_RTCSS_R & HIB_RTCSS_RTCSSC_M;
+    } while (seconds != HIB_RTCC_R);
+    put16(&packet[0], TELEMETRY_SYNC);
+    put16(&packet[2], sequence++);
+    put32(&packet[4], seconds);
+    put16(&packet[8], subseconds);
+    put16(&packet[10], level);
+    put32(&packet[12], ticks);
+    put16(&packet[16], motor);
+    packet[18] = flags;
+    packet[19] = 0;
+    put16(&packet[20], crc16(packet, 20));
+    return writeUart0Buffer(packet, TELEMETRY_PACKET_SIZE);
+}
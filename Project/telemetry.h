@@ -0,0 +1,51 @@
+// Telemetry Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    40 MHz
+
+// Hardware configuration:
+// UART0 with the interrupt driven transmit queue (enableUart0TxInterrupt())
+
+// Packet, 22 bytes, little endian:
+//   0  sync        0xA55A (bytes 5A A5)
+//   2  sequence    incremented per packet, gaps show dropped packets
+//   4  seconds     RTC seconds
+//   8  subseconds  RTC subseconds (1/32768 s)
+//   10 level       mL
+//   12 ticks       raw comparator capture (system clocks)
+//   16 motor       food motor duty, parts per 10000
+//   18 flags       TELEMETRY_x bits
+//   19 reserved    0
+//   20 crc         CRC-16/CCITT-FALSE of bytes 0-19
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TELEMETRY_SYNC          0xA55A
+#define TELEMETRY_PACKET_SIZE   22
+
+#define TELEMETRY_PUMP          1
+#define TELEMETRY_MOTOR         2
+#define TELEMETRY_RAMPING       4
+#define TELEMETRY_MOTION        8
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint16_t crc16(const uint8_t data[], uint16_t length);
+bool sendTelemetry(uint32_t ticks, uint16_t level, uint16_t motor, uint8_t flags);
+
+#endif
@@ -10,7 +10,10 @@
 
 MEMORY
 {
-    FLASH (RX) : origin = 0x00000000, length = 0x00040000
+    FLASH (RX) : origin = 0x00004000, length = 0x00034000
+    /* 0x00000000-0x00003FFF is the bootloader (Bootloader/boot.h) */
+    /* Flash the Bootloader project first, a reset starts at 0x0   */
+    /* 0x00038000-0x0003FFFF is the history store (history.c)      */
     SRAM (RWX) : origin = 0x20000000, length = 0x00008000
 }
 
@@ -28,7 +31,7 @@ MEMORY
 
 SECTIONS
 {
-    .intvecs:   > 0x00000000
+    .intvecs:   > 0x00004000
     .text   :   > FLASH
     .const  :   > FLASH
     .cinit  :   > FLASH
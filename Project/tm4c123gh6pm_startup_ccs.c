@@ -43,10 +43,14 @@ static void IntDefaultHandler(void);
 extern void _c_int00(void);
 extern void wideTimer1Isr(void);
 extern void comprt0Isr(void);
+extern void levelControlIsr(void);
 extern void hib0Isr(void);
 extern void timer2Isr(void);
 extern void timer3Isr(void);
-extern void timer4Isr(void);
+extern void gpioPortFIsr(void);
+extern void gpioDebounceIsr(void);
+extern void pwm0Gen3Isr(void);
+extern void uart0Isr(void);
 
 //*****************************************************************************
 //
@@ -94,7 +98,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port C
     IntDefaultHandler,                      // GPIO Port D
     IntDefaultHandler,                      // GPIO Port E
-    IntDefaultHandler,                      // UART0 Rx and Tx
+    uart0Isr,                               // UART0 Rx and Tx
     IntDefaultHandler,                      // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     IntDefaultHandler,                      // I2C0 Master and Slave
@@ -115,11 +119,11 @@ void (* const g_pfnVectors[])(void) =
     timer2Isr,                              // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
     comprt0Isr,                             // Analog Comparator 0
-    IntDefaultHandler,                      // Analog Comparator 1
+    levelControlIsr,                        // Analog Comparator 1 (level control, pended by software)
     IntDefaultHandler,                      // Analog Comparator 2
     IntDefaultHandler,                      // System Control (PLL, OSC, BO)
     IntDefaultHandler,                      // FLASH Control
-    IntDefaultHandler,                      // GPIO Port F
+    gpioPortFIsr,                           // GPIO Port F
     IntDefaultHandler,                      // GPIO Port G
     IntDefaultHandler,                      // GPIO Port H
     IntDefaultHandler,                      // UART2 Rx and Tx
@@ -134,7 +138,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     hib0Isr,                                // Hibernate
     IntDefaultHandler,                      // USB0
-    IntDefaultHandler,                      // PWM Generator 3
+    pwm0Gen3Isr,                            // PWM Generator 3
     IntDefaultHandler,                      // uDMA Software Transfer
     IntDefaultHandler,                      // uDMA Error
     IntDefaultHandler,                      // ADC1 Sequence 0
@@ -159,7 +163,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     IntDefaultHandler,                      // I2C2 Master and Slave
     IntDefaultHandler,                      // I2C3 Master and Slave
-    timer4Isr,                              // Timer 4 subtimer A
+    IntDefaultHandler,                      // Timer 4 subtimer A
     IntDefaultHandler,                      // Timer 4 subtimer B
     0,                                      // Reserved
     0,                                      // Reserved
@@ -181,7 +185,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
-    IntDefaultHandler,                      // Timer 5 subtimer A
+    gpioDebounceIsr,                        // Timer 5 subtimer A
     IntDefaultHandler,                      // Timer 5 subtimer B
     IntDefaultHandler,                      // Wide Timer 0 subtimer A
     IntDefaultHandler,                      // Wide Timer 0 subtimer B
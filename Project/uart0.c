@@ -24,19 +24,39 @@
 #include "clock.h"
 #include "uart0.h"
 #include "tm4c123gh6pm.h"
+#include "nvic.h"
 
 // PortA masks
 #define UART_TX_MASK 2
 #define UART_RX_MASK 1
 
+#define TX_BUFFER_SIZE 256                              // power of 2
+
+#define SYSTICK_MASK 0x00FFFFFF
+#define AUTOBAUD_SLACK 16                               // system clocks, a polling loop pass
+
 //-----------------------------------------------------------------------------
 // Global variables
 //-----------------------------------------------------------------------------
 
+// Transmit queue drained by uart0Isr once enableUart0TxInterrupt() is called
+static uint8_t txBuffer[TX_BUFFER_SIZE];
+static volatile uint16_t txWrite = 0;
+static volatile uint16_t txRead = 0;
+static bool txInterrupt = false;
+
+// Rates detectUart0BaudRate() returns, slowest first
+static const uint32_t autobaudRates[] =
+{
+    1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600, 1000000
+};
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
 
+static void fillUart0Fifo(void);
+
 // Initialize UART0
 void initUart0()
 {
@@ -63,23 +83,207 @@ void initUart0()
                                                         // enable TX, RX, and module
 }
 
+// Divisor in 1/64ths, of 16 clocks per bit or of 8 (HSE) when fcyc is too slow
+// for 16, 0 if there is none
+static uint32_t getUart0Divisor(uint32_t baudRate, uint32_t fcyc, bool *hse)
+{
+    uint64_t divisorTimes128;
+    uint32_t divisor;
+    if (baudRate == 0)
+        return 0;
+    *hse = (uint64_t)baudRate * 16 > fcyc;
+    divisorTimes128 = (uint64_t)fcyc * (*hse ? 16 : 8) / baudRate;
+                                                        // r = fcyc / (N x baudRate), N = 16 or 8
+    divisor = (divisorTimes128 + 1) >> 1;               // round to 1/64
+    if (divisor < 64 || divisor > 0xFFFF * 64 + 63)     // 1 <= IBRD <= 65535
+        return 0;
+    return divisor;
+}
+
+// Error of the rate generated by divisor, in ppm (positive is fast)
+static int32_t getDivisorError(uint32_t baudRate, uint32_t fcyc, uint32_t divisor, bool hse)
+{
+    return (int64_t)fcyc * 64 * 1000000 / ((int64_t)(hse ? 8 : 16) * divisor * baudRate) - 1000000;
+}
+
+static bool isUart0QueueEmpty(void)
+{
+    uint32_t primask = _disable_interrupts();
+    bool empty;
+    fillUart0Fifo();
+    empty = txRead == txWrite;
+    _restore_interrupts(primask);
+    return empty;
+}
+
+// Baud rate error in ppm, INT32_MAX if fcyc cannot generate the rate
+int32_t getUart0BaudError(uint32_t baudRate, uint32_t fcyc)
+{
+    bool hse;
+    uint32_t divisor = getUart0Divisor(baudRate, fcyc, &hse);
+    return divisor ? getDivisorError(baudRate, fcyc, divisor, hse) : INT32_MAX;
+}
+
 // Set baud rate as function of instruction cycle frequency
-void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc)
+// Returns false, leaving the rate as it is, if the error exceeds UART0_MAX_BAUD_ERROR.
+// Queued output is sent at the old rate first.
+bool setUart0BaudRate(uint32_t baudRate, uint32_t fcyc)
 {
-    uint32_t divisorTimes128 = (fcyc * 8) / baudRate;   // calculate divisor (r) in units of 1/128,
-                                                        // where r = fcyc / 16 * baudRate
-    divisorTimes128 += 1;                               // add 1/128 to allow rounding
+    bool hse;
+    uint32_t divisor = getUart0Divisor(baudRate, fcyc, &hse);
+    int32_t error;
+    if (divisor == 0)
+        return false;
+    error = getDivisorError(baudRate, fcyc, divisor, hse);
+    if (error > UART0_MAX_BAUD_ERROR || error < -UART0_MAX_BAUD_ERROR)
+        return false;
+
+    while (txInterrupt && !isUart0QueueEmpty());        // wait for uart0Isr to empty the queue
+    while (UART0_FR_R & UART_FR_BUSY);                  // and the fifo and shift register
     UART0_CTL_R = 0;                                    // turn-off UART0 to allow safe programming
-    UART0_IBRD_R = divisorTimes128 >> 7;                // set integer value to floor(r)
-    UART0_FBRD_R = ((divisorTimes128) >> 1) & 63;       // set fractional value to round(fract(r)*64)
+    UART0_IBRD_R = divisor >> 6;                        // set integer value to floor(r)
+    UART0_FBRD_R = divisor & 63;                        // set fractional value to round(fract(r)*64)
     UART0_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;    // configure for 8N1 w/ 16-level FIFO
-    UART0_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN;
+    UART0_CTL_R = UART_CTL_TXE | UART_CTL_RXE | UART_CTL_UARTEN | (hse ? UART_CTL_HSE : 0);
                                                         // turn-on UART0
+    return true;
+}
+
+// Time in system clocks since start, SysTick counts down
+static uint32_t getTicksSince(uint32_t start)
+{
+    return (start - NVIC_ST_CURRENT_R) & SYSTICK_MASK;
+}
+
+static bool isNear(uint32_t ticks, uint32_t expected, uint32_t tolerance)
+{
+    return ticks + tolerance >= expected && ticks <= expected + tolerance;
+}
+
+// Rate of the 'U' whose start bit has just begun, 0 if the bits are not those
+// of a 'U'. Called with interrupts disabled.
+static uint32_t measureSync(uint32_t fcyc)
+{
+    uint32_t start = NVIC_ST_CURRENT_R;
+    uint32_t limit = fcyc / autobaudRates[0] * 10;      // a character at the slowest rate
+    uint32_t rise[5], bit, rate, i;
+
+    // 0x55 sent LSB first toggles the line every bit, it rises at 1, 3, 5, 7 and
+    // 9 (the stop bit) bit times after the start bit falls
+    for (i = 0; i < 5; i++)
+    {
+        while (!(GPIO_PORTA_DATA_R & UART_RX_MASK))
+            if (getTicksSince(start) > limit)
+                return 0;
+        rise[i] = getTicksSince(start);
+        while (i < 4 && (GPIO_PORTA_DATA_R & UART_RX_MASK))
+            if (getTicksSince(start) > limit)
+                return 0;
+    }
+    bit = rise[4] / 9;
+    if (bit < 4)
+        return 0;
+    for (i = 0; i < 4; i++)
+        if (!isNear(rise[i], (2 * i + 1) * bit, bit / 4 + AUTOBAUD_SLACK))
+            return 0;
+
+    // Closest standard rate, the polling loop limits the accuracy at high rates
+    rate = (uint64_t)fcyc * 9 / rise[4];
+    for (i = 0; i < sizeof(autobaudRates) / sizeof(autobaudRates[0]); i++)
+        if (rate * 25 >= autobaudRates[i] * 24 && rate * 25 <= autobaudRates[i] * 26)
+            return autobaudRates[i];
+    return 0;
+}
+
+// Waits about timeoutMs for the host to send a 'U' (0x55) and returns its
+// standard baud rate, or 0. U0RX is read as a GPIO input and timed with
+// SysTick meanwhile, the rate is not set.
+uint32_t detectUart0BaudRate(uint32_t fcyc, uint32_t timeoutMs)
+{
+    uint64_t waited = 0, timeout = (uint64_t)fcyc / 1000 * timeoutMs;
+    uint32_t rate = 0, last, now, primask;
+    bool idle = false;
+
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = SYSTICK_MASK;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_ENABLE;
+    GPIO_PORTA_AFSEL_R &= ~UART_RX_MASK;                // read PA0 as a GPIO
+    last = NVIC_ST_CURRENT_R;
+
+    while (rate == 0 && waited < timeout)
+    {
+        // A start bit only counts after the line was idle, and it is timed with
+        // interrupts masked, one that delays its edge fails the bit checks
+        primask = _disable_interrupts();
+        if (GPIO_PORTA_DATA_R & UART_RX_MASK)
+            idle = true;
+        else if (idle)
+        {
+            rate = measureSync(fcyc);
+            idle = false;
+        }
+        _restore_interrupts(primask);
+        now = NVIC_ST_CURRENT_R;
+        waited += (last - now) & SYSTICK_MASK;
+        last = now;
+    }
+
+    GPIO_PORTA_AFSEL_R |= UART_RX_MASK;
+    NVIC_ST_CTRL_R = 0;
+    return rate;
+}
+
+// Moves queued bytes into the tx fifo, called with interrupts disabled or from uart0Isr
+static void fillUart0Fifo(void)
+{
+    while (txRead != txWrite && !(UART0_FR_R & UART_FR_TXFF))
+    {
+        UART0_DR_R = txBuffer[txRead];
+        txRead = (txRead + 1) & (TX_BUFFER_SIZE - 1);
+    }
+}
+
+// Sends through the transmit queue from now on, so ISRs can write without waiting
+// uart0Isr must be on the UART0 vector
+void enableUart0TxInterrupt()
+{
+    UART0_IFLS_R = (UART0_IFLS_R & ~UART_IFLS_TX_M) | UART_IFLS_TX2_8;
+                                                        // interrupt when the fifo drains to 4 bytes
+    UART0_IM_R |= UART_IM_TXIM;
+    txInterrupt = true;
+    enableNvicInterrupt(INT_UART0);
+}
+
+// Queues a block that is sent without other bytes in between
+// Returns false, without queueing any of it, if the queue does not have room
+bool writeUart0Buffer(const uint8_t data[], uint16_t length)
+{
+    uint32_t primask = _disable_interrupts();
+    uint16_t i;
+    fillUart0Fifo();                                    // a blocked caller still drains it with uart0Isr masked
+    if (((txRead - txWrite - 1) & (TX_BUFFER_SIZE - 1)) < length)
+    {
+        _restore_interrupts(primask);
+        return false;
+    }
+    for (i = 0; i < length; i++)
+    {
+        txBuffer[txWrite] = data[i];
+        txWrite = (txWrite + 1) & (TX_BUFFER_SIZE - 1);
+    }
+    fillUart0Fifo();
+    _restore_interrupts(primask);
+    return true;
 }
 
 // Blocking function that writes a serial character when the UART buffer is not full
 void putcUart0(char c)
 {
+    if (txInterrupt)
+    {
+        while (!writeUart0Buffer((const uint8_t *)&c, 1));
+        return;
+    }
     while (UART0_FR_R & UART_FR_TXFF);               // wait if uart0 tx fifo full
     UART0_DR_R = c;                                  // write character to fifo
 }
@@ -87,9 +291,15 @@ void putcUart0(char c)
 // Blocking function that writes a string when the UART buffer is not full
 void putsUart0(char* str)
 {
-    uint8_t i = 0;
-    while (str[i] != '\0')
-        putcUart0(str[i++]);
+    while (*str != '\0')
+        putcUart0(*str++);
+}
+
+// UART0 vector, refills the tx fifo from the queue
+void uart0Isr()
+{
+    UART0_ICR_R = UART_ICR_TXIC;
+    fillUart0Fifo();
 }
 
 // Blocking function that returns with serial data once the buffer is not empty
@@ -119,8 +329,9 @@ bool strgcmp(char *str1, const char str2[]) {
     return 1;
 }
 
-void getsUart0(USER_DATA *data) {
-    int count = 0;
+// Reads a line of up to maxChars characters, str holds maxChars+1
+void getsUart0Line(char str[], uint16_t maxChars) {
+    uint16_t count = 0;
 
     while(1) {
 
@@ -129,20 +340,51 @@ void getsUart0(USER_DATA *data) {
         if( (c == 8 || c == 127 ) && (count > 0) ) {    // if backspace decrement count
             count--;
         } else if ( c == 13 ) {                         // if new line (Enter key) is entered, return
-            data->buffer[count] = 0;
+            str[count] = 0;
             return;
         } else if( c >= 32) {                           // Any printable characters, keep in buffer
-            data->buffer[count] = c;
+            str[count] = c;
             count++;
 
-            if(count>=MAX_CHARS) {
-                data->buffer[count] = 0;
+            if(count>=maxChars) {
+                str[count] = 0;
                 return;
             }
         }
     }
 }
 
+void getsUart0(USER_DATA *data) {
+    getsUart0Line(data->buffer, MAX_CHARS);
+}
+
+// Copies the command at *line, up to the next ';' and without leading spaces,
+// into data and moves *line past it. Returns false when the command is longer
+// than MAX_CHARS, *line is still moved past it.
+bool getCommand(char **line, USER_DATA *data) {
+    char *c = *line;
+    uint16_t count = 0;
+
+    while(*c == ' ') {
+        c++;
+    }
+    while(*c != 0 && *c != ';') {
+        if(count < MAX_CHARS) {
+            data->buffer[count] = *c;
+        }
+        count++;
+        c++;
+    }
+    if(*c == ';') {
+        c++;
+    }
+    *line = c;
+
+    data->buffer[count < MAX_CHARS ? count : MAX_CHARS] = 0;
+    data->fieldCount = 0;
+    return count <= MAX_CHARS;
+}
+
 
 void parseFields(USER_DATA *data) {
     // Numeric 48-57
@@ -206,25 +448,25 @@ char* getFieldString(USER_DATA* data, uint8_t fieldNumber) {
     }
 }
 
+// Returns the value of a numeric field, saturated to INT32_MAX, or 0 if it is not one
 int32_t getFieldInteger(USER_DATA* data, uint8_t fieldNumber) {
 
     int32_t num = 0;
 
     if(fieldNumber < data->fieldCount) {
         if((data->fieldType[fieldNumber]) == 'n') {
-            int temp = 0;
-            int i = 0 ;
+            int32_t digit;
             char *c = &data->buffer[data->fieldPosition[fieldNumber]];
 
-            while (c[i] != 0) {
-                temp = c[i] - 48;
+            while (*c >= 48 && *c <= 57) {                      // a letter can follow without a delimiter ("12ab")
+                digit = *c - 48;
 
-                if(i) {
-                    num = num*10;
+                if(num > (INT32_MAX - digit) / 10) {
+                    return INT32_MAX;
                 }
 
-                num += temp;
-                i++;
+                num = num*10 + digit;
+                c++;
             }
             return num;
         }
@@ -28,6 +28,8 @@
 #define MAX_CHARS 80
 #define MAX_FIELDS 6
 
+#define UART0_MAX_BAUD_ERROR 20000                      // ppm, setUart0BaudRate() rejects rates further off
+
 typedef struct _USER_DATA {
     char buffer[MAX_CHARS+1];
     uint8_t fieldCount;
@@ -36,13 +38,20 @@ typedef struct _USER_DATA {
 } USER_DATA;
 
 void initUart0();
-void setUart0BaudRate(uint32_t baudRate, uint32_t fcyc);
+bool setUart0BaudRate(uint32_t baudRate, uint32_t fcyc);
+int32_t getUart0BaudError(uint32_t baudRate, uint32_t fcyc);
+uint32_t detectUart0BaudRate(uint32_t fcyc, uint32_t timeoutMs);
+void enableUart0TxInterrupt();
+bool writeUart0Buffer(const uint8_t data[], uint16_t length);
 void putcUart0(char c);
 void putsUart0(char* str);
 char getcUart0();
 bool kbhitUart0();
+void uart0Isr();
 
+void getsUart0Line(char str[], uint16_t maxChars);
 void getsUart0(USER_DATA *data);
+bool getCommand(char **line, USER_DATA *data);
 void parseFields(USER_DATA *data);
 char* getFieldString(USER_DATA* data, uint8_t fieldNumber);
 int32_t getFieldInteger(USER_DATA* data, uint8_t fieldNumber);